@@ -0,0 +1,221 @@
+/*!
+\file
+Contains the runtime dispatch layer. The batch functions in the mutil::dispatch
+namespace have the same behavior as those with the same names in mutil, but
+select the widest instruction set supported by the running CPU rather than the
+one the program was compiled for.
+
+Requires linking against the MatrixUtilDispatch library.
+*/
+
+#pragma once
+
+#include "../mutil.h"
+#include "dispatch_table.h"
+
+namespace mutil
+{
+	/*!
+	CPU features detected by cpuFeatures().
+	*/
+	enum CPUFeature : uint32_t
+	{
+		CPUFeature_SSE41 = 1 << 0,
+		CPUFeature_AVX = 1 << 1,
+		CPUFeature_AVX2 = 1 << 2,
+		CPUFeature_FMA = 1 << 3,
+		CPUFeature_AVX512F = 1 << 4,
+		CPUFeature_NEON = 1 << 5
+	};
+
+	/*!
+	Instruction sets the batch kernels are compiled for, from narrowest to widest.
+	*/
+	enum DispatchLevel
+	{
+		/*!
+		Uses whatever the library was compiled with.
+		*/
+		DispatchLevel_Baseline,
+
+		/*!
+		Requires SSE4.1.
+		*/
+		DispatchLevel_SSE41,
+
+		/*!
+		Requires AVX2 and FMA.
+		*/
+		DispatchLevel_AVX2,
+
+		/*!
+		Requires AVX-512F, AVX2 and FMA.
+		*/
+		DispatchLevel_AVX512
+	};
+
+	/*!
+	Returns the features supported by the running CPU and operating system. The
+	features are only detected once.
+
+	@return A combination of CPUFeature flags.
+	*/
+	uint32_t cpuFeatures();
+
+	/*!
+	Returns whether a dispatch level can be used on this CPU. A level is never
+	supported if the library was not built with it.
+
+	@param level The level to check.
+
+	@return Whether setDispatchLevel would accept level.
+	*/
+	bool isDispatchLevelSupported(DispatchLevel level);
+
+	/*!
+	Returns the dispatch level in use. Unless setDispatchLevel was called, this
+	is the widest supported level.
+
+	@return The current dispatch level.
+	*/
+	DispatchLevel dispatchLevel();
+
+	/*!
+	Changes the dispatch level. Mainly useful for testing and benchmarking.
+
+	@param level The level to use.
+
+	@return Whether the level was changed. If level is not supported, the
+	current level is kept.
+	*/
+	bool setDispatchLevel(DispatchLevel level);
+
+	namespace __1
+	{
+		const DispatchTable &dispatchTable();
+	}
+
+	namespace dispatch
+	{
+		/*!
+		Dispatched version of mutil::transformPoints.
+		*/
+		inline void transformPoints(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count, bool perspective = false)
+		{
+			__1::dispatchTable().transformPoints(m.mat, (const float *)in, (float *)out, count, perspective);
+		}
+
+		/*!
+		Dispatched version of mutil::transformVectors.
+		*/
+		inline void transformVectors(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count)
+		{
+			__1::dispatchTable().transformVectors(m.mat, (const float *)in, (float *)out, count);
+		}
+
+		/*!
+		Dispatched version of mutil::transformPoints4.
+		*/
+		inline void transformPoints4(const Matrix4 &m, const Vector4 *in, Vector4 *out, size_t count, bool perspective = false)
+		{
+			__1::dispatchTable().transformPoints4(m.mat, (const float *)in, (float *)out, count, perspective);
+		}
+
+		/*!
+		Dispatched version of mutil::multiplyMany.
+		*/
+		inline void multiplyMany(const Matrix4 *a, const Matrix4 *b, Matrix4 *out, size_t count)
+		{
+			__1::dispatchTable().multiplyMany((const float *)a, (const float *)b, (float *)out, count);
+		}
+
+		inline void sin(const float *x, float *out, size_t count) { __1::dispatchTable().sin(x, out, count); }
+		inline void cos(const float *x, float *out, size_t count) { __1::dispatchTable().cos(x, out, count); }
+		inline void tan(const float *x, float *out, size_t count) { __1::dispatchTable().tan(x, out, count); }
+		inline void exp(const float *x, float *out, size_t count) { __1::dispatchTable().exp(x, out, count); }
+		inline void exp2(const float *x, float *out, size_t count) { __1::dispatchTable().exp2(x, out, count); }
+		inline void log(const float *x, float *out, size_t count) { __1::dispatchTable().log(x, out, count); }
+		inline void log2(const float *x, float *out, size_t count) { __1::dispatchTable().log2(x, out, count); }
+		inline void atan(const float *x, float *out, size_t count) { __1::dispatchTable().atan(x, out, count); }
+		inline void atan2(const float *y, const float *x, float *out, size_t count) { __1::dispatchTable().atan2(y, x, out, count); }
+		inline void pow(const float *a, const float *b, float *out, size_t count) { __1::dispatchTable().pow(a, b, out, count); }
+		inline void sincos(const float *x, float *s, float *c, size_t count) { __1::dispatchTable().sincos(x, s, c, count); }
+
+		inline void gather(const Vector3 *src, size_t count, Vector3Stream &dst)
+		{
+			dst.resize(count);
+			__1::dispatchTable().gather3((const float *)src, count, dst.data);
+		}
+
+		inline void gather(const Vector4 *src, size_t count, Vector4Stream &dst)
+		{
+			dst.resize(count);
+			__1::dispatchTable().gather4((const float *)src, count, dst.data);
+		}
+
+		inline void scatter(const Vector3Stream &src, Vector3 *dst)
+		{
+			__1::dispatchTable().scatter3(src.data, src.size(), (float *)dst);
+		}
+
+		inline void scatter(const Vector4Stream &src, Vector4 *dst)
+		{
+			__1::dispatchTable().scatter4(src.data, src.size(), (float *)dst);
+		}
+
+		template <size_t N>
+		inline void dot(const VectorStream<N> &a, const VectorStream<N> &b, float *out)
+		{
+			__1::dispatchTable().dot[N - 3](a.data, b.data, out, a.size());
+		}
+
+		inline void cross(const Vector3Stream &a, const Vector3Stream &b, Vector3Stream &out)
+		{
+			out.resize(a.size());
+			__1::dispatchTable().cross(a.data, b.data, out.data, a.size());
+		}
+
+		template <size_t N>
+		inline void length(const VectorStream<N> &a, float *out)
+		{
+			__1::dispatchTable().length[N - 3](a.data, out, a.size());
+		}
+
+		template <size_t N>
+		inline void normalize(const VectorStream<N> &a, VectorStream<N> &out)
+		{
+			out.resize(a.size());
+			__1::dispatchTable().normalize[N - 3](a.data, out.data, a.size());
+		}
+
+		template <size_t N>
+		inline void lerp(const VectorStream<N> &a, const VectorStream<N> &b, float t, VectorStream<N> &out)
+		{
+			out.resize(a.size());
+			__1::dispatchTable().lerp[N - 3](a.data, b.data, t, out.data, a.size());
+		}
+
+		template <size_t N>
+		inline void clamp(const VectorStream<N> &a, float min, float max, VectorStream<N> &out)
+		{
+			out.resize(a.size());
+			__1::dispatchTable().clamp[N - 3](a.data, min, max, out.data, a.size());
+		}
+
+		template <size_t N>
+		inline void reflect(const VectorStream<N> &a, const VectorStream<N> &normal, VectorStream<N> &out)
+		{
+			out.resize(a.size());
+			__1::dispatchTable().reflect[N - 3](a.data, normal.data, out.data, a.size());
+		}
+
+		/*!
+		Dispatched version of mutil::fillNoise2D.
+		*/
+		inline void fillNoise2D(float *out, size_t width, size_t height, const Vector2 &origin, const Vector2 &step,
+			int octaves = 1, float persistence = 0.5f, NoiseType type = NoiseType_Perlin)
+		{
+			__1::dispatchTable().fillNoise2D(out, width, height, origin.vec, step.vec, octaves, persistence, type);
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/*!
+\file
+Contains the table of batch kernels used by the runtime dispatch library. The
+table only uses raw pointers so that it can be shared between translation units
+which were compiled for different instruction sets.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace mutil
+{
+	namespace __1
+	{
+		typedef void (*DispatchUnary)(const float *x, float *out, size_t count);
+		typedef void (*DispatchBinary)(const float *a, const float *b, float *out, size_t count);
+
+		// Vectors and matrices are passed as their underlying float arrays, and
+		// streams as their component arrays. Entries which take a stream are
+		// indexed by the number of components minus 3.
+		struct DispatchTable
+		{
+			void (*transformPoints)(const float *m, const float *in, float *out, size_t count, bool perspective);
+			void (*transformVectors)(const float *m, const float *in, float *out, size_t count);
+			void (*transformPoints4)(const float *m, const float *in, float *out, size_t count, bool perspective);
+			void (*multiplyMany)(const float *a, const float *b, float *out, size_t count);
+
+			DispatchUnary sin;
+			DispatchUnary cos;
+			DispatchUnary tan;
+			DispatchUnary exp;
+			DispatchUnary exp2;
+			DispatchUnary log;
+			DispatchUnary log2;
+			DispatchUnary atan;
+			DispatchBinary atan2;
+			DispatchBinary pow;
+			void (*sincos)(const float *x, float *s, float *c, size_t count);
+
+			void (*gather3)(const float *src, size_t count, float *const *dst);
+			void (*gather4)(const float *src, size_t count, float *const *dst);
+			void (*scatter3)(const float *const *src, size_t count, float *dst);
+			void (*scatter4)(const float *const *src, size_t count, float *dst);
+
+			void (*dot[2])(const float *const *a, const float *const *b, float *out, size_t count);
+			void (*cross)(const float *const *a, const float *const *b, float *const *out, size_t count);
+			void (*length[2])(const float *const *a, float *out, size_t count);
+			void (*normalize[2])(const float *const *a, float *const *out, size_t count);
+			void (*lerp[2])(const float *const *a, const float *const *b, float t, float *const *out, size_t count);
+			void (*clamp[2])(const float *const *a, float min, float max, float *const *out, size_t count);
+			void (*reflect[2])(const float *const *a, const float *const *normal, float *const *out, size_t count);
+
+			void (*fillNoise2D)(float *out, size_t width, size_t height, const float *origin, const float *step, int octaves, float persistence, int type);
+		};
+
+		extern const DispatchTable kDispatchBaseline;
+		extern const DispatchTable kDispatchSSE41;
+		extern const DispatchTable kDispatchAVX2;
+		extern const DispatchTable kDispatchAVX512;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "mat_types.h"
+
+namespace mutil
+{
+	/*!
+	A 3x4 matrix, the upper three rows of a Matrix4 whose last row is
+	(0, 0, 0, 1). It holds any combination of rotation, scale, shear and
+	translation in 12 floats rather than 16, and products, inverses and point
+	transforms skip the work the constant row would take.
+
+	Like the other matrices it is column major, the last column being the
+	translation.
+	*/
+	class AffineMatrix
+	{
+	public:
+		union
+		{
+			Vector3 columns[4];
+			struct
+			{
+				float _11, _21, _31;
+				float _12, _22, _32;
+				float _13, _23, _33;
+				float _14, _24, _34;
+			};
+			float mat[12];
+		};
+
+		constexpr AffineMatrix();
+		explicit constexpr AffineMatrix(float diagonal);
+		explicit constexpr AffineMatrix(const Vector3 &col1, const Vector3 &col2,
+				const Vector3 &col3, const Vector3 &col4);
+		explicit constexpr AffineMatrix(
+			float _11, float _12, float _13, float _14,
+			float _21, float _22, float _23, float _24,
+			float _31, float _32, float _33, float _34);
+		explicit constexpr AffineMatrix(const Matrix3 &a, const Vector3 &translation = Vector3(0.0f));
+		explicit constexpr AffineMatrix(const Matrix4 &a);
+
+		constexpr const float &operator[](size_t i) const { return mat[i]; }
+		constexpr float &operator[](size_t i) { return mat[i]; }
+
+		inline AffineMatrix &operator*=(const AffineMatrix &a);
+
+		constexpr float determinant() const;
+		inline AffineMatrix inverse() const;
+	};
+
+	constexpr AffineMatrix operator+(const AffineMatrix &a, const AffineMatrix &b);
+	constexpr AffineMatrix operator-(const AffineMatrix &a, const AffineMatrix &b);
+	inline AffineMatrix MUTIL_VECTORCALL operator*(const AffineMatrix &a, const AffineMatrix &b);
+	constexpr Vector4 operator*(const AffineMatrix &a, const Vector4 &b);
+	constexpr AffineMatrix operator*(const AffineMatrix &a, float b);
+	constexpr AffineMatrix operator/(const AffineMatrix &a, float b);
+	constexpr bool operator==(const AffineMatrix &a, const AffineMatrix &b);
+}
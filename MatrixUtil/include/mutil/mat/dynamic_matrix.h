@@ -0,0 +1,593 @@
+/*!
+\file
+Contains DynamicMatrix, a matrix whose size is chosen at runtime, views into
+it, and the cache-blocked matrix product used to multiply them.
+*/
+
+#pragma once
+
+#include "../simd/simd.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace mutil
+{
+	/*!
+	A rectangular window into column-major matrix storage, which it does not
+	own. Element (r, c) is at data()[c * stride() + r], so a view can select
+	any block of a larger matrix.
+
+	T may be const, and a view of T converts to a view of const T.
+	*/
+	template <typename T>
+	class MatrixView
+	{
+	public:
+		constexpr MatrixView() : _data(nullptr), _rows(0), _cols(0), _stride(0) {}
+
+		/*!
+		@param data The first element.
+		@param rows The number of rows.
+		@param cols The number of columns.
+		@param stride The distance between the start of consecutive columns, in
+		elements. At least rows.
+		*/
+		constexpr MatrixView(T *data, size_t rows, size_t cols, size_t stride) :
+			_data(data), _rows(rows), _cols(cols), _stride(stride) {}
+
+		template <typename U>
+		constexpr MatrixView(const MatrixView<U> &a) :
+			_data(a.data()), _rows(a.rows()), _cols(a.cols()), _stride(a.stride()) {}
+
+		constexpr T *data() const { return _data; }
+		constexpr size_t rows() const { return _rows; }
+		constexpr size_t cols() const { return _cols; }
+		constexpr size_t stride() const { return _stride; }
+
+		constexpr T &operator()(size_t r, size_t c) const { return _data[c * _stride + r]; }
+
+		/*!
+		@param r The first row of the block.
+		@param c The first column of the block.
+		@param rows The number of rows in the block.
+		@param cols The number of columns in the block.
+
+		@return A view of the block, which must lie within this view.
+		*/
+		constexpr MatrixView block(size_t r, size_t c, size_t rows, size_t cols) const
+		{
+			return MatrixView(_data + c * _stride + r, rows, cols, _stride);
+		}
+
+	private:
+		T *_data;
+		size_t _rows;
+		size_t _cols;
+		size_t _stride;
+	};
+
+	/*!
+	A column-major matrix of any size, allocated on the heap. Each column
+	starts on a MUTIL_STREAM_ALIGNMENT byte boundary, so the stride between
+	columns is the number of rows rounded up to a whole cache line.
+
+	T is an arithmetic type. Products of float matrices use SIMD kernels,
+	other types are multiplied with the same blocking but one element at a
+	time.
+
+	To place a matrix in other storage, such as an arena, create a MatrixView
+	over the memory instead.
+	*/
+	template <typename T>
+	class DynamicMatrix
+	{
+	public:
+		DynamicMatrix();
+
+		/*!
+		Creates a matrix with every element zero.
+
+		@param rows The number of rows.
+		@param cols The number of columns.
+		*/
+		DynamicMatrix(size_t rows, size_t cols);
+
+		/*!
+		Creates a matrix with diag on the diagonal and zero elsewhere.
+		*/
+		DynamicMatrix(size_t rows, size_t cols, T diag);
+
+		/*!
+		Copies the elements of a view.
+		*/
+		explicit DynamicMatrix(const MatrixView<const T> &a);
+
+		DynamicMatrix(const DynamicMatrix &a);
+		DynamicMatrix(DynamicMatrix &&a);
+		~DynamicMatrix();
+
+		DynamicMatrix &operator=(const DynamicMatrix &a);
+		DynamicMatrix &operator=(DynamicMatrix &&a);
+
+		size_t rows() const { return _rows; }
+		size_t cols() const { return _cols; }
+		size_t stride() const { return _stride; }
+
+		T *data() { return _data; }
+		const T *data() const { return _data; }
+
+		T &operator()(size_t r, size_t c) { return _data[c * _stride + r]; }
+		const T &operator()(size_t r, size_t c) const { return _data[c * _stride + r]; }
+
+		MatrixView<T> view() { return MatrixView<T>(_data, _rows, _cols, _stride); }
+		MatrixView<const T> view() const { return MatrixView<const T>(_data, _rows, _cols, _stride); }
+
+		operator MatrixView<T>() { return view(); }
+		operator MatrixView<const T>() const { return view(); }
+
+		MatrixView<T> block(size_t r, size_t c, size_t rows, size_t cols) { return view().block(r, c, rows, cols); }
+		MatrixView<const T> block(size_t r, size_t c, size_t rows, size_t cols) const { return view().block(r, c, rows, cols); }
+
+		/*!
+		Changes the size of the matrix. The elements are zero afterwards.
+		*/
+		void resize(size_t rows, size_t cols);
+
+		DynamicMatrix &operator+=(const DynamicMatrix &a);
+		DynamicMatrix &operator-=(const DynamicMatrix &a);
+		DynamicMatrix &operator*=(T a);
+
+	private:
+		T *_data;
+		size_t _rows;
+		size_t _cols;
+		size_t _stride;
+	};
+
+	namespace __1
+	{
+		template <typename T>
+		struct NoDeduce { using type = T; };
+
+		// Register blocking of the product. Each call of the micro-kernel
+		// computes a kGemmMR x kGemmNR tile of the result in registers, two
+		// registers tall. kGemmKC rows of B packed kGemmNR wide stay in the L1
+		// cache and a kGemmMC x kGemmKC block of A stays in the L2 cache, while
+		// the kGemmKC x kGemmNC panel of B streams from the L3 cache.
+		constexpr size_t kGemmMR = MUTIL_SIMD_WIDTH > 1 ? 2 * MUTIL_SIMD_WIDTH : 4;
+		constexpr size_t kGemmNR = 6;
+		constexpr size_t kGemmKC = 256;
+		constexpr size_t kGemmMC = 128;
+		constexpr size_t kGemmNC = 512 * kGemmNR;
+
+		// The register type of the micro-kernel for T, and its operations
+		template <typename T>
+		struct GemmLane
+		{
+			using type = T;
+			static constexpr size_t width = 1;
+
+			static MUTIL_FORCEINLINE T load(const T *p) { return *p; }
+			static MUTIL_FORCEINLINE T set1(T a) { return a; }
+			static MUTIL_FORCEINLINE T fmadd(T a, T b, T c) { return a * b + c; }
+			static MUTIL_FORCEINLINE T loadu(const T *p) { return *p; }
+			static MUTIL_FORCEINLINE void storeu(T *p, T a) { *p = a; }
+		};
+
+		template <>
+		struct GemmLane<float>
+		{
+			using type = vfloat;
+			static constexpr size_t width = MUTIL_SIMD_WIDTH;
+
+			static MUTIL_FORCEINLINE vfloat load(const float *p) { return vload(vfloat(), p); }
+			static MUTIL_FORCEINLINE vfloat set1(float a) { return vset1(vfloat(), a); }
+			static MUTIL_FORCEINLINE vfloat fmadd(vfloat a, vfloat b, vfloat c) { return vfmadd(a, b, c); }
+			static MUTIL_FORCEINLINE vfloat loadu(const float *p) { return vloadu(vfloat(), p); }
+			static MUTIL_FORCEINLINE void storeu(float *p, vfloat a) { vstoreu(p, a); }
+		};
+
+		// Copies rows [0, mc) and columns [0, kc) of a into panels of kGemmMR
+		// rows, each stored one column after another. The last panel is padded
+		// with zeros.
+		template <typename T>
+		inline void gemmPackA(const MatrixView<const T> &a, size_t mc, size_t kc, T *out)
+		{
+			for (size_t i = 0; i < mc; i += kGemmMR)
+			{
+				const size_t rows = mc - i < kGemmMR ? mc - i : kGemmMR;
+				for (size_t p = 0; p < kc; p++)
+				{
+					const T *src = &a(i, p);
+					size_t r = 0;
+					for (; r < rows; r++)
+						out[r] = src[r];
+					for (; r < kGemmMR; r++)
+						out[r] = T(0);
+					out += kGemmMR;
+				}
+			}
+		}
+
+		// Copies rows [0, kc) and columns [0, nc) of b into panels of kGemmNR
+		// columns, each stored one row after another. The last panel is padded
+		// with zeros.
+		template <typename T>
+		inline void gemmPackB(const MatrixView<const T> &b, size_t kc, size_t nc, T *out)
+		{
+			for (size_t j = 0; j < nc; j += kGemmNR)
+			{
+				const size_t cols = nc - j < kGemmNR ? nc - j : kGemmNR;
+				for (size_t p = 0; p < kc; p++)
+				{
+					size_t c = 0;
+					for (; c < cols; c++)
+						out[c] = b(p, j + c);
+					for (; c < kGemmNR; c++)
+						out[c] = T(0);
+					out += kGemmNR;
+				}
+			}
+		}
+
+		// c += alpha * a * b for one packed panel of a and b. Only rows x cols
+		// of the tile are written to c.
+		template <typename T>
+		MUTIL_FORCEINLINE void gemmMicroKernel(size_t kc, const T *a, const T *b, T *c, size_t stride,
+			size_t rows, size_t cols, T alpha)
+		{
+			using L = GemmLane<T>;
+			using V = typename L::type;
+			constexpr size_t R = kGemmMR / L::width;
+
+			V acc[kGemmNR][R];
+			for (size_t j = 0; j < kGemmNR; j++)
+				for (size_t r = 0; r < R; r++)
+					acc[j][r] = L::set1(T(0));
+
+			for (size_t p = 0; p < kc; p++)
+			{
+				V va[R];
+				for (size_t r = 0; r < R; r++)
+					va[r] = L::load(a + r * L::width);
+
+				for (size_t j = 0; j < kGemmNR; j++)
+				{
+					const V vb = L::set1(b[j]);
+					for (size_t r = 0; r < R; r++)
+						acc[j][r] = L::fmadd(va[r], vb, acc[j][r]);
+				}
+
+				a += kGemmMR;
+				b += kGemmNR;
+			}
+
+			const V valpha = L::set1(alpha);
+			if (rows == kGemmMR && cols == kGemmNR)
+			{
+				for (size_t j = 0; j < kGemmNR; j++)
+				{
+					for (size_t r = 0; r < R; r++)
+					{
+						T *dst = c + j * stride + r * L::width;
+						L::storeu(dst, L::fmadd(acc[j][r], valpha, L::loadu(dst)));
+					}
+				}
+			}
+			else
+			{
+				// an edge tile, which would write past the end of c
+				T tile[kGemmNR * kGemmMR];
+				for (size_t j = 0; j < kGemmNR; j++)
+					for (size_t r = 0; r < R; r++)
+						L::storeu(tile + j * kGemmMR + r * L::width, acc[j][r]);
+
+				for (size_t j = 0; j < cols; j++)
+					for (size_t r = 0; r < rows; r++)
+						c[j * stride + r] += alpha * tile[j * kGemmMR + r];
+			}
+		}
+
+		// c = alpha * a * b + beta * c, on a single thread.
+		template <typename T>
+		inline void gemmBlocked(const MatrixView<const T> &a, const MatrixView<const T> &b, const MatrixView<T> &c,
+			T alpha, T beta)
+		{
+			const size_t m = c.rows();
+			const size_t n = c.cols();
+			const size_t k = a.cols();
+
+			assert(a.rows() == m && "a must have as many rows as c");
+			assert(b.rows() == k && "b must have as many rows as a has columns");
+			assert(b.cols() == n && "b must have as many columns as c");
+
+			for (size_t j = 0; j < n; j++)
+			{
+				T *col = &c(0, j);
+				if (beta == T(0))
+				{
+					// not scaled, so that NaNs in c are discarded
+					for (size_t i = 0; i < m; i++)
+						col[i] = T(0);
+				}
+				else if (beta != T(1))
+				{
+					for (size_t i = 0; i < m; i++)
+						col[i] *= beta;
+				}
+			}
+
+			if (m == 0 || n == 0 || k == 0)
+				return;
+
+			// the packed blocks, sized for this product
+			const size_t kcMax = k < kGemmKC ? k : kGemmKC;
+			const size_t mcMax = m < kGemmMC ? (m + kGemmMR - 1) / kGemmMR * kGemmMR : kGemmMC;
+			const size_t ncMax = n < kGemmNC ? (n + kGemmNR - 1) / kGemmNR * kGemmNR : kGemmNC;
+			T *packA = (T *)alignedAlloc(mcMax * kcMax * sizeof(T), MUTIL_STREAM_ALIGNMENT);
+			T *packB = (T *)alignedAlloc(ncMax * kcMax * sizeof(T), MUTIL_STREAM_ALIGNMENT);
+
+			for (size_t jc = 0; jc < n; jc += kGemmNC)
+			{
+				const size_t nc = n - jc < kGemmNC ? n - jc : kGemmNC;
+				for (size_t pc = 0; pc < k; pc += kGemmKC)
+				{
+					const size_t kc = k - pc < kGemmKC ? k - pc : kGemmKC;
+					gemmPackB(b.block(pc, jc, kc, nc), kc, nc, packB);
+
+					for (size_t ic = 0; ic < m; ic += kGemmMC)
+					{
+						const size_t mc = m - ic < kGemmMC ? m - ic : kGemmMC;
+						gemmPackA(a.block(ic, pc, mc, kc), mc, kc, packA);
+
+						for (size_t jr = 0; jr < nc; jr += kGemmNR)
+						{
+							const size_t cols = nc - jr < kGemmNR ? nc - jr : kGemmNR;
+							for (size_t ir = 0; ir < mc; ir += kGemmMR)
+							{
+								const size_t rows = mc - ir < kGemmMR ? mc - ir : kGemmMR;
+								gemmMicroKernel(kc, packA + ir * kc, packB + jr * kc,
+									&c(ic + ir, jc + jr), c.stride(), rows, cols, alpha);
+							}
+						}
+					}
+				}
+			}
+
+			alignedFree(packA);
+			alignedFree(packB);
+		}
+	}
+
+	/*!
+	Computes c = alpha * a * b + beta * c. The product is blocked so that the
+	parts of a and b being worked on stay in the caches, and packed so that
+	the innermost kernel reads them contiguously.
+
+	c must not overlap a or b. If beta is zero, c is not read. The sizes of a, b
+	and c are checked with assert.
+
+	@param a An m x k matrix.
+	@param b A k x n matrix.
+	@param c An m x n matrix, receiving the result.
+	@param alpha The scale of the product.
+	@param beta The scale of the original c.
+	*/
+	template <typename T>
+	inline void gemm(typename __1::NoDeduce<MatrixView<const T>>::type a, typename __1::NoDeduce<MatrixView<const T>>::type b,
+		const MatrixView<T> &c, typename __1::NoDeduce<T>::type alpha = T(1), typename __1::NoDeduce<T>::type beta = T(0))
+	{
+		__1::gemmBlocked(a, b, c, alpha, beta);
+	}
+
+	template <typename T>
+	inline void gemm(typename __1::NoDeduce<MatrixView<const T>>::type a, typename __1::NoDeduce<MatrixView<const T>>::type b,
+		DynamicMatrix<T> &c, typename __1::NoDeduce<T>::type alpha = T(1), typename __1::NoDeduce<T>::type beta = T(0))
+	{
+		__1::gemmBlocked(a, b, c.view(), alpha, beta);
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> operator*(const DynamicMatrix<T> &a, const DynamicMatrix<T> &b)
+	{
+		DynamicMatrix<T> result(a.rows(), b.cols());
+		__1::gemmBlocked(a.view(), b.view(), result.view(), T(1), T(0));
+		return result;
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> operator+(const DynamicMatrix<T> &a, const DynamicMatrix<T> &b)
+	{
+		DynamicMatrix<T> result = a;
+		result += b;
+		return result;
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> operator-(const DynamicMatrix<T> &a, const DynamicMatrix<T> &b)
+	{
+		DynamicMatrix<T> result = a;
+		result -= b;
+		return result;
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> operator*(const DynamicMatrix<T> &a, typename __1::NoDeduce<T>::type b)
+	{
+		DynamicMatrix<T> result = a;
+		result *= b;
+		return result;
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> operator*(typename __1::NoDeduce<T>::type a, const DynamicMatrix<T> &b)
+	{
+		return b * a;
+	}
+
+	template <typename T>
+	inline bool operator==(const DynamicMatrix<T> &a, const DynamicMatrix<T> &b)
+	{
+		if (a.rows() != b.rows() || a.cols() != b.cols())
+			return false;
+
+		for (size_t j = 0; j < a.cols(); j++)
+			for (size_t i = 0; i < a.rows(); i++)
+				if (a(i, j) != b(i, j))
+					return false;
+		return true;
+	}
+
+	template <typename T>
+	inline bool operator!=(const DynamicMatrix<T> &a, const DynamicMatrix<T> &b)
+	{
+		return !(a == b);
+	}
+
+	/*!
+	@return The transpose of a.
+	*/
+	template <typename T>
+	inline DynamicMatrix<T> transpose(const MatrixView<const T> &a)
+	{
+		DynamicMatrix<T> result(a.cols(), a.rows());
+		for (size_t j = 0; j < a.cols(); j++)
+			for (size_t i = 0; i < a.rows(); i++)
+				result(j, i) = a(i, j);
+		return result;
+	}
+
+	template <typename T>
+	inline DynamicMatrix<T> transpose(const DynamicMatrix<T> &a)
+	{
+		return transpose(a.view());
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix() : _data(nullptr), _rows(0), _cols(0), _stride(0) {}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix(size_t rows, size_t cols) : DynamicMatrix()
+	{
+		resize(rows, cols);
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix(size_t rows, size_t cols, T diag) : DynamicMatrix(rows, cols)
+	{
+		const size_t n = rows < cols ? rows : cols;
+		for (size_t i = 0; i < n; i++)
+			(*this)(i, i) = diag;
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix(const MatrixView<const T> &a) : DynamicMatrix(a.rows(), a.cols())
+	{
+		// with no rows there is no storage to copy into
+		if (_rows != 0)
+		{
+			for (size_t j = 0; j < _cols; j++)
+				memcpy(_data + j * _stride, &a(0, j), _rows * sizeof(T));
+		}
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix(const DynamicMatrix<T> &a) : DynamicMatrix()
+	{
+		*this = a;
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::DynamicMatrix(DynamicMatrix<T> &&a) : _data(a._data), _rows(a._rows), _cols(a._cols), _stride(a._stride)
+	{
+		a._data = nullptr;
+		a._rows = 0;
+		a._cols = 0;
+		a._stride = 0;
+	}
+
+	template <typename T>
+	DynamicMatrix<T>::~DynamicMatrix()
+	{
+		__1::alignedFree(_data);
+	}
+
+	template <typename T>
+	DynamicMatrix<T> &DynamicMatrix<T>::operator=(const DynamicMatrix<T> &a)
+	{
+		if (this != &a)
+		{
+			if (_rows != a._rows || _cols != a._cols)
+				resize(a._rows, a._cols);
+			if (_data)
+				memcpy(_data, a._data, _stride * _cols * sizeof(T));
+		}
+		return *this;
+	}
+
+	template <typename T>
+	DynamicMatrix<T> &DynamicMatrix<T>::operator=(DynamicMatrix<T> &&a)
+	{
+		if (this != &a)
+		{
+			__1::alignedFree(_data);
+			_data = a._data;
+			_rows = a._rows;
+			_cols = a._cols;
+			_stride = a._stride;
+
+			a._data = nullptr;
+			a._rows = 0;
+			a._cols = 0;
+			a._stride = 0;
+		}
+		return *this;
+	}
+
+	template <typename T>
+	void DynamicMatrix<T>::resize(size_t rows, size_t cols)
+	{
+		// round up so every column starts on an aligned boundary
+		constexpr size_t kPad = MUTIL_STREAM_ALIGNMENT / sizeof(T);
+		const size_t stride = (rows + kPad - 1) / kPad * kPad;
+
+		if (stride * cols != _stride * _cols)
+		{
+			__1::alignedFree(_data);
+			_data = stride * cols != 0 ? (T *)__1::alignedAlloc(stride * cols * sizeof(T), MUTIL_STREAM_ALIGNMENT) : nullptr;
+		}
+
+		_rows = rows;
+		_cols = cols;
+		_stride = stride;
+		if (_data)
+			memset(_data, 0, _stride * _cols * sizeof(T));
+	}
+
+	template <typename T>
+	DynamicMatrix<T> &DynamicMatrix<T>::operator+=(const DynamicMatrix<T> &a)
+	{
+		assert(a._rows == _rows && a._cols == _cols && "the matrices must have the same size");
+		for (size_t i = 0; i < _stride * _cols; i++)
+			_data[i] += a._data[i];
+		return *this;
+	}
+
+	template <typename T>
+	DynamicMatrix<T> &DynamicMatrix<T>::operator-=(const DynamicMatrix<T> &a)
+	{
+		assert(a._rows == _rows && a._cols == _cols && "the matrices must have the same size");
+		for (size_t i = 0; i < _stride * _cols; i++)
+			_data[i] -= a._data[i];
+		return *this;
+	}
+
+	template <typename T>
+	DynamicMatrix<T> &DynamicMatrix<T>::operator*=(T a)
+	{
+		for (size_t i = 0; i < _stride * _cols; i++)
+			_data[i] *= a;
+		return *this;
+	}
+}
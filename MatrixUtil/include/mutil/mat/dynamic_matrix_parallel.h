@@ -0,0 +1,68 @@
+/*!
+\file
+Contains the multithreaded version of the DynamicMatrix product.
+
+Not included by mutil.h, see parallel/thread_pool.h.
+*/
+
+#pragma once
+
+#include "../mutil.h"
+#include "../parallel/thread_pool.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		// Size of the tiles of the result computed by each task. A tile spans
+		// two blocks of A and a whole number of register tiles.
+		constexpr size_t kGemmTileRows = 2 * kGemmMC;
+		constexpr size_t kGemmTileCols = 42 * kGemmNR;
+	}
+
+	/*!
+	Computes c = alpha * a * b + beta * c using several threads. c is split
+	into tiles which are computed independently, each over the whole of k, so
+	the result is the same as that of gemm whatever the number of threads.
+	See gemm.
+
+	@param a An m x k matrix.
+	@param b A k x n matrix.
+	@param c An m x n matrix, receiving the result.
+	@param alpha The scale of the product.
+	@param beta The scale of the original c.
+	@param executor Runs the tiles. If null, ThreadPool::global() is used.
+	*/
+	template <typename T>
+	inline void gemmParallel(typename __1::NoDeduce<MatrixView<const T>>::type a, typename __1::NoDeduce<MatrixView<const T>>::type b,
+		const MatrixView<T> &c, typename __1::NoDeduce<T>::type alpha = T(1), typename __1::NoDeduce<T>::type beta = T(0),
+		Executor *executor = nullptr)
+	{
+		using namespace __1;
+
+		// gemmBlocked checks each tile, but the tiles can fit where the whole matrices do not
+		assert(a.rows() == c.rows() && b.rows() == a.cols() && b.cols() == c.cols() && "a, b and c must be m x k, k x n and m x n");
+
+		Executor &e = executor ? *executor : ThreadPool::global();
+
+		const size_t tilesX = (c.cols() + kGemmTileCols - 1) / kGemmTileCols;
+		const size_t tilesY = (c.rows() + kGemmTileRows - 1) / kGemmTileRows;
+
+		e.parallelFor(tilesX * tilesY, [&](size_t tile) {
+			const size_t j = tile / tilesY * kGemmTileCols;
+			const size_t i = tile % tilesY * kGemmTileRows;
+			const size_t cols = c.cols() - j < kGemmTileCols ? c.cols() - j : kGemmTileCols;
+			const size_t rows = c.rows() - i < kGemmTileRows ? c.rows() - i : kGemmTileRows;
+
+			gemmBlocked<T>(a.block(i, 0, rows, a.cols()), b.block(0, j, b.rows(), cols), c.block(i, j, rows, cols), alpha, beta);
+		});
+	}
+
+	template <typename T>
+	inline void gemmParallel(typename __1::NoDeduce<MatrixView<const T>>::type a, typename __1::NoDeduce<MatrixView<const T>>::type b,
+		DynamicMatrix<T> &c, typename __1::NoDeduce<T>::type alpha = T(1), typename __1::NoDeduce<T>::type beta = T(0),
+		Executor *executor = nullptr)
+	{
+		gemmParallel<T>(a, b, c.view(), alpha, beta, executor);
+	}
+}
@@ -5,6 +5,9 @@
 #include "matrix2.h"
 #include "matrix3.h"
 #include "matrix4.h"
+#include "affine_matrix.h"
+#include "matrix3a.h"
+#include "matrix4a.h"
 
 #include "intmatrix2.h"
 #include "intmatrix3.h"
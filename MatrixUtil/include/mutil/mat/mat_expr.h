@@ -0,0 +1,47 @@
+/*!
+\file
+Extends the expression templates of vec/vec_expr.h to the generic matrix
+types.
+*/
+
+#pragma once
+
+#include "mat.h"
+#include "../vec/vec_expr.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		// operator* on two matrices is their product, not element-wise
+		template <typename T, size_t N, size_t M>
+		struct ExprTraits<BasicMatrix<T, N, M>>
+		{
+			using type = T;
+			static constexpr size_t size = N * M;
+			static constexpr bool elementwise = false;
+		};
+	}
+
+	/*!
+	Starts a lazily evaluated matrix expression. Sums, differences and
+	products and quotients with a scalar are lazy, while the product of two
+	matrices is not. See lazy(const BasicVector &).
+
+	@param a The matrix to start the expression with.
+
+	@return An expression referring to a.
+	*/
+	template <typename T, size_t N, size_t M>
+	constexpr __1::ExprRef<BasicMatrix<T, N, M>> lazy(const BasicMatrix<T, N, M> &a)
+	{
+		return __1::ExprRef<BasicMatrix<T, N, M>>(a);
+	}
+
+	constexpr const Matrix2 &lazy(const Matrix2 &a) { return a; }
+	constexpr const Matrix3 &lazy(const Matrix3 &a) { return a; }
+	constexpr const Matrix4 &lazy(const Matrix4 &a) { return a; }
+	constexpr const IntMatrix2 &lazy(const IntMatrix2 &a) { return a; }
+	constexpr const IntMatrix3 &lazy(const IntMatrix3 &a) { return a; }
+	constexpr const IntMatrix4 &lazy(const IntMatrix4 &a) { return a; }
+}
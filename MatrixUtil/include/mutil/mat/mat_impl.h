@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mat.h"
+#include "../simd/simd.h"
 
 namespace mutil
 {
@@ -25,33 +26,185 @@ namespace mutil
 		return result;
 	}
 
-	template <typename T, size_t N, size_t M, size_t P>
-	constexpr BasicMatrix<T, N, P> operator*(const BasicMatrix<T, N, M> &a, const BasicMatrix<T, M, P> &b)
+	namespace __1
 	{
-		BasicMatrix<T, N, P> result;
-		for (size_t i = 0; i < N; i++)
+		template <bool B>
+		struct Unrolled {};
+
+		// Column j of a * b is the sum over k of column k of a scaled by
+		// b(k, j). Each step is a multiply-add of a whole contiguous column,
+		// which the compiler vectorizes. The column is summed in a local array,
+		// which unlike the result cannot alias a or b. For small matrices the
+		// steps are unrolled over j, k and the rows at compile time, so that
+		// they do not depend on the compiler unrolling and vectorizing loops.
+		template <typename T, size_t M, size_t I>
+		struct MatrixProductRow
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *a, T s, T *column)
+			{
+				column[I] += a[I] * s;
+				MatrixProductRow<T, M, I + 1>::run(a, s, column);
+			}
+		};
+
+		template <typename T, size_t M>
+		struct MatrixProductRow<T, M, M>
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *, T, T *) {}
+		};
+
+		template <typename T, size_t N, size_t M, size_t K>
+		struct MatrixProductTerm
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *a, const T *b, T *column)
+			{
+				MatrixProductRow<T, M, 0>::run(a + K * M, b[K], column);
+				MatrixProductTerm<T, N, M, K + 1>::run(a, b, column);
+			}
+		};
+
+		template <typename T, size_t N, size_t M>
+		struct MatrixProductTerm<T, N, M, N>
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *, const T *, T *) {}
+		};
+
+		template <typename T, size_t N, size_t M, size_t P, size_t J>
+		struct MatrixProductColumn
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *a, const T *b, T *out)
+			{
+				T column[M] = {};
+				MatrixProductTerm<T, N, M, 0>::run(a, b + J * N, column);
+				for (size_t i = 0; i < M; i++)
+					out[J * M + i] = column[i];
+				MatrixProductColumn<T, N, M, P, J + 1>::run(a, b, out);
+			}
+		};
+
+		template <typename T, size_t N, size_t M, size_t P>
+		struct MatrixProductColumn<T, N, M, P, P>
+		{
+			static MUTIL_FORCEINLINE constexpr void run(const T *, const T *, T *) {}
+		};
+
+		template <typename T, size_t N, size_t M, size_t P>
+		constexpr void matrixProduct(const T *a, const T *b, T *out, Unrolled<true>)
+		{
+			MatrixProductColumn<T, N, M, P, 0>::run(a, b, out);
+		}
+
+		// The registers used by the loop below. MatrixProductLane is a single
+		// element unless the element type has a vector type.
+		template <typename T>
+		struct MatrixProductScalar
+		{
+			using type = T;
+			static constexpr size_t width = 1;
+
+			static MUTIL_FORCEINLINE T set1(T a) { return a; }
+			static MUTIL_FORCEINLINE T fmadd(T a, T b, T c) { return a * b + c; }
+			static MUTIL_FORCEINLINE T loadu(const T *p) { return *p; }
+			static MUTIL_FORCEINLINE void storeu(T *p, T a) { *p = a; }
+		};
+
+		template <typename T>
+		struct MatrixProductLane : MatrixProductScalar<T> {};
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		template <>
+		struct MatrixProductLane<float>
+		{
+			using type = vfloat4;
+			static constexpr size_t width = 4;
+
+			static MUTIL_FORCEINLINE vfloat4 set1(float a) { return vset1(vfloat4(), a); }
+			static MUTIL_FORCEINLINE vfloat4 fmadd(vfloat4 a, vfloat4 b, vfloat4 c) { return vfmadd(a, b, c); }
+			static MUTIL_FORCEINLINE vfloat4 loadu(const float *p) { return vloadu(vfloat4(), p); }
+			static MUTIL_FORCEINLINE void storeu(float *p, vfloat4 a) { vstoreu(p, a); }
+		};
+#endif
+
+		// C columns and R registers of rows of a * b, summed over every column
+		// of a. The sums are kept in registers rather than in an array of
+		// elements, which the compiler may otherwise fully unroll over k and
+		// vectorize across columns instead of down them.
+		template <typename L, size_t C, size_t R, typename T>
+		MUTIL_FORCEINLINE void matrixProductBlock(const T *a, size_t m, const T *b, size_t n, T *out)
 		{
-			for (size_t j = 0; j < P; j++)
+			using V = typename L::type;
+
+			V sum[C][R];
+			for (size_t c = 0; c < C; c++)
+				for (size_t r = 0; r < R; r++)
+					sum[c][r] = L::set1(T(0));
+
+			for (size_t k = 0; k < n; k++)
 			{
-				T sum = T(0);
-				for (size_t k = 0; k < M; k++)
-					sum += a.mat[i * M + k] * b.mat[k * P + j];
-				result.mat[i * P + j] = sum;
+				V column[R];
+				for (size_t r = 0; r < R; r++)
+					column[r] = L::loadu(a + k * m + r * L::width);
+
+				for (size_t c = 0; c < C; c++)
+				{
+					const V s = L::set1(b[c * n + k]);
+					for (size_t r = 0; r < R; r++)
+						sum[c][r] = L::fmadd(column[r], s, sum[c][r]);
+				}
 			}
+
+			for (size_t c = 0; c < C; c++)
+				for (size_t r = 0; r < R; r++)
+					L::storeu(out + c * m + r * L::width, sum[c][r]);
+		}
+
+		// C columns of a * b, in blocks of rows as wide as the registers allow.
+		template <typename T, size_t N, size_t M, size_t C>
+		MUTIL_FORCEINLINE void matrixProductColumns(const T *a, const T *b, T *out)
+		{
+			using L = MatrixProductLane<T>;
+			constexpr size_t W = L::width;
+
+			size_t i = 0;
+			for (; i + 2 * W <= M; i += 2 * W)
+				matrixProductBlock<L, C, 2>(a + i, M, b, N, out + i);
+			for (; i + W <= M; i += W)
+				matrixProductBlock<L, C, 1>(a + i, M, b, N, out + i);
+			for (; i < M; i++)
+				matrixProductBlock<MatrixProductScalar<T>, C, 1>(a + i, M, b, N, out + i);
+		}
+
+		// Larger matrices loop over pairs of columns of the result, so that each
+		// column of a loaded into registers is used twice. This pays off at -O2
+		// and from about 24 columns. For smaller matrices, GCC at -O3 vectorizes
+		// a plain loop over the elements of the result as well or better.
+		template <typename T, size_t N, size_t M, size_t P>
+		inline void matrixProduct(const T *a, const T *b, T *out, Unrolled<false>)
+		{
+			size_t j = 0;
+			for (; j + 2 <= P; j += 2)
+				matrixProductColumns<T, N, M, 2>(a, b + j * N, out + j * M);
+			if (j < P)
+				matrixProductColumns<T, N, M, 1>(a, b + j * N, out + j * M);
 		}
+	}
+
+	template <typename T, size_t N, size_t M, size_t P>
+	constexpr BasicMatrix<T, P, M> operator*(const BasicMatrix<T, N, M> &a, const BasicMatrix<T, P, N> &b)
+	{
+		BasicMatrix<T, P, M> result;
+		__1::matrixProduct<T, N, M, P>(a.mat, b.mat, result.mat, __1::Unrolled<(N <= 8 && M <= 8 && P <= 8)>());
 		return result;
 	}
 
 	template <typename T, size_t N, size_t M>
-	constexpr BasicVector<T, N> operator*(const BasicMatrix<T, N, M> &a, const BasicVector<T, M> &b)
+	constexpr BasicVector<T, M> operator*(const BasicMatrix<T, N, M> &a, const BasicVector<T, N> &b)
 	{
-		BasicVector<T, N> result;
-		for (size_t i = 0; i < N; i++)
+		BasicVector<T, M> result(T(0));
+		for (size_t k = 0; k < N; k++)
 		{
-			T sum = T(0);
-			for (size_t j = 0; j < M; j++)
-				sum += a.mat[i * M + j] * b[j];
-			result[i] = sum;
+			for (size_t i = 0; i < M; i++)
+				result[i] += a.mat[k * M + i] * b[k];
 		}
 		return result;
 	}
@@ -248,6 +401,12 @@ namespace mutil
 		_21(mat._21), _22(mat._22), _23(mat._23),
 		_31(mat._31), _32(mat._32), _33(mat._33) {}
 
+    constexpr Matrix3::BasicMatrix(const AffineMatrix &mat) :
+		columns{mat.columns[0], mat.columns[1], mat.columns[2]} {}
+
+    constexpr Matrix3::BasicMatrix(const Matrix3A &mat) :
+		columns{Vector3(mat.columns[0]), Vector3(mat.columns[1]), Vector3(mat.columns[2])} {}
+
     constexpr Matrix3 operator+(const Matrix3 &a, const Matrix3 &b)
     {
         return Matrix3(a.columns[0] + b.columns[0], a.columns[1] + b.columns[1], a.columns[2] + b.columns[2]);
@@ -350,6 +509,15 @@ namespace mutil
 		_31(a._31), _32(a._32), _33(a._33), _34(0.0f),
 		_41(0.0f), _42(0.0f), _43(0.0f), _44(1.0f) {}
 
+    constexpr Matrix4::BasicMatrix(const AffineMatrix &a) :
+		_11(a._11), _12(a._12), _13(a._13), _14(a._14),
+		_21(a._21), _22(a._22), _23(a._23), _24(a._24),
+		_31(a._31), _32(a._32), _33(a._33), _34(a._34),
+		_41(0.0f), _42(0.0f), _43(0.0f), _44(1.0f) {}
+
+    constexpr Matrix4::BasicMatrix(const Matrix4A &a) :
+		columns{a.columns[0], a.columns[1], a.columns[2], a.columns[3]} {}
+
     constexpr Matrix4 operator+(const Matrix4 &a, const Matrix4 &b)
 	{
 		return Matrix4(a.columns[0] + b.columns[0], a.columns[1] + b.columns[1], a.columns[2] + b.columns[2], a.columns[3] + b.columns[3]);
@@ -362,65 +530,89 @@ namespace mutil
 
 	inline Matrix4 MUTIL_VECTORCALL operator*(const Matrix4 &a, const Matrix4 &b)
 	{
-#if MUTIL_USE_SSE
-		constexpr int MASK0 = 0xf1, MASK1 = 0xf2, MASK2 = 0xf4, MASK3 = 0xf8;
-
-		__m128 rc0 = _mm_loadu_ps((float *)&b.columns[0]);
-		__m128 rc1 = _mm_loadu_ps((float *)&b.columns[1]);
-		__m128 rc2 = _mm_loadu_ps((float *)&b.columns[2]);
-		__m128 rc3 = _mm_loadu_ps((float *)&b.columns[3]);
+		// Each result column is a linear combination of the columns of a, weighted
+		// by the elements of the matching column of b:
+		//
+		//     result[j] = a[0] * b[j].x + a[1] * b[j].y + a[2] * b[j].z + a[3] * b[j].w
+		//
+		// The wider paths repeat the columns of a in every 128-bit lane so that
+		// each register computes two (AVX) or four (AVX-512) result columns.
+#if MUTIL_USE_AVX512
+		using namespace __1;
+
+		const __m512 a0 = vbroadcast4(__m512(), a.mat);
+		const __m512 a1 = vbroadcast4(__m512(), a.mat + 4);
+		const __m512 a2 = vbroadcast4(__m512(), a.mat + 8);
+		const __m512 a3 = vbroadcast4(__m512(), a.mat + 12);
+
+		const __m512 bc = vloadu(__m512(), b.mat);
+
+		__m512 r = vmul(a0, vsplat4<0>(bc));
+		r = vfmadd(a1, vsplat4<1>(bc), r);
+		r = vfmadd(a2, vsplat4<2>(bc), r);
+		r = vfmadd(a3, vsplat4<3>(bc), r);
 
-		__m128 lr0 = _mm_set_ps(a.columns[3].x, a.columns[2].x, a.columns[1].x, a.columns[0].x);
-		__m128 lr1 = _mm_set_ps(a.columns[3].y, a.columns[2].y, a.columns[1].y, a.columns[0].y);
-		__m128 lr2 = _mm_set_ps(a.columns[3].z, a.columns[2].z, a.columns[1].z, a.columns[0].z);
-		__m128 lr3 = _mm_set_ps(a.columns[3].w, a.columns[2].w, a.columns[1].w, a.columns[0].w);
-
-		__m128 resultReg0, resultReg1, resultReg2, resultReg3;
-		__m128 tempReg0, tempReg1, tempReg2, tempReg3;
+		Matrix4 mat;
+		vstoreu(mat.mat, r);
+		return mat;
+#elif MUTIL_USE_AVX
+		using namespace __1;
 
-		tempReg0 = _mm_dp_ps(lr0, rc0, MASK0);
-		tempReg1 = _mm_dp_ps(lr1, rc0, MASK1);
-		tempReg2 = _mm_dp_ps(lr2, rc0, MASK2);
-		tempReg3 = _mm_dp_ps(lr3, rc0, MASK3);
+		const __m256 a0 = _mm256_broadcast_ps((const __m128 *)a.mat);
+		const __m256 a1 = _mm256_broadcast_ps((const __m128 *)(a.mat + 4));
+		const __m256 a2 = _mm256_broadcast_ps((const __m128 *)(a.mat + 8));
+		const __m256 a3 = _mm256_broadcast_ps((const __m128 *)(a.mat + 12));
 
-		tempReg0 = _mm_or_ps(tempReg0, tempReg1);
-		tempReg2 = _mm_or_ps(tempReg2, tempReg3);
-		resultReg0 = _mm_or_ps(tempReg0, tempReg2);
+		Matrix4 mat;
+		for (size_t j = 0; j < 16; j += 8)
+		{
+			const __m256 bc = _mm256_loadu_ps(b.mat + j);
 
-		tempReg0 = _mm_dp_ps(lr0, rc1, MASK0);
-		tempReg1 = _mm_dp_ps(lr1, rc1, MASK1);
-		tempReg2 = _mm_dp_ps(lr2, rc1, MASK2);
-		tempReg3 = _mm_dp_ps(lr3, rc1, MASK3);
+			__m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(bc, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = vfmadd(a1, _mm256_permute_ps(bc, _MM_SHUFFLE(1, 1, 1, 1)), r);
+			r = vfmadd(a2, _mm256_permute_ps(bc, _MM_SHUFFLE(2, 2, 2, 2)), r);
+			r = vfmadd(a3, _mm256_permute_ps(bc, _MM_SHUFFLE(3, 3, 3, 3)), r);
 
-		tempReg0 = _mm_or_ps(tempReg0, tempReg1);
-		tempReg2 = _mm_or_ps(tempReg2, tempReg3);
-		resultReg1 = _mm_or_ps(tempReg0, tempReg2);
+			_mm256_storeu_ps(mat.mat + j, r);
+		}
+		return mat;
+#elif MUTIL_USE_SSE
+		using namespace __1;
 
-		tempReg0 = _mm_dp_ps(lr0, rc2, MASK0);
-		tempReg1 = _mm_dp_ps(lr1, rc2, MASK1);
-		tempReg2 = _mm_dp_ps(lr2, rc2, MASK2);
-		tempReg3 = _mm_dp_ps(lr3, rc2, MASK3);
+		const __m128 a0 = _mm_loadu_ps(a.mat);
+		const __m128 a1 = _mm_loadu_ps(a.mat + 4);
+		const __m128 a2 = _mm_loadu_ps(a.mat + 8);
+		const __m128 a3 = _mm_loadu_ps(a.mat + 12);
 
-		tempReg0 = _mm_or_ps(tempReg0, tempReg1);
-		tempReg2 = _mm_or_ps(tempReg2, tempReg3);
-		resultReg2 = _mm_or_ps(tempReg0, tempReg2);
+		Matrix4 mat;
+		for (size_t j = 0; j < 16; j += 4)
+		{
+			const __m128 bc = _mm_loadu_ps(b.mat + j);
 
-		tempReg0 = _mm_dp_ps(lr0, rc3, MASK0);
-		tempReg1 = _mm_dp_ps(lr1, rc3, MASK1);
-		tempReg2 = _mm_dp_ps(lr2, rc3, MASK2);
-		tempReg3 = _mm_dp_ps(lr3, rc3, MASK3);
+			__m128 r = _mm_mul_ps(a0, vshuffle<0, 0, 0, 0>(bc, bc));
+			r = vfmadd(a1, vshuffle<1, 1, 1, 1>(bc, bc), r);
+			r = vfmadd(a2, vshuffle<2, 2, 2, 2>(bc, bc), r);
+			r = vfmadd(a3, vshuffle<3, 3, 3, 3>(bc, bc), r);
 
-		tempReg0 = _mm_or_ps(tempReg0, tempReg1);
-		tempReg2 = _mm_or_ps(tempReg2, tempReg3);
-		resultReg3 = _mm_or_ps(tempReg0, tempReg2);
+			_mm_storeu_ps(mat.mat + j, r);
+		}
+		return mat;
+#elif MUTIL_USE_NEON
+		const float32x4_t a0 = vld1q_f32(a.mat);
+		const float32x4_t a1 = vld1q_f32(a.mat + 4);
+		const float32x4_t a2 = vld1q_f32(a.mat + 8);
+		const float32x4_t a3 = vld1q_f32(a.mat + 12);
 
 		Matrix4 mat;
+		for (size_t j = 0; j < 16; j += 4)
+		{
+			float32x4_t r = vmulq_n_f32(a0, b.mat[j]);
+			r = vmlaq_n_f32(r, a1, b.mat[j + 1]);
+			r = vmlaq_n_f32(r, a2, b.mat[j + 2]);
+			r = vmlaq_n_f32(r, a3, b.mat[j + 3]);
 
-		_mm_storeu_ps((float *)&mat.columns[0], resultReg0);
-		_mm_storeu_ps((float *)&mat.columns[1], resultReg1);
-		_mm_storeu_ps((float *)&mat.columns[2], resultReg2);
-		_mm_storeu_ps((float *)&mat.columns[3], resultReg3);
-
+			vst1q_f32(mat.mat + j, r);
+		}
 		return mat;
 #else
 		return Matrix4(
@@ -479,6 +671,310 @@ namespace mutil
 		return a.columns[0] == b.columns[0] && a.columns[1] == b.columns[1] && a.columns[2] == b.columns[2] && a.columns[3] == b.columns[3];
 	}
 
+    /////////////////////////////////////////////////////////////////
+    // AffineMatrix
+
+    constexpr AffineMatrix::AffineMatrix() :
+		_11(1.0f), _21(0.0f), _31(0.0f),
+		_12(0.0f), _22(1.0f), _32(0.0f),
+		_13(0.0f), _23(0.0f), _33(1.0f),
+		_14(0.0f), _24(0.0f), _34(0.0f) {}
+
+    constexpr AffineMatrix::AffineMatrix(float diag) :
+		_11(diag), _21(0.0f), _31(0.0f),
+		_12(0.0f), _22(diag), _32(0.0f),
+		_13(0.0f), _23(0.0f), _33(diag),
+		_14(0.0f), _24(0.0f), _34(0.0f) {}
+
+    constexpr AffineMatrix::AffineMatrix(const Vector3 &col1, const Vector3 &col2,
+    			const Vector3 &col3, const Vector3 &col4) :
+		columns{col1, col2, col3, col4} {}
+
+    constexpr AffineMatrix::AffineMatrix(float _11, float _12, float _13, float _14,
+                float _21, float _22, float _23, float _24,
+                float _31, float _32, float _33, float _34) :
+                    _11(_11), _21(_21), _31(_31),
+                    _12(_12), _22(_22), _32(_32),
+                    _13(_13), _23(_23), _33(_33),
+                    _14(_14), _24(_24), _34(_34) {}
+
+    constexpr AffineMatrix::AffineMatrix(const Matrix3 &a, const Vector3 &translation) :
+		columns{a.columns[0], a.columns[1], a.columns[2], translation} {}
+
+    constexpr AffineMatrix::AffineMatrix(const Matrix4 &a) :
+		_11(a._11), _21(a._21), _31(a._31),
+		_12(a._12), _22(a._22), _32(a._32),
+		_13(a._13), _23(a._23), _33(a._33),
+		_14(a._14), _24(a._24), _34(a._34) {}
+
+    constexpr AffineMatrix operator+(const AffineMatrix &a, const AffineMatrix &b)
+	{
+		return AffineMatrix(a.columns[0] + b.columns[0], a.columns[1] + b.columns[1], a.columns[2] + b.columns[2], a.columns[3] + b.columns[3]);
+	}
+
+	constexpr AffineMatrix operator-(const AffineMatrix &a, const AffineMatrix &b)
+	{
+		return AffineMatrix(a.columns[0] - b.columns[0], a.columns[1] - b.columns[1], a.columns[2] - b.columns[2], a.columns[3] - b.columns[3]);
+	}
+
+	inline AffineMatrix MUTIL_VECTORCALL operator*(const AffineMatrix &a, const AffineMatrix &b)
+	{
+		// As for Matrix4, each result column is a linear combination of the
+		// columns of a. The implicit last row of b is (0, 0, 0, 1), so only the
+		// translation picks up the last column of a, and the products of the
+		// last row of a are never computed.
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		vfloat4 a0, a1, a2, a3;
+		vload3x4(a.mat, a0, a1, a2, a3);
+
+		const vfloat4 r0 = vfmadd(a0, vset1(vfloat4(), b._11), vfmadd(a1, vset1(vfloat4(), b._21), vmul(a2, vset1(vfloat4(), b._31))));
+		const vfloat4 r1 = vfmadd(a0, vset1(vfloat4(), b._12), vfmadd(a1, vset1(vfloat4(), b._22), vmul(a2, vset1(vfloat4(), b._32))));
+		const vfloat4 r2 = vfmadd(a0, vset1(vfloat4(), b._13), vfmadd(a1, vset1(vfloat4(), b._23), vmul(a2, vset1(vfloat4(), b._33))));
+		const vfloat4 r3 = vfmadd(a0, vset1(vfloat4(), b._14), vfmadd(a1, vset1(vfloat4(), b._24), vfmadd(a2, vset1(vfloat4(), b._34), a3)));
+
+		AffineMatrix mat;
+		vstore3x4(mat.mat, r0, r1, r2, r3);
+		return mat;
+#else
+		return AffineMatrix(
+			a._11 * b._11 + a._12 * b._21 + a._13 * b._31,
+			a._11 * b._12 + a._12 * b._22 + a._13 * b._32,
+			a._11 * b._13 + a._12 * b._23 + a._13 * b._33,
+			a._11 * b._14 + a._12 * b._24 + a._13 * b._34 + a._14,
+			a._21 * b._11 + a._22 * b._21 + a._23 * b._31,
+			a._21 * b._12 + a._22 * b._22 + a._23 * b._32,
+			a._21 * b._13 + a._22 * b._23 + a._23 * b._33,
+			a._21 * b._14 + a._22 * b._24 + a._23 * b._34 + a._24,
+			a._31 * b._11 + a._32 * b._21 + a._33 * b._31,
+			a._31 * b._12 + a._32 * b._22 + a._33 * b._32,
+			a._31 * b._13 + a._32 * b._23 + a._33 * b._33,
+			a._31 * b._14 + a._32 * b._24 + a._33 * b._34 + a._34);
+#endif
+	}
+
+	constexpr Vector4 operator*(const AffineMatrix &a, const Vector4 &b)
+	{
+		return Vector4(
+			a.columns[0].x * b.x + a.columns[1].x * b.y + a.columns[2].x * b.z + a.columns[3].x * b.w,
+			a.columns[0].y * b.x + a.columns[1].y * b.y + a.columns[2].y * b.z + a.columns[3].y * b.w,
+			a.columns[0].z * b.x + a.columns[1].z * b.y + a.columns[2].z * b.z + a.columns[3].z * b.w,
+			b.w);
+	}
+
+	constexpr AffineMatrix operator*(const AffineMatrix &a, float b)
+	{
+		return AffineMatrix(
+			a.columns[0] * b,
+			a.columns[1] * b,
+			a.columns[2] * b,
+			a.columns[3] * b);
+	}
+
+	constexpr AffineMatrix operator/(const AffineMatrix &a, float b)
+	{
+		return AffineMatrix(
+			a.columns[0] / b,
+			a.columns[1] / b,
+			a.columns[2] / b,
+			a.columns[3] / b);
+	}
+
+	constexpr bool operator==(const AffineMatrix &a, const AffineMatrix &b)
+	{
+		return a.columns[0] == b.columns[0] && a.columns[1] == b.columns[1] && a.columns[2] == b.columns[2] && a.columns[3] == b.columns[3];
+	}
+
+	inline AffineMatrix &AffineMatrix::operator*=(const AffineMatrix &a)
+	{
+		return *this = *this * a;
+	}
+
+	/*!
+	Transforms a point by an affine matrix, as a * Vector4(p, 1).
+
+	@param a The matrix.
+	@param p The point to transform.
+
+	@return The transformed point.
+	*/
+	constexpr Vector3 transformpoint(const AffineMatrix &a, const Vector3 &p)
+	{
+		return Vector3(
+			a._11 * p.x + a._12 * p.y + a._13 * p.z + a._14,
+			a._21 * p.x + a._22 * p.y + a._23 * p.z + a._24,
+			a._31 * p.x + a._32 * p.y + a._33 * p.z + a._34);
+	}
+
+	/*!
+	Transforms a direction by an affine matrix, as a * Vector4(v, 0). The
+	translation is ignored.
+
+	@param a The matrix.
+	@param v The direction to transform.
+
+	@return The transformed direction.
+	*/
+	constexpr Vector3 transformvector(const AffineMatrix &a, const Vector3 &v)
+	{
+		return Vector3(
+			a._11 * v.x + a._12 * v.y + a._13 * v.z,
+			a._21 * v.x + a._22 * v.y + a._23 * v.z,
+			a._31 * v.x + a._32 * v.y + a._33 * v.z);
+	}
+
+    /////////////////////////////////////////////////////////////////
+    // Matrix3A
+
+	constexpr Matrix3A::Matrix3A() :
+		columns{Vector3A(1.0f, 0.0f, 0.0f), Vector3A(0.0f, 1.0f, 0.0f), Vector3A(0.0f, 0.0f, 1.0f)} {}
+
+	constexpr Matrix3A::Matrix3A(const Vector3A &col1, const Vector3A &col2, const Vector3A &col3) :
+		columns{col1, col2, col3} {}
+
+	constexpr Matrix3A::Matrix3A(const Matrix3 &a) :
+		columns{Vector3A(a.columns[0]), Vector3A(a.columns[1]), Vector3A(a.columns[2])} {}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Matrix3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		const vfloat4 r = vfmadd(vloadvec3a(a.columns[0]), vset1(vfloat4(), b.x),
+			vfmadd(vloadvec3a(a.columns[1]), vset1(vfloat4(), b.y),
+				vmul(vloadvec3a(a.columns[2]), vset1(vfloat4(), b.z))));
+		return vtovec3a(r);
+#else
+		return a.columns[0] * b.x + a.columns[1] * b.y + a.columns[2] * b.z;
+#endif
+	}
+
+	inline Matrix3A MUTIL_VECTORCALL operator*(const Matrix3A &a, const Matrix3A &b)
+	{
+		return Matrix3A(a * b.columns[0], a * b.columns[1], a * b.columns[2]);
+	}
+
+	constexpr bool operator==(const Matrix3A &a, const Matrix3A &b)
+	{
+		return a.columns[0] == b.columns[0] && a.columns[1] == b.columns[1] && a.columns[2] == b.columns[2];
+	}
+
+	inline Matrix3A &Matrix3A::operator*=(const Matrix3A &a)
+	{
+		return *this = *this * a;
+	}
+
+    /////////////////////////////////////////////////////////////////
+    // Matrix4A
+
+	constexpr Matrix4A::Matrix4A() :
+		columns{Vector4(1.0f, 0.0f, 0.0f, 0.0f), Vector4(0.0f, 1.0f, 0.0f, 0.0f),
+			Vector4(0.0f, 0.0f, 1.0f, 0.0f), Vector4(0.0f, 0.0f, 0.0f, 1.0f)} {}
+
+	constexpr Matrix4A::Matrix4A(const Vector4 &col1, const Vector4 &col2, const Vector4 &col3, const Vector4 &col4) :
+		columns{col1, col2, col3, col4} {}
+
+	constexpr Matrix4A::Matrix4A(const Matrix4 &a) :
+		columns{a.columns[0], a.columns[1], a.columns[2], a.columns[3]} {}
+
+	inline Matrix4A MUTIL_VECTORCALL operator*(const Matrix4A &a, const Matrix4A &b)
+	{
+		// The same kernels as for Matrix4. As a matrix fills a cache line, every
+		// load and store is aligned, including the 256 and 512 bit ones.
+#if MUTIL_USE_AVX512
+		using namespace __1;
+
+		const __m512 a0 = vbroadcast4(__m512(), a.mat);
+		const __m512 a1 = vbroadcast4(__m512(), a.mat + 4);
+		const __m512 a2 = vbroadcast4(__m512(), a.mat + 8);
+		const __m512 a3 = vbroadcast4(__m512(), a.mat + 12);
+
+		const __m512 bc = vload(__m512(), b.mat);
+
+		__m512 r = vmul(a0, vsplat4<0>(bc));
+		r = vfmadd(a1, vsplat4<1>(bc), r);
+		r = vfmadd(a2, vsplat4<2>(bc), r);
+		r = vfmadd(a3, vsplat4<3>(bc), r);
+
+		Matrix4A mat;
+		vstore(mat.mat, r);
+		return mat;
+#elif MUTIL_USE_AVX
+		using namespace __1;
+
+		const __m256 a0 = _mm256_broadcast_ps((const __m128 *)a.mat);
+		const __m256 a1 = _mm256_broadcast_ps((const __m128 *)(a.mat + 4));
+		const __m256 a2 = _mm256_broadcast_ps((const __m128 *)(a.mat + 8));
+		const __m256 a3 = _mm256_broadcast_ps((const __m128 *)(a.mat + 12));
+
+		Matrix4A mat;
+		for (size_t j = 0; j < 16; j += 8)
+		{
+			const __m256 bc = _mm256_load_ps(b.mat + j);
+
+			__m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(bc, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = vfmadd(a1, _mm256_permute_ps(bc, _MM_SHUFFLE(1, 1, 1, 1)), r);
+			r = vfmadd(a2, _mm256_permute_ps(bc, _MM_SHUFFLE(2, 2, 2, 2)), r);
+			r = vfmadd(a3, _mm256_permute_ps(bc, _MM_SHUFFLE(3, 3, 3, 3)), r);
+
+			_mm256_store_ps(mat.mat + j, r);
+		}
+		return mat;
+#elif MUTIL_USE_SSE
+		using namespace __1;
+
+		const __m128 a0 = _mm_load_ps(a.mat);
+		const __m128 a1 = _mm_load_ps(a.mat + 4);
+		const __m128 a2 = _mm_load_ps(a.mat + 8);
+		const __m128 a3 = _mm_load_ps(a.mat + 12);
+
+		Matrix4A mat;
+		for (size_t j = 0; j < 16; j += 4)
+		{
+			const __m128 bc = _mm_load_ps(b.mat + j);
+
+			__m128 r = _mm_mul_ps(a0, vshuffle<0, 0, 0, 0>(bc, bc));
+			r = vfmadd(a1, vshuffle<1, 1, 1, 1>(bc, bc), r);
+			r = vfmadd(a2, vshuffle<2, 2, 2, 2>(bc, bc), r);
+			r = vfmadd(a3, vshuffle<3, 3, 3, 3>(bc, bc), r);
+
+			_mm_store_ps(mat.mat + j, r);
+		}
+		return mat;
+#else
+		return Matrix4A(Matrix4(a) * Matrix4(b));
+#endif
+	}
+
+	inline Vector4 MUTIL_VECTORCALL operator*(const Matrix4A &a, const Vector4 &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		vfloat4 r = vmul(vload(vfloat4(), a.mat), vset1(vfloat4(), b.x));
+		r = vfmadd(vload(vfloat4(), a.mat + 4), vset1(vfloat4(), b.y), r);
+		r = vfmadd(vload(vfloat4(), a.mat + 8), vset1(vfloat4(), b.z), r);
+		r = vfmadd(vload(vfloat4(), a.mat + 12), vset1(vfloat4(), b.w), r);
+
+		Vector4 result;
+		vstoreu(result.vec, r);
+		return result;
+#else
+		return Matrix4(a) * b;
+#endif
+	}
+
+	constexpr bool operator==(const Matrix4A &a, const Matrix4A &b)
+	{
+		return a.columns[0] == b.columns[0] && a.columns[1] == b.columns[1] && a.columns[2] == b.columns[2] && a.columns[3] == b.columns[3];
+	}
+
+	inline Matrix4A &Matrix4A::operator*=(const Matrix4A &a)
+	{
+		return *this = *this * a;
+	}
+
     /////////////////////////////////////////////////////////////////
     // IntMatrix2
 
@@ -4,6 +4,10 @@
 
 namespace mutil
 {
+	/*!
+	A matrix of N columns, each a vector of M rows, stored in column-major
+	order. Element (r, c) is mat[c * M + r].
+	*/
 	template <typename T, size_t N, size_t M>
 	class BasicMatrix
 	{
@@ -19,7 +23,7 @@ namespace mutil
 			for (size_t i = 0; i < N * M; i++)
 				mat[i] = T(0);
 		
-			for (size_t i = 0; i < N; i++)
+			for (size_t i = 0; i < N && i < M; i++)
 				mat[i * M + i] = T(1);
 		}
 		
@@ -27,7 +31,7 @@ namespace mutil
 		{
 			for (size_t i = 0; i < N * M; i++)
 				mat[i] = T(0);
-			for (size_t i = 0; i < N; i++)
+			for (size_t i = 0; i < N && i < M; i++)
 				mat[i * M + i] = diag;
 		}
 
@@ -37,6 +41,13 @@ namespace mutil
 				mat[i] = a.mat[i];
 		}
 
+		constexpr BasicMatrix<T, N, M> &operator=(const BasicMatrix<T, N, M> &a)
+		{
+			for (size_t i = 0; i < N * M; i++)
+				mat[i] = a.mat[i];
+			return *this;
+		}
+
 		constexpr BasicMatrix<T, N, M> &operator+=(const BasicMatrix<T, N, M> &a);
 		constexpr BasicMatrix<T, N, M> &operator-=(const BasicMatrix<T, N, M> &a);
 		constexpr BasicMatrix<T, N, M> &operator*=(const BasicMatrix<T, N, M> &a);
@@ -54,10 +65,10 @@ namespace mutil
 	constexpr BasicMatrix<T, N, M> operator-(const BasicMatrix<T, N, M> &a, const BasicMatrix<T, N, M> &b);
 
 	template <typename T, size_t N, size_t M, size_t P>
-	constexpr BasicMatrix<T, N, P> operator*(const BasicMatrix<T, N, M> &a, const BasicMatrix<T, M, P> &b);
+	constexpr BasicMatrix<T, P, M> operator*(const BasicMatrix<T, N, M> &a, const BasicMatrix<T, P, N> &b);
 
 	template <typename T, size_t N, size_t M>
-	constexpr BasicVector<T, N> operator*(const BasicMatrix<T, N, M> &a, const BasicVector<T, M> &b);
+	constexpr BasicVector<T, M> operator*(const BasicMatrix<T, N, M> &a, const BasicVector<T, N> &b);
 
 	template <typename T, size_t N, size_t M>
 	constexpr BasicMatrix<T, N, M> operator*(const BasicMatrix<T, N, M> &a, T b);
@@ -84,4 +95,8 @@ namespace mutil
 	using IntMatrix2 = IntMatrix<2, 2>;
 	using IntMatrix3 = IntMatrix<3, 3>;
 	using IntMatrix4 = IntMatrix<4, 4>;
+
+	class AffineMatrix;
+	class Matrix3A;
+	class Matrix4A;
 }
@@ -29,6 +29,8 @@ namespace mutil
 		explicit constexpr BasicMatrix(const IntMatrix3 &a);
 		explicit constexpr BasicMatrix(const Matrix2 &a);
 		explicit constexpr BasicMatrix(const Matrix4 &a);
+		explicit constexpr BasicMatrix(const AffineMatrix &a);
+		explicit constexpr BasicMatrix(const Matrix3A &a);
 
 		constexpr const float &operator[](size_t i) const { return mat[i]; }
 		constexpr float &operator[](size_t i) { return mat[i]; }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mat_types.h"
+#include "../vec/vector3a.h"
+
+namespace mutil
+{
+	/*!
+	A Matrix3 whose columns are Vector3A, so that each column is one aligned
+	register. It takes 48 bytes to the 36 of a Matrix3 and is meant for
+	matrices which are multiplied with Vector3A.
+	*/
+	class alignas(16) Matrix3A
+	{
+	public:
+		Vector3A columns[3];
+
+		constexpr Matrix3A();
+		explicit constexpr Matrix3A(const Vector3A &col1, const Vector3A &col2, const Vector3A &col3);
+		explicit constexpr Matrix3A(const Matrix3 &a);
+
+		inline Matrix3A &operator*=(const Matrix3A &a);
+	};
+
+	inline Matrix3A MUTIL_VECTORCALL operator*(const Matrix3A &a, const Matrix3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Matrix3A &a, const Vector3A &b);
+	constexpr bool operator==(const Matrix3A &a, const Matrix3A &b);
+}
@@ -33,13 +33,15 @@ namespace mutil
 		explicit constexpr BasicMatrix(const IntMatrix4 &a);
 		explicit constexpr BasicMatrix(const Matrix2 &a);
 		explicit constexpr BasicMatrix(const Matrix3 &a);
+		explicit constexpr BasicMatrix(const AffineMatrix &a);
+		explicit constexpr BasicMatrix(const Matrix4A &a);
 
 		constexpr const float &operator[](size_t i) const { return mat[i]; }
 		constexpr float &operator[](size_t i) { return mat[i]; }
 
-		constexpr float determinant() const;
+		MUTIL_SIMD_CONSTEXPR float determinant() const;
 		constexpr Matrix4 transpose() const;
-		constexpr Matrix4 inverse() const;
+		MUTIL_SIMD_CONSTEXPR Matrix4 inverse() const;
 	};
 
 	constexpr Matrix4 operator+(const Matrix4 &a, const Matrix4 &b);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "mat_types.h"
+
+namespace mutil
+{
+	/*!
+	A Matrix4 aligned to 64 bytes, the size of a cache line on most processors.
+	A matrix then never straddles two lines, and every column is loaded and
+	stored with aligned instructions. Arrays of them take no more memory than
+	arrays of Matrix4, as the size is already 64. As with Vector3A, heap
+	arrays need an aligned allocation before C++17.
+	*/
+	class alignas(64) Matrix4A
+	{
+	public:
+		union
+		{
+			Vector4 columns[4];
+			struct
+			{
+				float _11, _21, _31, _41;
+				float _12, _22, _32, _42;
+				float _13, _23, _33, _43;
+				float _14, _24, _34, _44;
+			};
+			float mat[16];
+		};
+
+		constexpr Matrix4A();
+		explicit constexpr Matrix4A(const Vector4 &col1, const Vector4 &col2,
+				const Vector4 &col3, const Vector4 &col4);
+		explicit constexpr Matrix4A(const Matrix4 &a);
+
+		constexpr const float &operator[](size_t i) const { return mat[i]; }
+		constexpr float &operator[](size_t i) { return mat[i]; }
+
+		inline Matrix4A &operator*=(const Matrix4A &a);
+	};
+
+	inline Matrix4A MUTIL_VECTORCALL operator*(const Matrix4A &a, const Matrix4A &b);
+	inline Vector4 MUTIL_VECTORCALL operator*(const Matrix4A &a, const Vector4 &b);
+	constexpr bool operator==(const Matrix4A &a, const Matrix4A &b);
+}
@@ -0,0 +1,286 @@
+/*!
+\file
+Contains the precision tiers of the approximated functions in f_math.h. Each
+of inverseSqrt, sin, cos, tan, asin, acos, atan, log2, log and log10 can be
+called with a tier, either as a template argument or as a tag:
+
+	float a = mutil::sin<mutil::precision::Fast>(x);
+	float b = mutil::sin(x, mutil::precision::Precise());
+
+The functions in f_math.h which are called without a tier are unchanged.
+Functions not listed here are exact in every build and have no tiers.
+
+Fast uses low order polynomials with cheap range reduction, and does not handle
+special values. Balanced uses the same kernels as simd/simd_math.h, so its
+results match the lane-parallel versions. Precise rounds a double precision
+result, so it is almost always correctly rounded.
+
+Maximum errors, measured by MatrixUtilAccuracy over every 127th float in the
+domain, in scalar, SSE4.1 and AVX2 builds. Absolute errors are given where the
+error relative to a result near zero is not meaningful:
+
+| Function    | Domain        | Fast        | Balanced            | Precise |
+|-------------|---------------|-------------|---------------------|---------|
+| inverseSqrt | normal, > 0   | 1.8e-3 rel  | 4 ulp               | 0.5 ulp |
+| sin, cos    | [-8192, 8192] | 7e-6 abs    | 9.3e-8 abs, 122 ulp | 0.5 ulp |
+| tan         | [-8192, 8192] | 6.9e-2 rel  | 8.1e-6 rel          | 0.5 ulp |
+| asin, acos  | [-1, 1]       | 6.8e-5 abs* | 3.5 ulp             | 0.5 ulp |
+| atan        | finite        | 1.2e-5 abs  | 2.8 ulp             | 0.5 ulp |
+| log2        | normal, > 0   | 1.9e-5 abs  | 1.4 ulp             | 0.5 ulp |
+| log         | normal, > 0   | 1.7e-5 abs  | 0.9 ulp             | 0.5 ulp |
+| log10       | normal, > 0   | 9.2e-6 abs  | 2 ulp               | 0.5 ulp |
+
+* Fast asin and acos are the functions without a tier, which already use a
+cubic polynomial and a square root, so they are no faster than the default.
+
+With SSE, the Fast inverseSqrt is within 3.3e-4 relative. The large relative
+errors of tan are near its zeros and poles for large x.
+
+For comparison, the functions without a tier reach 7.5e-4 absolute for sin and
+cos, 6.8e-5 for asin and acos, and 0.22 for atan. inverseSqrt is within 3e-4
+relative with SSE and 1.5 ulp otherwise. tan, log2, log and log10 call the C
+library.
+*/
+
+#pragma once
+
+#include "f_math.h"
+#include "../simd/simd_math.h"
+
+#include <type_traits>
+
+namespace mutil
+{
+	namespace precision
+	{
+		/*!
+		Cheapest approximations. Most are within about 2e-5 absolute, and
+		inverseSqrt within 1.8e-3 relative. tan is the exception, with relative
+		errors up to 7e-2 near its zeros and poles. See the table above.
+		*/
+		struct Fast {};
+
+		/*!
+		Accurate to a few ulp, without calling into the C library.
+		*/
+		struct Balanced {};
+
+		/*!
+		Correctly rounded in almost all cases.
+		*/
+		struct Precise {};
+	}
+
+	namespace __1
+	{
+		template <typename P>
+		struct IsPrecisionTier : std::false_type {};
+
+		template <> struct IsPrecisionTier<precision::Fast> : std::true_type {};
+		template <> struct IsPrecisionTier<precision::Balanced> : std::true_type {};
+		template <> struct IsPrecisionTier<precision::Precise> : std::true_type {};
+
+		template <typename P>
+		struct FMathTier;
+
+		// Rounds to the nearest integer, for |x| < 2^22.
+		MUTIL_FORCEINLINE float roundFast(float x)
+		{
+			return (x + 12582912.0f) - 12582912.0f;
+		}
+
+		template <>
+		struct FMathTier<precision::Fast>
+		{
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL inverseSqrt(float x)
+			{
+				return fastInverseSqrt(x);
+			}
+
+			// Reduces x to [-pi, pi], splitting 2pi so that k * 6.28125 is exact.
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL reduce(float x)
+			{
+				const float k = roundFast(x * 0.159154943091895336f);
+				return (x - k * 6.28125f) - k * 1.93530717958647692e-3f;
+			}
+
+			// sin(r) = r (r - pi) (r + pi) p(r^2) for r in [-pi, pi]
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL sinReduced(float r)
+			{
+				const float r2 = r * r;
+				float p = 2.136588819e-6f;
+				p = p * r2 - 1.713380771e-4f;
+				p = p * r2 + 6.616479717e-3f;
+				p = p * r2 - 1.013188809e-1f;
+				return r * (r2 - 9.86960440108935862f) * p;
+			}
+
+			// Shifts r by pi/2 in the reduced range rather than x, which for
+			// large x would lose the bits that are shifted in.
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL cosReduced(float r)
+			{
+				const float s = r + MUTIL_PI2;
+				return sinReduced(s > MUTIL_PI ? s - MUTIL_2PI : s);
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL sin(float x)
+			{
+				return sinReduced(reduce(x));
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL cos(float x)
+			{
+				return cosReduced(reduce(x));
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL tan(float x)
+			{
+				const float r = reduce(x);
+				return sinReduced(r) / cosReduced(r);
+			}
+
+			// the functions without a tier are already as cheap as a useful
+			// approximation gets
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL asin(float x)
+			{
+				return mutil::asin(x);
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL acos(float x)
+			{
+				return mutil::acos(x);
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL atan(float x)
+			{
+				// Abramowitz and Stegun 4.4.49, with atan(x) = pi/2 - atan(1/x) for |x| > 1
+				const float a = mutil::abs(x);
+				const bool inv = a > 1.0f;
+				const float t = inv ? 1.0f / a : a;
+				const float t2 = t * t;
+
+				float p = 0.0208351f;
+				p = p * t2 - 0.0851330f;
+				p = p * t2 + 0.1801410f;
+				p = p * t2 - 0.3302995f;
+				p = p * t2 + 0.9998660f;
+				p *= t;
+
+				const float r = inv ? MUTIL_PI2 - p : p;
+				return x < 0.0f ? -r : r;
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log2(float x)
+			{
+				union
+				{
+					float f;
+					int32_t i;
+				} un;
+
+				// x = 2^e * m with m in [1, 2), log2(m) = t q(t) with t = m - 1
+				un.f = x;
+				const float e = (float)((un.i >> 23) - 127);
+				un.i = (un.i & 0x007fffff) | 0x3f800000;
+				const float t = un.f - 1.0f;
+
+				float q = 4.638530686e-2f;
+				q = q * t - 1.962695122e-1f;
+				q = q * t + 4.175956845e-1f;
+				q = q * t - 7.096627951e-1f;
+				q = q * t + 1.441965580e+0f;
+				return q * t + e;
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log(float x)
+			{
+				return log2(x) * MUTIL_1_LOG2E;
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log10(float x)
+			{
+				return log2(x) * MUTIL_1_LOG2_10;
+			}
+		};
+
+		template <>
+		struct FMathTier<precision::Balanced>
+		{
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL inverseSqrt(float x)
+			{
+#if MUTIL_USE_SSE
+				// one Newton-Raphson step on the 12 bit estimate
+				const __m128 v = _mm_set_ss(x);
+				const __m128 y = _mm_rsqrt_ss(v);
+				const __m128 yy = _mm_mul_ss(_mm_mul_ss(v, y), y);
+				return _mm_cvtss_f32(_mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), y), _mm_sub_ss(_mm_set_ss(3.0f), yy)));
+#elif MUTIL_USE_NEON
+				const float32x2_t v = vdup_n_f32(x);
+				float32x2_t y = vrsqrte_f32(v);
+				y = vmul_f32(vrsqrts_f32(vmul_f32(v, y), y), y);
+				y = vmul_f32(vrsqrts_f32(vmul_f32(v, y), y), y);
+				return vget_lane_f32(y, 0);
+#else
+				return 1.0f / sqrtf(x);
+#endif
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL sin(float x) { return vsin(x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL cos(float x) { return vcos(x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL tan(float x) { return vtan(x); }
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL asin(float x)
+			{
+				// (1 - x)(1 + x) avoids the cancellation in 1 - x^2 near |x| = 1
+				return vatan2(x, sqrtf((1.0f - x) * (1.0f + x)));
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL acos(float x)
+			{
+				return vatan2(sqrtf((1.0f - x) * (1.0f + x)), x);
+			}
+
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL atan(float x) { return vatan(x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log2(float x) { return vlog2(x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log(float x) { return vlog(x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log10(float x) { return vlog(x) * 0.434294481903251828f; }
+		};
+
+		template <>
+		struct FMathTier<precision::Precise>
+		{
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL inverseSqrt(float x) { return (float)(1.0 / std::sqrt((double)x)); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL sin(float x) { return (float)std::sin((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL cos(float x) { return (float)std::cos((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL tan(float x) { return (float)std::tan((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL asin(float x) { return (float)std::asin((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL acos(float x) { return (float)std::acos((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL atan(float x) { return (float)std::atan((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log2(float x) { return (float)std::log2((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log(float x) { return (float)std::log((double)x); }
+			static MUTIL_FORCEINLINE float MUTIL_VECTORCALL log10(float x) { return (float)std::log10((double)x); }
+		};
+	}
+
+	// name<P>(x) and name(x, P()) both evaluate name at precision tier P. Only
+	// the tags in mutil::precision select them, so other two argument calls
+	// are left to the overloads they were meant for.
+#define __fmath_tiered(name) \
+	template <typename P, typename = typename std::enable_if<__1::IsPrecisionTier<P>::value>::type> \
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL name(float x) { return __1::FMathTier<P>::name(x); } \
+	template <typename P, typename = typename std::enable_if<__1::IsPrecisionTier<P>::value>::type> \
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL name(float x, P) { return __1::FMathTier<P>::name(x); }
+
+	__fmath_tiered(inverseSqrt)
+	__fmath_tiered(sin)
+	__fmath_tiered(cos)
+	__fmath_tiered(tan)
+	__fmath_tiered(asin)
+	__fmath_tiered(acos)
+	__fmath_tiered(atan)
+	__fmath_tiered(log2)
+	__fmath_tiered(log)
+	__fmath_tiered(log10)
+
+#undef __fmath_tiered
+}
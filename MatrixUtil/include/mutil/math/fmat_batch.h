@@ -0,0 +1,185 @@
+/*!
+\file
+Contains methods which operate on whole arrays of vectors or matrices at once.
+*/
+
+#pragma once
+
+#include "../mat/mat.h"
+#include "../simd/simd.h"
+
+namespace mutil
+{
+	/*!
+	Transforms an array of points by a matrix, treating each point as having a w of 1.
+
+	@param m The transformation matrix.
+	@param in The points to transform.
+	@param out Receives the transformed points. May be the same as in.
+	@param count The number of points.
+	@param perspective Whether to divide each result by its w component.
+	*/
+	inline void transformPoints(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count, bool perspective = false)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z;
+			vload3(lane, (const float *)(in + i), x, y, z);
+
+			auto ox = vfmadd(vset1(lane, m._11), x, vfmadd(vset1(lane, m._12), y, vfmadd(vset1(lane, m._13), z, vset1(lane, m._14))));
+			auto oy = vfmadd(vset1(lane, m._21), x, vfmadd(vset1(lane, m._22), y, vfmadd(vset1(lane, m._23), z, vset1(lane, m._24))));
+			auto oz = vfmadd(vset1(lane, m._31), x, vfmadd(vset1(lane, m._32), y, vfmadd(vset1(lane, m._33), z, vset1(lane, m._34))));
+
+			if (perspective)
+			{
+				auto ow = vfmadd(vset1(lane, m._41), x, vfmadd(vset1(lane, m._42), y, vfmadd(vset1(lane, m._43), z, vset1(lane, m._44))));
+				auto rw = vdiv(vset1(lane, 1.0f), ow);
+				ox = vmul(ox, rw);
+				oy = vmul(oy, rw);
+				oz = vmul(oz, rw);
+			}
+
+			vstore3((float *)(out + i), ox, oy, oz);
+		});
+	}
+
+	/*!
+	Transforms an array of direction vectors by a matrix. The translation of the
+	matrix is ignored.
+
+	@param m The transformation matrix.
+	@param in The vectors to transform.
+	@param out Receives the transformed vectors. May be the same as in.
+	@param count The number of vectors.
+	*/
+	inline void transformVectors(const Matrix4 &m, const Vector3 *in, Vector3 *out, size_t count)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z;
+			vload3(lane, (const float *)(in + i), x, y, z);
+
+			auto ox = vfmadd(vset1(lane, m._11), x, vfmadd(vset1(lane, m._12), y, vmul(vset1(lane, m._13), z)));
+			auto oy = vfmadd(vset1(lane, m._21), x, vfmadd(vset1(lane, m._22), y, vmul(vset1(lane, m._23), z)));
+			auto oz = vfmadd(vset1(lane, m._31), x, vfmadd(vset1(lane, m._32), y, vmul(vset1(lane, m._33), z)));
+
+			vstore3((float *)(out + i), ox, oy, oz);
+		});
+	}
+
+	/*!
+	Transforms an array of homogeneous vectors by a matrix. Equivalent to computing
+	m * in[i] for every element.
+
+	@param m The transformation matrix.
+	@param in The vectors to transform.
+	@param out Receives the transformed vectors. May be the same as in.
+	@param count The number of vectors.
+	@param perspective Whether to divide each result by its w component.
+	*/
+	inline void transformPoints4(const Matrix4 &m, const Vector4 *in, Vector4 *out, size_t count, bool perspective = false)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z, w;
+			vload4(lane, (const float *)(in + i), x, y, z, w);
+
+			auto ox = vfmadd(vset1(lane, m._11), x, vfmadd(vset1(lane, m._12), y, vfmadd(vset1(lane, m._13), z, vmul(vset1(lane, m._14), w))));
+			auto oy = vfmadd(vset1(lane, m._21), x, vfmadd(vset1(lane, m._22), y, vfmadd(vset1(lane, m._23), z, vmul(vset1(lane, m._24), w))));
+			auto oz = vfmadd(vset1(lane, m._31), x, vfmadd(vset1(lane, m._32), y, vfmadd(vset1(lane, m._33), z, vmul(vset1(lane, m._34), w))));
+			auto ow = vfmadd(vset1(lane, m._41), x, vfmadd(vset1(lane, m._42), y, vfmadd(vset1(lane, m._43), z, vmul(vset1(lane, m._44), w))));
+
+			if (perspective)
+			{
+				auto rw = vdiv(vset1(lane, 1.0f), ow);
+				ox = vmul(ox, rw);
+				oy = vmul(oy, rw);
+				oz = vmul(oz, rw);
+				ow = vset1(lane, 1.0f);
+			}
+
+			vstore4((float *)(out + i), ox, oy, oz, ow);
+		});
+	}
+
+	/*!
+	Multiplies pairs of matrices, computing a[i] * b[i] for every element.
+
+	@param a The left hand matrices.
+	@param b The right hand matrices.
+	@param out Receives the products. May be the same as a or b.
+	@param count The number of matrices in each array.
+	*/
+	inline void multiplyMany(const Matrix4 *a, const Matrix4 *b, Matrix4 *out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = a[i] * b[i];
+	}
+
+	/*!
+	Transforms an array of points by an affine matrix.
+
+	@param m The transformation matrix.
+	@param in The points to transform.
+	@param out Receives the transformed points. May be the same as in.
+	@param count The number of points.
+	*/
+	inline void transformPoints(const AffineMatrix &m, const Vector3 *in, Vector3 *out, size_t count)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z;
+			vload3(lane, (const float *)(in + i), x, y, z);
+
+			auto ox = vfmadd(vset1(lane, m._11), x, vfmadd(vset1(lane, m._12), y, vfmadd(vset1(lane, m._13), z, vset1(lane, m._14))));
+			auto oy = vfmadd(vset1(lane, m._21), x, vfmadd(vset1(lane, m._22), y, vfmadd(vset1(lane, m._23), z, vset1(lane, m._24))));
+			auto oz = vfmadd(vset1(lane, m._31), x, vfmadd(vset1(lane, m._32), y, vfmadd(vset1(lane, m._33), z, vset1(lane, m._34))));
+
+			vstore3((float *)(out + i), ox, oy, oz);
+		});
+	}
+
+	/*!
+	Transforms an array of direction vectors by an affine matrix. The
+	translation of the matrix is ignored.
+
+	@param m The transformation matrix.
+	@param in The vectors to transform.
+	@param out Receives the transformed vectors. May be the same as in.
+	@param count The number of vectors.
+	*/
+	inline void transformVectors(const AffineMatrix &m, const Vector3 *in, Vector3 *out, size_t count)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z;
+			vload3(lane, (const float *)(in + i), x, y, z);
+
+			auto ox = vfmadd(vset1(lane, m._11), x, vfmadd(vset1(lane, m._12), y, vmul(vset1(lane, m._13), z)));
+			auto oy = vfmadd(vset1(lane, m._21), x, vfmadd(vset1(lane, m._22), y, vmul(vset1(lane, m._23), z)));
+			auto oz = vfmadd(vset1(lane, m._31), x, vfmadd(vset1(lane, m._32), y, vmul(vset1(lane, m._33), z)));
+
+			vstore3((float *)(out + i), ox, oy, oz);
+		});
+	}
+
+	/*!
+	Multiplies pairs of affine matrices, computing a[i] * b[i] for every
+	element.
+
+	@param a The left hand matrices.
+	@param b The right hand matrices.
+	@param out Receives the products. May be the same as a or b.
+	@param count The number of matrices in each array.
+	*/
+	inline void multiplyMany(const AffineMatrix *a, const AffineMatrix *b, AffineMatrix *out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			out[i] = a[i] * b[i];
+	}
+}
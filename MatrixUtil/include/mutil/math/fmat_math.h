@@ -10,6 +10,7 @@ Contains methods for performing operations on floating-point matrices.
 
 #include "../mat/mat.h"
 #include "fmat_math_defs.h"
+#include "../simd/simd.h"
 
 namespace mutil
 {
@@ -207,13 +208,15 @@ namespace mutil
 	// Matrix4 operations
 
 	/*!
-	Calculates the determinant of a 4x4 matrix.
+	Calculates the determinant of a 4x4 matrix with scalar arithmetic in every
+	build. Unlike determinant in a build using SIMD instructions, this may be
+	used in constant expressions.
 
 	@param mat4 The matrix to find the determinant of.
 
 	@return The determinant.
 	*/
-	constexpr float determinant(const Matrix4 &mat4)
+	constexpr float determinantScalar(const Matrix4 &mat4)
 	{
 		return __determinant4x4(
 			mat4._11, mat4._12, mat4._13, mat4._14,
@@ -274,6 +277,103 @@ namespace mutil
 		);
 	}
 
+	/*!
+	Calculates the inverse of a 4x4 matrix with scalar arithmetic in every
+	build, the reference for the SIMD version of inverse.
+
+	@param mat4 The matrix to invert.
+
+	@return The inverse of the matrix. There is undefined behavior if the matrix does not have an inverse.
+	*/
+	constexpr Matrix4 inverseScalar(const Matrix4 &mat4)
+	{
+		return adjugate(mat4) * (1.0f / determinantScalar(mat4));
+	}
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+	namespace __1
+	{
+		// The vector inverse splits the matrix into four 2x2 blocks, each held in
+		// one register as (m00, m01, m10, m11), and inverts it blockwise:
+		//
+		//     M = | A B |    M^-1 = 1/|M| | X# Y# |#
+		//         | C D |                 | Z# W# |
+		//
+		// where # is the 2x2 adjugate. Columns are loaded in place of rows, which
+		// inverts the transpose and so yields the columns of the inverse.
+
+		// A * B
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL mat2Mul(vfloat4 a, vfloat4 b)
+		{
+			return vfmadd(a, vshuffle<0, 3, 0, 3>(b, b), vmul(vshuffle<1, 0, 3, 2>(a, a), vshuffle<2, 1, 2, 1>(b, b)));
+		}
+
+		// A# * B
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL mat2AdjMul(vfloat4 a, vfloat4 b)
+		{
+			return vfnmadd(vshuffle<1, 1, 2, 2>(a, a), vshuffle<2, 3, 0, 1>(b, b), vmul(vshuffle<3, 3, 0, 0>(a, a), b));
+		}
+
+		// A * B#
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL mat2MulAdj(vfloat4 a, vfloat4 b)
+		{
+			return vfnmadd(vshuffle<1, 0, 3, 2>(a, a), vshuffle<2, 1, 2, 1>(b, b), vmul(a, vshuffle<3, 0, 3, 0>(b, b)));
+		}
+
+		// Sum of all four lanes, broadcast to every lane.
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL hsum4(vfloat4 a)
+		{
+			a = vadd(a, vshuffle<1, 0, 3, 2>(a, a));
+			return vadd(a, vshuffle<2, 3, 0, 1>(a, a));
+		}
+
+		// The blocks of mat4 and the determinants (|A|, |B|, |C|, |D|).
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL mat4Blocks(const Matrix4 &mat4, vfloat4 &a, vfloat4 &b, vfloat4 &c, vfloat4 &d, vfloat4 &dets)
+		{
+			const vfloat4 c0 = vloadu(vfloat4(), mat4.mat);
+			const vfloat4 c1 = vloadu(vfloat4(), mat4.mat + 4);
+			const vfloat4 c2 = vloadu(vfloat4(), mat4.mat + 8);
+			const vfloat4 c3 = vloadu(vfloat4(), mat4.mat + 12);
+
+			a = vshuffle<0, 1, 0, 1>(c0, c1);
+			b = vshuffle<2, 3, 2, 3>(c0, c1);
+			c = vshuffle<0, 1, 0, 1>(c2, c3);
+			d = vshuffle<2, 3, 2, 3>(c2, c3);
+
+			dets = vfnmadd(vshuffle<1, 3, 1, 3>(c0, c2), vshuffle<0, 2, 0, 2>(c1, c3),
+				vmul(vshuffle<0, 2, 0, 2>(c0, c2), vshuffle<1, 3, 1, 3>(c1, c3)));
+		}
+	}
+#endif
+
+	/*!
+	Calculates the determinant of a 4x4 matrix.
+
+	@param mat4 The matrix to find the determinant of.
+
+	@return The determinant.
+	*/
+	MUTIL_SIMD_CONSTEXPR float MUTIL_VECTORCALL determinant(const Matrix4 &mat4)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		vfloat4 a, b, c, d, dets;
+		mat4Blocks(mat4, a, b, c, d, dets);
+
+		// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		const vfloat4 ab = mat2AdjMul(a, b);
+		const vfloat4 dc = mat2AdjMul(d, c);
+		const vfloat4 tr = hsum4(vmul(ab, vshuffle<0, 2, 1, 3>(dc, dc)));
+
+		// lane 0 is |A||D| + |B||C|
+		const vfloat4 ad_bc = vmul(dets, vshuffle<3, 2, 1, 0>(dets, dets));
+		return vfirst(vsub(vadd(ad_bc, vshuffle<1, 1, 1, 1>(ad_bc, ad_bc)), tr));
+#else
+		return determinantScalar(mat4);
+#endif
+	}
+
 	/*!
 	Calculates the inverse of a 4x4 matrix.
 
@@ -281,9 +381,100 @@ namespace mutil
 
 	@return The inverse of the matrix. There is undefined behavior if the matrix does not have an inverse.
 	*/
-	constexpr Matrix4 inverse(const Matrix4 &mat4)
+	MUTIL_SIMD_CONSTEXPR Matrix4 MUTIL_VECTORCALL inverse(const Matrix4 &mat4)
 	{
-		return adjugate(mat4) * (1.0f / determinant(mat4));
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		vfloat4 a, b, c, d, dets;
+		mat4Blocks(mat4, a, b, c, d, dets);
+
+		const vfloat4 detA = vshuffle<0, 0, 0, 0>(dets, dets);
+		const vfloat4 detB = vshuffle<1, 1, 1, 1>(dets, dets);
+		const vfloat4 detC = vshuffle<2, 2, 2, 2>(dets, dets);
+		const vfloat4 detD = vshuffle<3, 3, 3, 3>(dets, dets);
+
+		const vfloat4 dc = mat2AdjMul(d, c);
+		const vfloat4 ab = mat2AdjMul(a, b);
+
+		// X# = |D|A - B(D#C), W# = |A|D - C(A#B)
+		vfloat4 x = vsub(vmul(detD, a), mat2Mul(b, dc));
+		vfloat4 w = vsub(vmul(detA, d), mat2Mul(c, ab));
+
+		// Y# = |B|C - D(A#B)#, Z# = |C|B - A(D#C)#
+		vfloat4 y = vsub(vmul(detB, c), mat2MulAdj(d, ab));
+		vfloat4 z = vsub(vmul(detC, b), mat2MulAdj(a, dc));
+
+		// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		const vfloat4 tr = hsum4(vmul(ab, vshuffle<0, 2, 1, 3>(dc, dc)));
+		const vfloat4 det = vsub(vfmadd(detA, detD, vmul(detB, detC)), tr);
+
+		// the signs undo the adjugate of each block
+		const vfloat4 rdet = vdiv(vsetr(vfloat4(), 1.0f, -1.0f, -1.0f, 1.0f), det);
+		x = vmul(x, rdet);
+		y = vmul(y, rdet);
+		z = vmul(z, rdet);
+		w = vmul(w, rdet);
+
+		Matrix4 result;
+		vstoreu(result.mat, vshuffle<3, 1, 3, 1>(x, y));
+		vstoreu(result.mat + 4, vshuffle<2, 0, 2, 0>(x, y));
+		vstoreu(result.mat + 8, vshuffle<3, 1, 3, 1>(z, w));
+		vstoreu(result.mat + 12, vshuffle<2, 0, 2, 0>(z, w));
+		return result;
+#else
+		return inverseScalar(mat4);
+#endif
+	}
+
+	/*!
+	Calculates the inverse of an affine 4x4 matrix, one whose last row is
+	(0, 0, 0, 1). This is considerably cheaper than inverse.
+
+	@param mat4 The matrix to invert.
+
+	@return The inverse of the matrix. There is undefined behavior if the matrix is not affine or does not have an inverse.
+	*/
+	constexpr Matrix4 inverseAffine(const Matrix4 &mat4)
+	{
+		// rows of the inverse of the upper 3x3 are the cross products of its columns
+		const float r11 = mat4._22 * mat4._33 - mat4._32 * mat4._23;
+		const float r12 = mat4._32 * mat4._13 - mat4._12 * mat4._33;
+		const float r13 = mat4._12 * mat4._23 - mat4._22 * mat4._13;
+		const float r21 = mat4._23 * mat4._31 - mat4._33 * mat4._21;
+		const float r22 = mat4._33 * mat4._11 - mat4._13 * mat4._31;
+		const float r23 = mat4._13 * mat4._21 - mat4._23 * mat4._11;
+		const float r31 = mat4._21 * mat4._32 - mat4._31 * mat4._22;
+		const float r32 = mat4._31 * mat4._12 - mat4._11 * mat4._32;
+		const float r33 = mat4._11 * mat4._22 - mat4._21 * mat4._12;
+
+		const float invDet = 1.0f / (mat4._11 * r11 + mat4._21 * r12 + mat4._31 * r13);
+
+		return Matrix4(
+			r11 * invDet, r12 * invDet, r13 * invDet, -(r11 * mat4._14 + r12 * mat4._24 + r13 * mat4._34) * invDet,
+			r21 * invDet, r22 * invDet, r23 * invDet, -(r21 * mat4._14 + r22 * mat4._24 + r23 * mat4._34) * invDet,
+			r31 * invDet, r32 * invDet, r33 * invDet, -(r31 * mat4._14 + r32 * mat4._24 + r33 * mat4._34) * invDet,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+
+	/*!
+	Calculates the inverse of a 4x4 matrix made of only a rotation and a
+	translation. The rotation is transposed and the translation is rotated back
+	and negated, so this is the cheapest of the inverse functions.
+
+	@param mat4 The matrix to invert.
+
+	@return The inverse of the matrix. The result is meaningless if the upper 3x3 of the matrix is not orthonormal or the last row is not (0, 0, 0, 1).
+	*/
+	constexpr Matrix4 inverseOrthonormal(const Matrix4 &mat4)
+	{
+		return Matrix4(
+			mat4._11, mat4._21, mat4._31, -(mat4._11 * mat4._14 + mat4._21 * mat4._24 + mat4._31 * mat4._34),
+			mat4._12, mat4._22, mat4._32, -(mat4._12 * mat4._14 + mat4._22 * mat4._24 + mat4._32 * mat4._34),
+			mat4._13, mat4._23, mat4._33, -(mat4._13 * mat4._14 + mat4._23 * mat4._24 + mat4._33 * mat4._34),
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
 	}
 
 	constexpr Matrix4 clamp(const Matrix4 &val, float min, float max)
@@ -302,9 +493,104 @@ namespace mutil
 		return result;
 	}
 
-	constexpr float Matrix4::determinant() const { return mutil::determinant(*this); }
+	MUTIL_SIMD_CONSTEXPR float Matrix4::determinant() const { return mutil::determinant(*this); }
 	constexpr Matrix4 Matrix4::transpose() const { return mutil::transpose(*this); }
-	constexpr Matrix4 Matrix4::inverse() const { return mutil::inverse(*this); };
+	MUTIL_SIMD_CONSTEXPR Matrix4 Matrix4::inverse() const { return mutil::inverse(*this); };
+
+	// AffineMatrix operations
+
+	/*!
+	Calculates the determinant of an affine matrix, which is that of its upper
+	3x3.
+
+	@param mat The matrix to find the determinant of.
+
+	@return The determinant.
+	*/
+	constexpr float determinant(const AffineMatrix &mat)
+	{
+		return __determinant3x3(
+			mat._11, mat._12, mat._13,
+			mat._21, mat._22, mat._23,
+			mat._31, mat._32, mat._33
+		);
+	}
+
+	/*!
+	Calculates the inverse of an affine matrix. Like inverseAffine, the upper
+	3x3 is inverted and the translation is transformed back by it, so the cost
+	is well below that of inverting a Matrix4.
+
+	@param mat The matrix to invert.
+
+	@return The inverse of the matrix. There is undefined behavior if the matrix does not have an inverse.
+	*/
+	inline AffineMatrix MUTIL_VECTORCALL inverse(const AffineMatrix &mat)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		// x, y and z hold the rows of mat, lane j being column j. Rotating the
+		// lanes of each row lines up columns j + 1 and j + 2 with column j, so a
+		// single expression per component computes all three cross products
+		// cross(c[j + 1], c[j + 2]), the rows of the adjugate. Lane j of ix, iy
+		// and iz is then row j of the adjugate, making them its columns.
+		vfloat4 x, y, z;
+		vload3(vfloat4(), mat.mat, x, y, z);
+
+		const vfloat4 x1 = vshuffle<1, 2, 0, 3>(x, x), x2 = vshuffle<2, 0, 1, 3>(x, x);
+		const vfloat4 y1 = vshuffle<1, 2, 0, 3>(y, y), y2 = vshuffle<2, 0, 1, 3>(y, y);
+		const vfloat4 z1 = vshuffle<1, 2, 0, 3>(z, z), z2 = vshuffle<2, 0, 1, 3>(z, z);
+
+		vfloat4 ix = vfnmadd(z1, y2, vmul(y1, z2));
+		vfloat4 iy = vfnmadd(x1, z2, vmul(z1, x2));
+		vfloat4 iz = vfnmadd(y1, x2, vmul(x1, y2));
+
+		// lane 0 is column 0 dotted with row 0 of the adjugate
+		const vfloat4 det = vfmadd(x, ix, vfmadd(y, iy, vmul(z, iz)));
+		const vfloat4 rdet = vdiv(vset1(vfloat4(), 1.0f), vshuffle<0, 0, 0, 0>(det, det));
+		ix = vmul(ix, rdet);
+		iy = vmul(iy, rdet);
+		iz = vmul(iz, rdet);
+
+		// the translation, lane 3 of the rows, is transformed back and negated
+		vfloat4 t = vmul(ix, vshuffle<3, 3, 3, 3>(x, x));
+		t = vfmadd(iy, vshuffle<3, 3, 3, 3>(y, y), t);
+		t = vfmadd(iz, vshuffle<3, 3, 3, 3>(z, z), t);
+		t = vsub(vset1(vfloat4(), 0.0f), t);
+
+		AffineMatrix result;
+		vstore3x4(result.mat, ix, iy, iz, t);
+		return result;
+#else
+		// The formulas of inverseAffine, written in the order the result is
+		// stored so the compiler can vectorize them without SSE4.1. The
+		// translation is transformed back by the columns of the inverse.
+		const float invDet = 1.0f / (
+			mat._11 * (mat._22 * mat._33 - mat._32 * mat._23) +
+			mat._21 * (mat._32 * mat._13 - mat._12 * mat._33) +
+			mat._31 * (mat._12 * mat._23 - mat._22 * mat._13));
+
+		AffineMatrix result;
+		result._11 = (mat._22 * mat._33 - mat._32 * mat._23) * invDet;
+		result._21 = (mat._23 * mat._31 - mat._33 * mat._21) * invDet;
+		result._31 = (mat._21 * mat._32 - mat._31 * mat._22) * invDet;
+		result._12 = (mat._32 * mat._13 - mat._12 * mat._33) * invDet;
+		result._22 = (mat._33 * mat._11 - mat._13 * mat._31) * invDet;
+		result._32 = (mat._31 * mat._12 - mat._11 * mat._32) * invDet;
+		result._13 = (mat._12 * mat._23 - mat._22 * mat._13) * invDet;
+		result._23 = (mat._13 * mat._21 - mat._23 * mat._11) * invDet;
+		result._33 = (mat._11 * mat._22 - mat._21 * mat._12) * invDet;
+
+		result._14 = -(result._11 * mat._14 + result._12 * mat._24 + result._13 * mat._34);
+		result._24 = -(result._21 * mat._14 + result._22 * mat._24 + result._23 * mat._34);
+		result._34 = -(result._31 * mat._14 + result._32 * mat._24 + result._33 * mat._34);
+		return result;
+#endif
+	}
+
+	constexpr float AffineMatrix::determinant() const { return mutil::determinant(*this); }
+	inline AffineMatrix AffineMatrix::inverse() const { return mutil::inverse(*this); }
 }
 
 #endif
\ No newline at end of file
@@ -6,4 +6,5 @@
 #include "i_math.h"
 #include "fmat_math.h"
 #include "fmat_transform.h"
+#include "fmat_batch.h"
 #include "noise.h"
@@ -8,9 +8,32 @@
 
 namespace mutil
 {
+	/*!
+	Distance metrics for cellular noise.
+	*/
+	enum DistanceMetric
+	{
+		DistanceMetric_Euclidean,	// sqrt(dx^2 + dy^2 + dz^2)
+		DistanceMetric_Manhattan,	// |dx| + |dy| + |dz|
+		DistanceMetric_Chebyshev	// max(|dx|, |dy|, |dz|)
+	};
+
+	/*!
+	Values cellular noise can compute from the distances to the nearest (F1) and
+	second nearest (F2) feature points.
+	*/
+	enum WorleyOutput
+	{
+		WorleyOutput_F1,
+		WorleyOutput_F2,
+		WorleyOutput_F2MinusF1
+	};
+
 	namespace __1
 	{
-		inline Vector2 randGradient2(int ix, int iy)
+		// The hash of a lattice point choosing the direction of its gradient, which
+		// is at an angle of 2 * pi * gradientHash / 2^32
+		inline unsigned gradientHash(int ix, int iy)
 		{
 			const unsigned w = 8 * sizeof(unsigned);
 			const unsigned s = w / 2;
@@ -23,18 +46,49 @@ namespace mutil
 			a ^= b << s | b >> (w - s);
 
 			a *= 2048419325U;
+			return a;
+		}
 
-			float rand = a * (MUTIL_PI / ~(~0u >> 1));
+		inline Vector2 randGradient2(int ix, int iy)
+		{
+			float rand = gradientHash(ix, iy) * (MUTIL_PI / ~(~0u >> 1));
 			return Vector2(mutil::cos(rand), mutil::sin(rand));
 		}
 
-		inline float dotGradient2(int ix, int iy, const Vector2 &pos)
+		// "Classic" Perlin noise with the gradients given by gradient(ix, iy)
+		template <typename F>
+		inline float perlin2(const Vector2 &pos, F gradient)
 		{
-			Vector2 delta = pos - Vector2((float)ix, (float)iy);
-			return dot(randGradient2(ix, iy), delta);
+			int x0 = (int)mutil::floor(pos.x);
+			int x1 = x0 + 1;
+			int y0 = (int)mutil::floor(pos.y);
+			int y1 = y0 + 1;
+
+			float sx = clamp(pos.x - x0, 0.0f, 1.0f);
+			float sy = clamp(pos.y - y0, 0.0f, 1.0f);
+
+			// written out, as dot() would move both vectors through memory into
+			// SSE registers
+			auto dotGradient = [&](int ix, int iy) {
+				const Vector2 g = gradient(ix, iy);
+				return g.x * (pos.x - (float)ix) + g.y * (pos.y - (float)iy);
+			};
+
+			float n0, n1, ix0, ix1;
+
+			n0 = dotGradient(x0, y0);
+			n1 = dotGradient(x1, y0);
+			ix0 = smootherstep(n0, n1, sx);
+
+			n0 = dotGradient(x0, y1);
+			n1 = dotGradient(x1, y1);
+			ix1 = smootherstep(n0, n1, sx);
+
+			return smootherstep(ix0, ix1, sy);
 		}
 
-		inline uint8_t hash(unsigned i)
+		// Ken Perlin's reference permutation of [0, 255]
+		inline const uint8_t *permutation()
 		{
 			static const uint8_t kPerm[] = {
 				151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
@@ -56,7 +110,12 @@ namespace mutil
 				78, 66, 215, 61, 156, 180,
 			};
 
-			return kPerm[(uint8_t)i];
+			return kPerm;
+		}
+
+		inline uint8_t hash(const uint8_t *perm, unsigned i)
+		{
+			return perm[(uint8_t)i];
 		}
 
 		constexpr float grad(int hash, float x, float y)
@@ -66,144 +125,593 @@ namespace mutil
 			float v = h < 4 ? y : x;
 			return ((h & 1) ? -u : u) + ((h & 2) ? -2.0f * v : 2.0f * v);
 		}
-	}
 
-	// "Classic" Perlin noise, [-1, 1]
-	inline float pnoise(const Vector2 &pos)
-	{
-		using namespace __1;
+		// One of the 12 edge directions of a cube, as in Ken Perlin's improved noise
+		constexpr float grad(int hash, float x, float y, float z)
+		{
+			int h = hash & 0xf;
+			float u = h < 8 ? x : y;
+			float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+			return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+		}
 
-		int x0 = (int)mutil::floor(pos.x);
-		int x1 = x0 + 1;
-		int y0 = (int)mutil::floor(pos.y);
-		int y1 = y0 + 1;
+		// One of the 32 edge directions of a 4D hypercube. Bits 3 and 4 choose the
+		// component which is zero and bits 0 to 2 the signs of the others.
+		constexpr float grad(int hash, float x, float y, float z, float w)
+		{
+			int h = hash & 0x1f;
+			float a = h < 8 ? y : x;
+			float b = h < 16 ? z : y;
+			float c = h < 24 ? w : z;
+			return ((h & 4) ? -a : a) + ((h & 2) ? -b : b) + ((h & 1) ? -c : c);
+		}
 
-		float sx = clamp(pos.x - x0, 0.0f, 1.0f);
-		float sy = clamp(pos.y - y0, 0.0f, 1.0f);
+		// Mixes the bits of x. The "lowbias32" hash by Chris Wellons.
+		constexpr uint32_t hash32(uint32_t x)
+		{
+			x ^= x >> 16;
+			x *= 0x7feb352dU;
+			x ^= x >> 15;
+			x *= 0x846ca68bU;
+			x ^= x >> 16;
+			return x;
+		}
 
-		float n0, n1, ix0, ix1;
+		// Converts the high 24 bits of h to a float in [0, 1)
+		constexpr float unitFloat(uint32_t h)
+		{
+			return (float)(h >> 8) * (1.0f / 16777216.0f);
+		}
 
-		n0 = dotGradient2(x0, y0, pos);
-		n1 = dotGradient2(x1, y0, pos);
-		ix0 = smootherstep(n0, n1, sx);
+		// The feature point of a cell for cellular noise, relative to its corner
+		inline Vector2 cellPoint(const IntVector2 &cell)
+		{
+			const uint32_t h = hash32((uint32_t)cell.x + hash32((uint32_t)cell.y));
+			return Vector2(unitFloat(h), unitFloat(hash32(h)));
+		}
 
-		n0 = dotGradient2(x0, y1, pos);
-		n1 = dotGradient2(x1, y1, pos);
-		ix1 = smootherstep(n0, n1, sx);
+		inline Vector3 cellPoint(const IntVector3 &cell)
+		{
+			const uint32_t h = hash32((uint32_t)cell.x + hash32((uint32_t)cell.y + hash32((uint32_t)cell.z)));
+			const uint32_t h2 = hash32(h);
+			return Vector3(unitFloat(h), unitFloat(h2), unitFloat(hash32(h2)));
+		}
 
-		return smootherstep(ix0, ix1, sy);
-	}
+		// Euclidean distances are kept squared until the end
+		constexpr float worleyDistance(DistanceMetric metric, float dx, float dy)
+		{
+			return metric == DistanceMetric_Manhattan ? mutil::abs(dx) + mutil::abs(dy) :
+				metric == DistanceMetric_Chebyshev ? mutil::max(mutil::abs(dx), mutil::abs(dy)) :
+				dx * dx + dy * dy;
+		}
 
-	// Perlin noise with octaves, varying result interval
-	inline float pnoise(const Vector2 &pos, float persistence, int octaves)
-	{
-		float total = 0.0f;
-		float amplitude = 1.0f;
-		float frequency = 1.0f;
+		constexpr float worleyDistance(DistanceMetric metric, float dx, float dy, float dz)
+		{
+			return metric == DistanceMetric_Manhattan ? mutil::abs(dx) + mutil::abs(dy) + mutil::abs(dz) :
+				metric == DistanceMetric_Chebyshev ? mutil::max(mutil::max(mutil::abs(dx), mutil::abs(dy)), mutil::abs(dz)) :
+				dx * dx + dy * dy + dz * dz;
+		}
 
-		for (int i = 0; i < octaves; i++)
+		inline float worleyOutput(DistanceMetric metric, WorleyOutput output, float f1, float f2)
 		{
-			total += pnoise(pos * frequency) * amplitude;
-			frequency *= 2.0f;
-			amplitude *= persistence;
+			if (metric == DistanceMetric_Euclidean)
+			{
+				f1 = sqrtf(f1);
+				f2 = sqrtf(f2);
+			}
+
+			return output == WorleyOutput_F1 ? f1 : output == WorleyOutput_F2 ? f2 : f2 - f1;
 		}
 
-		return total;
+		// Sums octaves of noise, each with twice the frequency of the last
+		template <typename T, typename F>
+		inline float fractal(const T &pos, float persistence, int octaves, F noise)
+		{
+			float total = 0.0f;
+			float amplitude = 1.0f;
+			float frequency = 1.0f;
+
+			for (int i = 0; i < octaves; i++)
+			{
+				total += noise(pos * frequency) * amplitude;
+				frequency *= 2.0f;
+				amplitude *= persistence;
+			}
+
+			return total;
+		}
 	}
 
-	// Simplex noise, [-1, 1]
-	inline float snoise(const Vector2 &pos)
+	/*!
+	A table of 256 unit gradients for 2D Perlin noise, indexed by the hash of a
+	lattice point, so finding a gradient takes a lookup instead of a sine and a
+	cosine. The components are kept in separate arrays, which lane-parallel code
+	can gather from with the indices of several lattice points at once.
+	*/
+	class GradientTable
 	{
-		// Based on https://github.com/SRombauts/SimplexNoise
+	public:
+		/*!
+		Creates the table. The gradients point in 256 evenly spaced directions.
+
+		@param seed Shuffles the directions, giving different noise for each
+		seed. With 0, the direction for each hash is the one the trigonometric
+		gradients of pnoise(const Vector2 &) use, rounded to the nearest of the
+		256, so the noise is within 0.01 of pnoise.
+		*/
+		explicit GradientTable(uint32_t seed = 0)
+		{
+			uint8_t order[256];
+			for (size_t i = 0; i < 256; i++)
+				order[i] = (uint8_t)i;
+
+			if (seed)
+			{
+				for (uint32_t i = 255; i > 0; i--)
+				{
+					const uint32_t j = __1::hash32(seed ^ __1::hash32(i)) % (i + 1);
+					const uint8_t t = order[i];
+					order[i] = order[j];
+					order[j] = t;
+				}
+			}
+
+			for (size_t i = 0; i < 256; i++)
+			{
+				const float angle = (float)order[i] * (MUTIL_PI / 128.0f);
+				_x[i] = mutil::cos(angle);
+				_y[i] = mutil::sin(angle);
+			}
+		}
 
-		using namespace __1;
+		/*!
+		@return The index of the gradient of the lattice point (ix, iy).
+		*/
+		static uint8_t index(int ix, int iy)
+		{
+			// rounds the angle to the nearest entry, wrapping 2 * pi to 0
+			return (uint8_t)((uint32_t)(__1::gradientHash(ix, iy) + (1u << 23)) >> 24);
+		}
 
-		constexpr float F2 = 0.366025403f; // (sqrt(3) - 1) / 2
-		constexpr float G2 = 0.211324865f; // (3 - sqrt(3)) / 6
+		/*!
+		@return The gradient of the lattice point (ix, iy).
+		*/
+		Vector2 gradient(int ix, int iy) const
+		{
+			const uint8_t i = index(ix, iy);
+			return Vector2(_x[i], _y[i]);
+		}
 
-		float n0, n1, n2;
+		/*!
+		@return The x components of the gradients, indexed by index().
+		*/
+		const float *x() const { return _x; }
 
-		const float s = (pos.x + pos.y) * F2;
-		const float xs = pos.x + s;
-		const float ys = pos.y + s;
-		const int i = (int)mutil::floor(xs);
-		const int j = (int)mutil::floor(ys);
+		/*!
+		@return The y components of the gradients, indexed by index().
+		*/
+		const float *y() const { return _y; }
 
-		const float t = (i + j) * G2;
-		const float X0 = i - t;
-		const float Y0 = j - t;
-		const float x0 = pos.x - X0;
-		const float y0 = pos.y - Y0;
+	private:
+		float _x[256];
+		float _y[256];
+	};
 
-		int32_t i1, j1;
-		if (x0 > y0)
+	namespace __1
+	{
+		// The noise functions computed with the permutation perm, which must hold
+		// 256 entries
+		inline float simplex2(const Vector2 &pos, const uint8_t *perm)
 		{
-			i1 = 1;
-			j1 = 0;
+			// Based on https://github.com/SRombauts/SimplexNoise
+
+			constexpr float F2 = 0.366025403f; // (sqrt(3) - 1) / 2
+			constexpr float G2 = 0.211324865f; // (3 - sqrt(3)) / 6
+
+			float n0, n1, n2;
+
+			const float s = (pos.x + pos.y) * F2;
+			const float xs = pos.x + s;
+			const float ys = pos.y + s;
+			const int i = (int)mutil::floor(xs);
+			const int j = (int)mutil::floor(ys);
+
+			const float t = (i + j) * G2;
+			const float X0 = i - t;
+			const float Y0 = j - t;
+			const float x0 = pos.x - X0;
+			const float y0 = pos.y - Y0;
+
+			int32_t i1, j1;
+			if (x0 > y0)
+			{
+				i1 = 1;
+				j1 = 0;
+			}
+			else
+			{
+				i1 = 0;
+				j1 = 1;
+			}
+
+			const float x1 = x0 - i1 + G2;
+			const float y1 = y0 - j1 + G2;
+			const float x2 = x0 - 1.0f + 2.0f * G2;
+			const float y2 = y0 - 1.0f + 2.0f * G2;
+
+			const int gi0 = hash(perm, i + hash(perm, j));
+			const int gi1 = hash(perm, i + i1 + hash(perm, j + j1));
+			const int gi2 = hash(perm, i + 1 + hash(perm, j + 1));
+
+			// Contribution of first corner
+			float t0 = 0.5f - x0*x0 - y0*y0;
+			if (t0 < 0.0f)
+				n0 = 0.0f;
+			else
+			{
+				t0 *= t0;
+				n0 = t0 * t0 * grad(gi0, x0, y0);
+			}
+
+			// Contribution of second corner
+			float t1 = 0.5f - x1*x1 - y1*y1;
+			if (t1 < 0.0f)
+				n1 = 0.0f;
+			else
+			{
+				t1 *= t1;
+				n1 = t1 * t1 * grad(gi1, x1, y1);
+			}
+
+			// Contribution of third corner
+			float t2 = 0.5f - x2*x2 - y2*y2;
+			if (t2 < 0.0f)
+				n2 = 0.0f;
+			else
+			{
+				t2 *= t2;
+				n2 = t2 * t2 * grad(gi2, x2, y2);
+			}
+
+			// Final noise value
+			return 45.23065f * (n0 + n1 + n2);
 		}
-		else
+
+		inline float perlin3(const Vector3 &pos, const uint8_t *perm)
 		{
-			i1 = 0;
-			j1 = 1;
+			// Based on https://mrl.cs.nyu.edu/~perlin/noise/
+
+			const float fx = mutil::floor(pos.x);
+			const float fy = mutil::floor(pos.y);
+			const float fz = mutil::floor(pos.z);
+			const int X = (int)fx;
+			const int Y = (int)fy;
+			const int Z = (int)fz;
+
+			const float x = pos.x - fx;
+			const float y = pos.y - fy;
+			const float z = pos.z - fz;
+
+			const int a = hash(perm, X);
+			const int b = hash(perm, X + 1);
+			const int aa = hash(perm, a + Y);
+			const int ab = hash(perm, a + Y + 1);
+			const int ba = hash(perm, b + Y);
+			const int bb = hash(perm, b + Y + 1);
+
+			const float x00 = smootherstep(grad(hash(perm, aa + Z), x, y, z), grad(hash(perm, ba + Z), x - 1.0f, y, z), x);
+			const float x10 = smootherstep(grad(hash(perm, ab + Z), x, y - 1.0f, z), grad(hash(perm, bb + Z), x - 1.0f, y - 1.0f, z), x);
+			const float x01 = smootherstep(grad(hash(perm, aa + Z + 1), x, y, z - 1.0f), grad(hash(perm, ba + Z + 1), x - 1.0f, y, z - 1.0f), x);
+			const float x11 = smootherstep(grad(hash(perm, ab + Z + 1), x, y - 1.0f, z - 1.0f), grad(hash(perm, bb + Z + 1), x - 1.0f, y - 1.0f, z - 1.0f), x);
+
+			return smootherstep(smootherstep(x00, x10, y), smootherstep(x01, x11, y), z);
 		}
 
-		const float x1 = x0 - i1 + G2;
-		const float y1 = y0 - j1 + G2;
-		const float x2 = x0 - 1.0f + 2.0f * G2;
-		const float y2 = y0 - 1.0f + 2.0f * G2;
+		inline float simplex3(const Vector3 &pos, const uint8_t *perm)
+		{
+			// Based on https://github.com/SRombauts/SimplexNoise
+
+			constexpr float F3 = 1.0f / 3.0f;
+			constexpr float G3 = 1.0f / 6.0f;
+
+			const float s = (pos.x + pos.y + pos.z) * F3;
+			const int i = (int)mutil::floor(pos.x + s);
+			const int j = (int)mutil::floor(pos.y + s);
+			const int k = (int)mutil::floor(pos.z + s);
+
+			const float t = (i + j + k) * G3;
+			const float x0 = pos.x - (i - t);
+			const float y0 = pos.y - (j - t);
+			const float z0 = pos.z - (k - t);
+
+			// Offsets of the second and third corners, found from the order of the
+			// coordinates within the cell
+			int i1, j1, k1, i2, j2, k2;
+			if (x0 >= y0)
+			{
+				if (y0 >= z0)
+				{
+					i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+				}
+				else if (x0 >= z0)
+				{
+					i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1;
+				}
+				else
+				{
+					i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1;
+				}
+			}
+			else
+			{
+				if (y0 < z0)
+				{
+					i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1;
+				}
+				else if (x0 < z0)
+				{
+					i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1;
+				}
+				else
+				{
+					i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+				}
+			}
+
+			const float x1 = x0 - i1 + G3;
+			const float y1 = y0 - j1 + G3;
+			const float z1 = z0 - k1 + G3;
+			const float x2 = x0 - i2 + 2.0f * G3;
+			const float y2 = y0 - j2 + 2.0f * G3;
+			const float z2 = z0 - k2 + 2.0f * G3;
+			const float x3 = x0 - 1.0f + 3.0f * G3;
+			const float y3 = y0 - 1.0f + 3.0f * G3;
+			const float z3 = z0 - 1.0f + 3.0f * G3;
+
+			const int gi0 = hash(perm, i + hash(perm, j + hash(perm, k)));
+			const int gi1 = hash(perm, i + i1 + hash(perm, j + j1 + hash(perm, k + k1)));
+			const int gi2 = hash(perm, i + i2 + hash(perm, j + j2 + hash(perm, k + k2)));
+			const int gi3 = hash(perm, i + 1 + hash(perm, j + 1 + hash(perm, k + 1)));
+
+			auto corner = [](int gi, float x, float y, float z) {
+				float t = 0.6f - x*x - y*y - z*z;
+				if (t < 0.0f)
+					return 0.0f;
+				t *= t;
+				return t * t * grad(gi, x, y, z);
+			};
 
-		const int gi0 = hash(i + hash(j));
-		const int gi1 = hash(i + i1 + hash(j + j1));
-		const int gi2 = hash(i + 1 + hash(j + 1));
+			const float n0 = corner(gi0, x0, y0, z0);
+			const float n1 = corner(gi1, x1, y1, z1);
+			const float n2 = corner(gi2, x2, y2, z2);
+			const float n3 = corner(gi3, x3, y3, z3);
 
-		// Contribution of first corner
-		float t0 = 0.5f - x0*x0 - y0*y0;
-		if (t0 < 0.0f)
-			n0 = 0.0f;
-		else
-		{
-			t0 *= t0;
-			n0 = t0 * t0 * grad(gi0, x0, y0);
+			return 32.0f * (n0 + n1 + n2 + n3);
 		}
 
-		// Contribution of second corner
-		float t1 = 0.5f - x1*x1 - y1*y1;
-		if (t1 < 0.0f)
-			n1 = 0.0f;
-		else
+		inline float simplex4(const Vector4 &pos, const uint8_t *perm)
 		{
-			t1 *= t1;
-			n1 = t1 * t1 * grad(gi1, x1, y1);
-		}
+			// Based on Stefan Gustavson's "Simplex noise demystified"
+
+			constexpr float F4 = 0.309016994f; // (sqrt(5) - 1) / 4
+			constexpr float G4 = 0.138196601f; // (5 - sqrt(5)) / 20
+
+			const float s = (pos.x + pos.y + pos.z + pos.w) * F4;
+			const int i = (int)mutil::floor(pos.x + s);
+			const int j = (int)mutil::floor(pos.y + s);
+			const int k = (int)mutil::floor(pos.z + s);
+			const int l = (int)mutil::floor(pos.w + s);
+
+			const float t = (i + j + k + l) * G4;
+			const float x0 = pos.x - (i - t);
+			const float y0 = pos.y - (j - t);
+			const float z0 = pos.z - (k - t);
+			const float w0 = pos.w - (l - t);
+
+			// The rank of each coordinate within the cell decides which corners are
+			// visited. The largest steps first.
+			int rankx = 0, ranky = 0, rankz = 0, rankw = 0;
+			if (x0 > y0) rankx++; else ranky++;
+			if (x0 > z0) rankx++; else rankz++;
+			if (x0 > w0) rankx++; else rankw++;
+			if (y0 > z0) ranky++; else rankz++;
+			if (y0 > w0) ranky++; else rankw++;
+			if (z0 > w0) rankz++; else rankw++;
+
+			const int i1 = rankx >= 3, j1 = ranky >= 3, k1 = rankz >= 3, l1 = rankw >= 3;
+			const int i2 = rankx >= 2, j2 = ranky >= 2, k2 = rankz >= 2, l2 = rankw >= 2;
+			const int i3 = rankx >= 1, j3 = ranky >= 1, k3 = rankz >= 1, l3 = rankw >= 1;
+
+			const int gi0 = hash(perm, i + hash(perm, j + hash(perm, k + hash(perm, l))));
+			const int gi1 = hash(perm, i + i1 + hash(perm, j + j1 + hash(perm, k + k1 + hash(perm, l + l1))));
+			const int gi2 = hash(perm, i + i2 + hash(perm, j + j2 + hash(perm, k + k2 + hash(perm, l + l2))));
+			const int gi3 = hash(perm, i + i3 + hash(perm, j + j3 + hash(perm, k + k3 + hash(perm, l + l3))));
+			const int gi4 = hash(perm, i + 1 + hash(perm, j + 1 + hash(perm, k + 1 + hash(perm, l + 1))));
+
+			auto corner = [](int gi, float x, float y, float z, float w) {
+				float t = 0.6f - x*x - y*y - z*z - w*w;
+				if (t < 0.0f)
+					return 0.0f;
+				t *= t;
+				return t * t * grad(gi, x, y, z, w);
+			};
 
-		// Contribution of third corner
-		float t2 = 0.5f - x2*x2 - y2*y2;
-		if (t2 < 0.0f)
-			n2 = 0.0f;
-		else
-		{
-			t2 *= t2;
-			n2 = t2 * t2 * grad(gi2, x2, y2);
+			const float n0 = corner(gi0, x0, y0, z0, w0);
+			const float n1 = corner(gi1, x0 - i1 + G4, y0 - j1 + G4, z0 - k1 + G4, w0 - l1 + G4);
+			const float n2 = corner(gi2, x0 - i2 + 2.0f * G4, y0 - j2 + 2.0f * G4, z0 - k2 + 2.0f * G4, w0 - l2 + 2.0f * G4);
+			const float n3 = corner(gi3, x0 - i3 + 3.0f * G4, y0 - j3 + 3.0f * G4, z0 - k3 + 3.0f * G4, w0 - l3 + 3.0f * G4);
+			const float n4 = corner(gi4, x0 - 1.0f + 4.0f * G4, y0 - 1.0f + 4.0f * G4, z0 - 1.0f + 4.0f * G4, w0 - 1.0f + 4.0f * G4);
+
+			return 27.0f * (n0 + n1 + n2 + n3 + n4);
 		}
+	}
+
+	// "Classic" Perlin noise, [-1, 1]
+	inline float pnoise(const Vector2 &pos)
+	{
+		return __1::perlin2(pos, &__1::randGradient2);
+	}
+
+	// Perlin noise with octaves, varying result interval
+	inline float pnoise(const Vector2 &pos, float persistence, int octaves)
+	{
+		return __1::fractal(pos, persistence, octaves, [](const Vector2 &p) { return pnoise(p); });
+	}
+
+	/*!
+	"Classic" Perlin noise taking its gradients from a table, which is faster
+	than computing them.
 
-		// Final noise value
-		return 45.23065f * (n0 + n1 + n2);
+	@param pos The position to compute noise at.
+	@param table The gradients.
+
+	@return The noise at pos, in [-1, 1].
+	*/
+	inline float pnoise(const Vector2 &pos, const GradientTable &table)
+	{
+		return __1::perlin2(pos, [&table](int ix, int iy) { return table.gradient(ix, iy); });
+	}
+
+	/*!
+	Perlin noise with octaves, taking its gradients from a table.
+
+	@param pos The position to compute noise at.
+	@param persistence The amplitude of each octave relative to the previous one.
+	@param octaves The number of octaves.
+	@param table The gradients.
+
+	@return The sum of the octaves.
+	*/
+	inline float pnoise(const Vector2 &pos, float persistence, int octaves, const GradientTable &table)
+	{
+		return __1::fractal(pos, persistence, octaves, [&table](const Vector2 &p) { return pnoise(p, table); });
+	}
+
+	// Simplex noise, [-1, 1]
+	inline float snoise(const Vector2 &pos)
+	{
+		return __1::simplex2(pos, __1::permutation());
 	}
 
 	// Simplex noise with octaves, varying result interval
 	inline float snoise(const Vector2 &pos, float persistence, int octaves)
 	{
-		float total = 0.0f;
-		float amplitude = 1.0f;
-		float frequency = 1.0f;
+		return __1::fractal(pos, persistence, octaves, [](const Vector2 &p) { return snoise(p); });
+	}
+
+	// Improved Perlin noise, approximately [-1, 1]
+	inline float pnoise(const Vector3 &pos)
+	{
+		return __1::perlin3(pos, __1::permutation());
+	}
+
+	// Improved Perlin noise with octaves, varying result interval
+	inline float pnoise(const Vector3 &pos, float persistence, int octaves)
+	{
+		return __1::fractal(pos, persistence, octaves, [](const Vector3 &p) { return pnoise(p); });
+	}
+
+	// Simplex noise, [-1, 1]
+	inline float snoise(const Vector3 &pos)
+	{
+		return __1::simplex3(pos, __1::permutation());
+	}
+
+	// Simplex noise with octaves, varying result interval
+	inline float snoise(const Vector3 &pos, float persistence, int octaves)
+	{
+		return __1::fractal(pos, persistence, octaves, [](const Vector3 &p) { return snoise(p); });
+	}
+
+	// Simplex noise, [-1, 1]
+	inline float snoise(const Vector4 &pos)
+	{
+		return __1::simplex4(pos, __1::permutation());
+	}
+
+	// Simplex noise with octaves, varying result interval
+	inline float snoise(const Vector4 &pos, float persistence, int octaves)
+	{
+		return __1::fractal(pos, persistence, octaves, [](const Vector4 &p) { return snoise(p); });
+	}
+
+	/*!
+	Cellular (Worley) noise. Each cell of the integer lattice holds one feature
+	point, and the result is computed from the distances between pos and the
+	nearest two. Only the 3 x 3 cells around pos are searched, so in rare cases
+	where the feature points nearby are far into their cells a closer one can be
+	missed.
+
+	@param pos The position to compute noise at.
+	@param metric How distances are measured.
+	@param output Which value to return.
+
+	@return F1 and F2 are in [0, 1.5] for the Euclidean metric, [0, 2] for the
+	Manhattan metric and [0, 1] for the Chebyshev metric, approximately.
+	*/
+	inline float wnoise(const Vector2 &pos, DistanceMetric metric = DistanceMetric_Euclidean, WorleyOutput output = WorleyOutput_F1)
+	{
+		using namespace __1;
+
+		const float fx = mutil::floor(pos.x);
+		const float fy = mutil::floor(pos.y);
+		const IntVector2 cell((int32_t)fx, (int32_t)fy);
+		const float x = pos.x - fx;
+		const float y = pos.y - fy;
+
+		float f1 = 1e30f, f2 = 1e30f;
+		for (int32_t j = -1; j <= 1; j++)
+		{
+			for (int32_t i = -1; i <= 1; i++)
+			{
+				const Vector2 p = cellPoint(cell + IntVector2(i, j));
+				const float d = worleyDistance(metric, ((float)i + p.x) - x, ((float)j + p.y) - y);
+				f2 = mutil::min(f2, mutil::max(f1, d));
+				f1 = mutil::min(f1, d);
+			}
+		}
+
+		return worleyOutput(metric, output, f1, f2);
+	}
+
+	/*!
+	Cellular (Worley) noise in 3D, searching the 3 x 3 x 3 cells around pos. See
+	wnoise(const Vector2 &, DistanceMetric, WorleyOutput).
+
+	@param pos The position to compute noise at.
+	@param metric How distances are measured.
+	@param output Which value to return.
+
+	@return F1 and F2 are in [0, 1.5] for the Euclidean metric, [0, 2.5] for the
+	Manhattan metric and [0, 1] for the Chebyshev metric, approximately.
+	*/
+	inline float wnoise(const Vector3 &pos, DistanceMetric metric = DistanceMetric_Euclidean, WorleyOutput output = WorleyOutput_F1)
+	{
+		using namespace __1;
+
+		const float fx = mutil::floor(pos.x);
+		const float fy = mutil::floor(pos.y);
+		const float fz = mutil::floor(pos.z);
+		const IntVector3 cell((int32_t)fx, (int32_t)fy, (int32_t)fz);
+		const float x = pos.x - fx;
+		const float y = pos.y - fy;
+		const float z = pos.z - fz;
 
-		for (int i = 0; i < octaves; i++)
+		float f1 = 1e30f, f2 = 1e30f;
+		for (int32_t k = -1; k <= 1; k++)
 		{
-			total += snoise(pos * frequency) * amplitude;
-			frequency *= 2.0f;
-			amplitude *= persistence;
+			for (int32_t j = -1; j <= 1; j++)
+			{
+				for (int32_t i = -1; i <= 1; i++)
+				{
+					const Vector3 p = cellPoint(cell + IntVector3(i, j, k));
+					const float d = worleyDistance(metric, ((float)i + p.x) - x, ((float)j + p.y) - y, ((float)k + p.z) - z);
+					f2 = mutil::min(f2, mutil::max(f1, d));
+					f1 = mutil::min(f1, d);
+				}
+			}
 		}
 
-		return total;
+		return worleyOutput(metric, output, f1, f2);
 	}
 }
@@ -0,0 +1,1068 @@
+/*!
+\file
+Contains methods which evaluate noise over whole grids of samples at once.
+*/
+
+#pragma once
+
+#include "noise.h"
+#include "../simd/simd_math.h"
+#include "../vec/vec_stream.h"
+
+#include <utility>
+
+namespace mutil
+{
+	enum NoiseType
+	{
+		NoiseType_Perlin,	// "Classic" Perlin noise, as computed by pnoise
+		NoiseType_Simplex	// Simplex noise, as computed by snoise
+	};
+
+	namespace __1
+	{
+		/*
+		The tables noise is computed from. perm must hold 256 entries. Without
+		gradients, 2D Perlin noise computes its gradients like
+		pnoise(const Vector2 &).
+		*/
+		struct NoiseTables
+		{
+			const uint8_t *perm;
+			const GradientTable *gradients;
+		};
+
+		// The tables of pnoise and snoise
+		inline NoiseTables defaultNoiseTables()
+		{
+			return { permutation(), nullptr };
+		}
+
+		// The grid is filled in tiles of kNoiseChunk columns by kNoiseBand rows, so
+		// the tile stays in cache while every octave is added to it.
+		constexpr size_t kNoiseChunk = 256;
+		constexpr size_t kNoiseBand = 16;
+
+		// smootherstep for an x already in [0, 1]
+		template <typename V>
+		MUTIL_FORCEINLINE V vsmootherstep(V a, V b, V x)
+		{
+			const V p = vfmadd(x, vfmadd(x, vset1(x, 6.0f), vset1(x, -15.0f)), vset1(x, 10.0f));
+			return vfmadd(vsub(b, a), vmul(vmul(vmul(x, x), x), p), a);
+		}
+
+		// Gradients of one lattice row at the lattice columns on either side of
+		// each sample in a chunk.
+		struct PerlinRow
+		{
+			alignas(MUTIL_STREAM_ALIGNMENT) float ax[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float ay[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float bx[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float by[kNoiseChunk];
+			int y;
+		};
+
+		// Neighbouring samples usually fall between the same lattice columns, so a
+		// gradient is only computed when the column changes.
+		inline void perlinRow(const int *x0, size_t count, int y, PerlinRow &row, const GradientTable *gradients)
+		{
+			auto randGradient2 = [gradients](int ix, int iy) {
+				return gradients ? gradients->gradient(ix, iy) : __1::randGradient2(ix, iy);
+			};
+
+			int last = x0[0];
+			Vector2 a = randGradient2(last, y);
+			Vector2 b = randGradient2(last + 1, y);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				if (x0[i] != last)
+				{
+					if (x0[i] == last + 1)
+					{
+						a = b;
+						b = randGradient2(x0[i] + 1, y);
+					}
+					else if (x0[i] == last - 1)
+					{
+						b = a;
+						a = randGradient2(x0[i], y);
+					}
+					else
+					{
+						a = randGradient2(x0[i], y);
+						b = randGradient2(x0[i] + 1, y);
+					}
+
+					last = x0[i];
+				}
+
+				row.ax[i] = a.x;
+				row.ay[i] = a.y;
+				row.bx[i] = b.x;
+				row.by[i] = b.y;
+			}
+
+			row.y = y;
+		}
+
+		/*
+		Adds one octave of Perlin noise to the columns [x, x + count) of the rows
+		[y, y + rows) of the grid, or stores it if accumulate is false.
+		*/
+		inline void fillPerlinOctave(float *out, size_t width, size_t x, size_t count, size_t y, size_t rows,
+			const Vector2 &origin, const Vector2 &step, float frequency, float amplitude, bool accumulate,
+			const NoiseTables &tables)
+		{
+			alignas(MUTIL_STREAM_ALIGNMENT) float dx[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float sx[kNoiseChunk];
+			int x0[kNoiseChunk];
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const float px = (origin.x + (float)(x + i) * step.x) * frequency;
+				const float fx = mutil::floor(px);
+				x0[i] = (int)fx;
+				dx[i] = px - fx;
+				sx[i] = clamp(dx[i], 0.0f, 1.0f);
+			}
+
+			PerlinRow lattice[2];
+			PerlinRow *r0 = &lattice[0];
+			PerlinRow *r1 = &lattice[1];
+			bool cached = false;
+
+			for (size_t j = y; j < y + rows; j++)
+			{
+				const float py = (origin.y + (float)j * step.y) * frequency;
+				const float fy = mutil::floor(py);
+				const int y0 = (int)fy;
+				const float dy = py - fy;
+				const float sy = clamp(dy, 0.0f, 1.0f);
+
+				// consecutive rows either share their lattice rows or are one apart,
+				// in which case one of the two can be kept
+				if (!cached || y0 != r0->y)
+				{
+					if (cached && y0 == r1->y)
+					{
+						std::swap(r0, r1);
+						perlinRow(x0, count, y0 + 1, *r1, tables.gradients);
+					}
+					else if (cached && y0 + 1 == r0->y)
+					{
+						std::swap(r0, r1);
+						perlinRow(x0, count, y0, *r0, tables.gradients);
+					}
+					else
+					{
+						perlinRow(x0, count, y0, *r0, tables.gradients);
+						perlinRow(x0, count, y0 + 1, *r1, tables.gradients);
+					}
+
+					cached = true;
+				}
+
+				float *row = out + j * width + x;
+				streamFor(count, [&](auto lane, size_t i) {
+					const auto vdx = vload(lane, dx + i);
+					const auto vdx1 = vsub(vdx, vset1(lane, 1.0f));
+					const auto vdy = vset1(lane, dy);
+					const auto vdy1 = vset1(lane, dy - 1.0f);
+					const auto vsx = vload(lane, sx + i);
+
+					const auto n00 = vfmadd(vload(lane, r0->ax + i), vdx, vmul(vload(lane, r0->ay + i), vdy));
+					const auto n10 = vfmadd(vload(lane, r0->bx + i), vdx1, vmul(vload(lane, r0->by + i), vdy));
+					const auto n01 = vfmadd(vload(lane, r1->ax + i), vdx, vmul(vload(lane, r1->ay + i), vdy1));
+					const auto n11 = vfmadd(vload(lane, r1->bx + i), vdx1, vmul(vload(lane, r1->by + i), vdy1));
+
+					const auto ix0 = vsmootherstep(n00, n10, vsx);
+					const auto ix1 = vsmootherstep(n01, n11, vsx);
+
+					auto r = vmul(vsmootherstep(ix0, ix1, vset1(lane, sy)), vset1(lane, amplitude));
+					if (accumulate)
+						r = vadd(vloadu(lane, row + i), r);
+					vstoreu(row + i, r);
+				});
+			}
+		}
+
+		// The gradient vectors which grad(hash, ...) takes the dot product with,
+		// component by component, for every hash in [0, 255]
+		template <size_t N>
+		struct NoiseGradients
+		{
+			float g[N][256];
+
+			NoiseGradients()
+			{
+				for (int h = 0; h < 256; h++)
+				{
+					for (size_t c = 0; c < N; c++)
+					{
+						const float e0 = c == 0 ? 1.0f : 0.0f;
+						const float e1 = c == 1 ? 1.0f : 0.0f;
+						const float e2 = c == 2 ? 1.0f : 0.0f;
+						const float e3 = c == 3 ? 1.0f : 0.0f;
+
+						if (N == 2)
+							g[c][h] = grad(h, e0, e1);
+						else if (N == 3)
+							g[c][h] = grad(h, e0, e1, e2);
+						else
+							g[c][h] = grad(h, e0, e1, e2, e3);
+					}
+				}
+			}
+		};
+
+		template <size_t N>
+		inline const NoiseGradients<N> &noiseGradients()
+		{
+			static const NoiseGradients<N> kGradients;
+			return kGradients;
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V simplexCorner(V x, V y, V gx, V gy)
+		{
+			V t = vfnmadd(y, y, vfnmadd(x, x, vset1(x, 0.5f)));
+			t = vmax(t, vset1(x, 0.0f));
+			t = vmul(t, t);
+			return vmul(vmul(t, t), vfmadd(gx, x, vmul(gy, y)));
+		}
+
+		/*
+		Adds one octave of simplex noise to the columns [x, x + count) of the rows
+		[y, y + rows) of the grid, or stores it if accumulate is false.
+		*/
+		inline void fillSimplexOctave(float *out, size_t width, size_t x, size_t count, size_t y, size_t rows,
+			const Vector2 &origin, const Vector2 &step, float frequency, float amplitude, bool accumulate,
+			const NoiseTables &tables)
+		{
+			constexpr float F2 = 0.366025403f; // (sqrt(3) - 1) / 2
+			constexpr float G2 = 0.211324865f; // (3 - sqrt(3)) / 6
+
+			alignas(MUTIL_STREAM_ALIGNMENT) float px[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float ci[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float cj[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float x0[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float y0[kNoiseChunk];
+			alignas(MUTIL_STREAM_ALIGNMENT) float g[6][kNoiseChunk];
+
+			for (size_t i = 0; i < count; i++)
+				px[i] = (origin.x + (float)(x + i) * step.x) * frequency;
+
+			const uint8_t *perm = tables.perm;
+			const NoiseGradients<2> &grads = noiseGradients<2>();
+
+			for (size_t j = y; j < y + rows; j++)
+			{
+				const float py = (origin.y + (float)j * step.y) * frequency;
+
+				// skew into the simplex cell and find the first corner
+				streamFor(count, [&](auto lane, size_t i) {
+					const auto vx = vload(lane, px + i);
+					const auto vy = vset1(lane, py);
+					const auto s = vmul(vadd(vx, vy), vset1(lane, F2));
+					const auto fi = vfloor(vadd(vx, s));
+					const auto fj = vfloor(vadd(vy, s));
+					const auto t = vmul(vadd(fi, fj), vset1(lane, G2));
+
+					vstore(ci + i, fi);
+					vstore(cj + i, fj);
+					vstore(x0 + i, vsub(vx, vsub(fi, t)));
+					vstore(y0 + i, vsub(vy, vsub(fj, t)));
+				});
+
+				// the permutation lookups have no lane-parallel equivalent
+				for (size_t i = 0; i < count; i++)
+				{
+					const int ii = (int)ci[i];
+					const int jj = (int)cj[i];
+					const int i1 = x0[i] > y0[i] ? 1 : 0;
+					const int j1 = 1 - i1;
+
+					const uint8_t h0 = perm[(uint8_t)(ii + perm[(uint8_t)jj])];
+					const uint8_t h1 = perm[(uint8_t)(ii + i1 + perm[(uint8_t)(jj + j1)])];
+					const uint8_t h2 = perm[(uint8_t)(ii + 1 + perm[(uint8_t)(jj + 1)])];
+
+					g[0][i] = grads.g[0][h0];
+					g[1][i] = grads.g[1][h0];
+					g[2][i] = grads.g[0][h1];
+					g[3][i] = grads.g[1][h1];
+					g[4][i] = grads.g[0][h2];
+					g[5][i] = grads.g[1][h2];
+				}
+
+				float *row = out + j * width + x;
+				streamFor(count, [&](auto lane, size_t i) {
+					const auto vx0 = vload(lane, x0 + i);
+					const auto vy0 = vload(lane, y0 + i);
+					const auto i1 = vselect(vgt(vx0, vy0), vset1(lane, 1.0f), vset1(lane, 0.0f));
+					const auto j1 = vsub(vset1(lane, 1.0f), i1);
+
+					const auto vx1 = vadd(vsub(vx0, i1), vset1(lane, G2));
+					const auto vy1 = vadd(vsub(vy0, j1), vset1(lane, G2));
+					const auto vx2 = vadd(vx0, vset1(lane, -1.0f + 2.0f * G2));
+					const auto vy2 = vadd(vy0, vset1(lane, -1.0f + 2.0f * G2));
+
+					auto n = simplexCorner(vx0, vy0, vload(lane, g[0] + i), vload(lane, g[1] + i));
+					n = vadd(n, simplexCorner(vx1, vy1, vload(lane, g[2] + i), vload(lane, g[3] + i)));
+					n = vadd(n, simplexCorner(vx2, vy2, vload(lane, g[4] + i), vload(lane, g[5] + i)));
+
+					auto r = vmul(vmul(n, vset1(lane, 45.23065f)), vset1(lane, amplitude));
+					if (accumulate)
+						r = vadd(vloadu(lane, row + i), r);
+					vstoreu(row + i, r);
+				});
+			}
+		}
+
+		// Positions evaluated at once by the batch functions on arrays of points
+		constexpr size_t kNoiseBatch = 64;
+
+		// A store for the batch functions which writes the noise to out
+		inline auto storeNoise(float *out)
+		{
+			return [out](auto, size_t i, auto value) { vstoreu(out + i, value); };
+		}
+
+		// Loads for the batch functions which read the positions from arrays of
+		// vectors or from streams
+		inline auto loadNoise(const Vector3 *in)
+		{
+			return [in](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z) {
+				vload3(lane, (const float *)(in + i), x, y, z);
+			};
+		}
+
+		inline auto loadNoise(const Vector4 *in)
+		{
+			return [in](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z, decltype(lane) &w) {
+				vload4(lane, (const float *)(in + i), x, y, z, w);
+			};
+		}
+
+		inline auto loadNoise(const Vector3Stream &in)
+		{
+			return [&in](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z) {
+				x = vload(lane, in.x + i);
+				y = vload(lane, in.y + i);
+				z = vload(lane, in.z + i);
+			};
+		}
+
+		inline auto loadNoise(const Vector4Stream &in)
+		{
+			return [&in](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z, decltype(lane) &w) {
+				x = vload(lane, in.x + i);
+				y = vload(lane, in.y + i);
+				z = vload(lane, in.z + i);
+				w = vload(lane, in.w + i);
+			};
+		}
+
+		/*
+		Computes improved Perlin noise at count positions. load(lane, i, x, y, z)
+		loads the coordinates of the positions starting at i, and
+		store(lane, i, value) receives the noise at them.
+		*/
+		template <typename Load, typename Store>
+		inline void pnoise3Batch(const uint8_t *perm, size_t count, Load load, Store store)
+		{
+			alignas(MUTIL_STREAM_ALIGNMENT) float cell[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float frac[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float g[24][kNoiseBatch];
+
+			const NoiseGradients<3> &grads = noiseGradients<3>();
+
+			for (size_t base = 0; base < count; base += kNoiseBatch)
+			{
+				const size_t n = count - base < kNoiseBatch ? count - base : kNoiseBatch;
+
+				streamFor(n, [&](auto lane, size_t i) {
+					decltype(lane) x, y, z;
+					load(lane, base + i, x, y, z);
+
+					const auto fx = vfloor(x);
+					const auto fy = vfloor(y);
+					const auto fz = vfloor(z);
+
+					vstore(cell[0] + i, fx);
+					vstore(cell[1] + i, fy);
+					vstore(cell[2] + i, fz);
+					vstore(frac[0] + i, vsub(x, fx));
+					vstore(frac[1] + i, vsub(y, fy));
+					vstore(frac[2] + i, vsub(z, fz));
+				});
+
+				// gradients at the corners of each cell, corner c is at offset
+				// (c & 1, (c >> 1) & 1, c >> 2)
+				for (size_t i = 0; i < n; i++)
+				{
+					const int X = (int)cell[0][i];
+					const int Y = (int)cell[1][i];
+					const int Z = (int)cell[2][i];
+
+					for (int c = 0; c < 8; c++)
+					{
+						const uint8_t h = perm[(uint8_t)(perm[(uint8_t)(perm[(uint8_t)(X + (c & 1))] + Y + ((c >> 1) & 1))] + Z + (c >> 2))];
+						g[c * 3 + 0][i] = grads.g[0][h];
+						g[c * 3 + 1][i] = grads.g[1][h];
+						g[c * 3 + 2][i] = grads.g[2][h];
+					}
+				}
+
+				streamFor(n, [&](auto lane, size_t i) {
+					const auto one = vset1(lane, 1.0f);
+					const auto x = vload(lane, frac[0] + i);
+					const auto y = vload(lane, frac[1] + i);
+					const auto z = vload(lane, frac[2] + i);
+					const auto x1 = vsub(x, one);
+					const auto y1 = vsub(y, one);
+					const auto z1 = vsub(z, one);
+
+					auto corner = [&](int c, decltype(lane) cx, decltype(lane) cy, decltype(lane) cz) {
+						return vfmadd(vload(lane, g[c * 3] + i), cx, vfmadd(vload(lane, g[c * 3 + 1] + i), cy, vmul(vload(lane, g[c * 3 + 2] + i), cz)));
+					};
+
+					const auto x00 = vsmootherstep(corner(0, x, y, z), corner(1, x1, y, z), x);
+					const auto x10 = vsmootherstep(corner(2, x, y1, z), corner(3, x1, y1, z), x);
+					const auto x01 = vsmootherstep(corner(4, x, y, z1), corner(5, x1, y, z1), x);
+					const auto x11 = vsmootherstep(corner(6, x, y1, z1), corner(7, x1, y1, z1), x);
+
+					store(lane, base + i, vsmootherstep(vsmootherstep(x00, x10, y), vsmootherstep(x01, x11, y), z));
+				});
+			}
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V simplexCorner(V x, V y, V z, V gx, V gy, V gz)
+		{
+			V t = vfnmadd(z, z, vfnmadd(y, y, vfnmadd(x, x, vset1(x, 0.6f))));
+			t = vmax(t, vset1(x, 0.0f));
+			t = vmul(t, t);
+			return vmul(vmul(t, t), vfmadd(gx, x, vfmadd(gy, y, vmul(gz, z))));
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V simplexCorner(V x, V y, V z, V w, V gx, V gy, V gz, V gw)
+		{
+			V t = vfnmadd(w, w, vfnmadd(z, z, vfnmadd(y, y, vfnmadd(x, x, vset1(x, 0.6f)))));
+			t = vmax(t, vset1(x, 0.0f));
+			t = vmul(t, t);
+			return vmul(vmul(t, t), vfmadd(gx, x, vfmadd(gy, y, vfmadd(gz, z, vmul(gw, w)))));
+		}
+
+		/*
+		Computes 3D simplex noise at count positions. load(lane, i, x, y, z) loads
+		the coordinates of the positions starting at i, and store(lane, i, value)
+		receives the noise at them.
+		*/
+		template <typename Load, typename Store>
+		inline void snoise3Batch(const uint8_t *perm, size_t count, Load load, Store store)
+		{
+			constexpr float F3 = 1.0f / 3.0f;
+			constexpr float G3 = 1.0f / 6.0f;
+
+			alignas(MUTIL_STREAM_ALIGNMENT) float cell[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float pos[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float offset[6][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float g[12][kNoiseBatch];
+
+			const NoiseGradients<3> &grads = noiseGradients<3>();
+
+			for (size_t base = 0; base < count; base += kNoiseBatch)
+			{
+				const size_t n = count - base < kNoiseBatch ? count - base : kNoiseBatch;
+
+				// skew into the simplex cell, then order the coordinates within it
+				// to find the offsets of the second and third corners
+				streamFor(n, [&](auto lane, size_t i) {
+					decltype(lane) x, y, z;
+					load(lane, base + i, x, y, z);
+
+					const auto one = vset1(lane, 1.0f);
+					const auto zero = vset1(lane, 0.0f);
+
+					const auto s = vmul(vadd(vadd(x, y), z), vset1(lane, F3));
+					const auto fi = vfloor(vadd(x, s));
+					const auto fj = vfloor(vadd(y, s));
+					const auto fk = vfloor(vadd(z, s));
+					const auto t = vmul(vadd(vadd(fi, fj), fk), vset1(lane, G3));
+					const auto x0 = vsub(x, vsub(fi, t));
+					const auto y0 = vsub(y, vsub(fj, t));
+					const auto z0 = vsub(z, vsub(fk, t));
+
+					const auto xy = vselect(vle(y0, x0), one, zero);
+					const auto yz = vselect(vle(z0, y0), one, zero);
+					const auto xz = vselect(vle(z0, x0), one, zero);
+
+					vstore(cell[0] + i, fi);
+					vstore(cell[1] + i, fj);
+					vstore(cell[2] + i, fk);
+					vstore(pos[0] + i, x0);
+					vstore(pos[1] + i, y0);
+					vstore(pos[2] + i, z0);
+					vstore(offset[0] + i, vmul(xy, xz));
+					vstore(offset[1] + i, vmul(vsub(one, xy), yz));
+					vstore(offset[2] + i, vmul(vsub(one, xz), vsub(one, yz)));
+					vstore(offset[3] + i, vmax(xy, xz));
+					vstore(offset[4] + i, vmax(vsub(one, xy), yz));
+					vstore(offset[5] + i, vmax(vsub(one, xz), vsub(one, yz)));
+				});
+
+				for (size_t i = 0; i < n; i++)
+				{
+					const int ii = (int)cell[0][i];
+					const int jj = (int)cell[1][i];
+					const int kk = (int)cell[2][i];
+					const int i1 = (int)offset[0][i], j1 = (int)offset[1][i], k1 = (int)offset[2][i];
+					const int i2 = (int)offset[3][i], j2 = (int)offset[4][i], k2 = (int)offset[5][i];
+
+					const uint8_t h[4] = {
+						perm[(uint8_t)(ii + perm[(uint8_t)(jj + perm[(uint8_t)kk])])],
+						perm[(uint8_t)(ii + i1 + perm[(uint8_t)(jj + j1 + perm[(uint8_t)(kk + k1)])])],
+						perm[(uint8_t)(ii + i2 + perm[(uint8_t)(jj + j2 + perm[(uint8_t)(kk + k2)])])],
+						perm[(uint8_t)(ii + 1 + perm[(uint8_t)(jj + 1 + perm[(uint8_t)(kk + 1)])])],
+					};
+
+					for (int c = 0; c < 4; c++)
+					{
+						g[c * 3 + 0][i] = grads.g[0][h[c]];
+						g[c * 3 + 1][i] = grads.g[1][h[c]];
+						g[c * 3 + 2][i] = grads.g[2][h[c]];
+					}
+				}
+
+				streamFor(n, [&](auto lane, size_t i) {
+					const auto x0 = vload(lane, pos[0] + i);
+					const auto y0 = vload(lane, pos[1] + i);
+					const auto z0 = vload(lane, pos[2] + i);
+
+					auto corner = [&](int c, decltype(lane) x, decltype(lane) y, decltype(lane) z) {
+						return simplexCorner(x, y, z, vload(lane, g[c * 3] + i), vload(lane, g[c * 3 + 1] + i), vload(lane, g[c * 3 + 2] + i));
+					};
+
+					const auto g1 = vset1(lane, G3);
+					const auto g2 = vset1(lane, 2.0f * G3);
+					const auto g3 = vset1(lane, -1.0f + 3.0f * G3);
+
+					auto r = corner(0, x0, y0, z0);
+					r = vadd(r, corner(1,
+						vadd(vsub(x0, vload(lane, offset[0] + i)), g1),
+						vadd(vsub(y0, vload(lane, offset[1] + i)), g1),
+						vadd(vsub(z0, vload(lane, offset[2] + i)), g1)));
+					r = vadd(r, corner(2,
+						vadd(vsub(x0, vload(lane, offset[3] + i)), g2),
+						vadd(vsub(y0, vload(lane, offset[4] + i)), g2),
+						vadd(vsub(z0, vload(lane, offset[5] + i)), g2)));
+					r = vadd(r, corner(3, vadd(x0, g3), vadd(y0, g3), vadd(z0, g3)));
+
+					store(lane, base + i, vmul(r, vset1(lane, 32.0f)));
+				});
+			}
+		}
+
+		/*
+		Computes 4D simplex noise at count positions. load(lane, i, x, y, z, w)
+		loads the coordinates of the positions starting at i, and
+		store(lane, i, value) receives the noise at them.
+		*/
+		template <typename Load, typename Store>
+		inline void snoise4Batch(const uint8_t *perm, size_t count, Load load, Store store)
+		{
+			constexpr float F4 = 0.309016994f; // (sqrt(5) - 1) / 4
+			constexpr float G4 = 0.138196601f; // (5 - sqrt(5)) / 20
+
+			alignas(MUTIL_STREAM_ALIGNMENT) float cell[4][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float pos[4][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float rank[4][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float g[20][kNoiseBatch];
+
+			const NoiseGradients<4> &grads = noiseGradients<4>();
+
+			for (size_t base = 0; base < count; base += kNoiseBatch)
+			{
+				const size_t n = count - base < kNoiseBatch ? count - base : kNoiseBatch;
+
+				// skew into the simplex cell, then rank the coordinates within it,
+				// which decides the order in which the corners are visited
+				streamFor(n, [&](auto lane, size_t i) {
+					decltype(lane) x, y, z, w;
+					load(lane, base + i, x, y, z, w);
+
+					const auto one = vset1(lane, 1.0f);
+					const auto zero = vset1(lane, 0.0f);
+
+					const auto s = vmul(vadd(vadd(vadd(x, y), z), w), vset1(lane, F4));
+					const auto fi = vfloor(vadd(x, s));
+					const auto fj = vfloor(vadd(y, s));
+					const auto fk = vfloor(vadd(z, s));
+					const auto fl = vfloor(vadd(w, s));
+					const auto t = vmul(vadd(vadd(vadd(fi, fj), fk), fl), vset1(lane, G4));
+					const auto x0 = vsub(x, vsub(fi, t));
+					const auto y0 = vsub(y, vsub(fj, t));
+					const auto z0 = vsub(z, vsub(fk, t));
+					const auto w0 = vsub(w, vsub(fl, t));
+
+					const auto xy = vselect(vgt(x0, y0), one, zero);
+					const auto xz = vselect(vgt(x0, z0), one, zero);
+					const auto xw = vselect(vgt(x0, w0), one, zero);
+					const auto yz = vselect(vgt(y0, z0), one, zero);
+					const auto yw = vselect(vgt(y0, w0), one, zero);
+					const auto zw = vselect(vgt(z0, w0), one, zero);
+
+					vstore(cell[0] + i, fi);
+					vstore(cell[1] + i, fj);
+					vstore(cell[2] + i, fk);
+					vstore(cell[3] + i, fl);
+					vstore(pos[0] + i, x0);
+					vstore(pos[1] + i, y0);
+					vstore(pos[2] + i, z0);
+					vstore(pos[3] + i, w0);
+					vstore(rank[0] + i, vadd(vadd(xy, xz), xw));
+					vstore(rank[1] + i, vadd(vadd(vsub(one, xy), yz), yw));
+					vstore(rank[2] + i, vadd(vadd(vsub(one, xz), vsub(one, yz)), zw));
+					vstore(rank[3] + i, vadd(vadd(vsub(one, xw), vsub(one, yw)), vsub(one, zw)));
+				});
+
+				for (size_t i = 0; i < n; i++)
+				{
+					const int ii = (int)cell[0][i];
+					const int jj = (int)cell[1][i];
+					const int kk = (int)cell[2][i];
+					const int ll = (int)cell[3][i];
+					const int rx = (int)rank[0][i];
+					const int ry = (int)rank[1][i];
+					const int rz = (int)rank[2][i];
+					const int rw = (int)rank[3][i];
+
+					// corner c is offset by one along every axis ranked at least 4 - c
+					for (int c = 0; c < 5; c++)
+					{
+						const int r = 4 - c;
+						const uint8_t h = perm[(uint8_t)(ii + (rx >= r) + perm[(uint8_t)(jj + (ry >= r) + perm[(uint8_t)(kk + (rz >= r) + perm[(uint8_t)(ll + (rw >= r))])])])];
+						g[c * 4 + 0][i] = grads.g[0][h];
+						g[c * 4 + 1][i] = grads.g[1][h];
+						g[c * 4 + 2][i] = grads.g[2][h];
+						g[c * 4 + 3][i] = grads.g[3][h];
+					}
+				}
+
+				streamFor(n, [&](auto lane, size_t i) {
+					const auto x0 = vload(lane, pos[0] + i);
+					const auto y0 = vload(lane, pos[1] + i);
+					const auto z0 = vload(lane, pos[2] + i);
+					const auto w0 = vload(lane, pos[3] + i);
+					const auto rx = vload(lane, rank[0] + i);
+					const auto ry = vload(lane, rank[1] + i);
+					const auto rz = vload(lane, rank[2] + i);
+					const auto rw = vload(lane, rank[3] + i);
+
+					const auto one = vset1(lane, 1.0f);
+					const auto zero = vset1(lane, 0.0f);
+
+					auto r = vset1(lane, 0.0f);
+					for (int c = 0; c < 5; c++)
+					{
+						// the offsets of corner c, less c * G4 for the unskew
+						const auto min = vset1(lane, 3.5f - (float)c);
+						const auto d = vset1(lane, (float)c * G4);
+						const auto x = vadd(vsub(x0, vselect(vgt(rx, min), one, zero)), d);
+						const auto y = vadd(vsub(y0, vselect(vgt(ry, min), one, zero)), d);
+						const auto z = vadd(vsub(z0, vselect(vgt(rz, min), one, zero)), d);
+						const auto w = vadd(vsub(w0, vselect(vgt(rw, min), one, zero)), d);
+
+						r = vadd(r, simplexCorner(x, y, z, w,
+							vload(lane, g[c * 4] + i), vload(lane, g[c * 4 + 1] + i),
+							vload(lane, g[c * 4 + 2] + i), vload(lane, g[c * 4 + 3] + i)));
+					}
+
+					store(lane, base + i, vmul(r, vset1(lane, 27.0f)));
+				});
+			}
+		}
+
+		constexpr size_t worleyPoints(size_t n)
+		{
+			return n == 2 ? 9 : 27;
+		}
+
+		// Feature points of the cells around the cell of each sample in a chunk of
+		// a row, relative to the corner of the sample's cell. Component c of the
+		// point of neighbour k is q[k * N + c], where neighbour k is offset by
+		// k % 3 - 1, k / 3 % 3 - 1 and k / 9 - 1 cells.
+		template <size_t N>
+		struct WorleyRow
+		{
+			alignas(MUTIL_STREAM_ALIGNMENT) float q[worleyPoints(N) * N][kNoiseBatch];
+		};
+
+		// All samples in a row share their cell along y and z, and neighbouring
+		// samples usually share it along x, so the points are only found when the
+		// cell changes.
+		inline void worleyRow(const int32_t *cx, size_t count, int32_t cy, WorleyRow<2> &row)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				for (size_t k = 0; k < worleyPoints(2); k++)
+				{
+					if (i > 0 && cx[i] == cx[i - 1])
+					{
+						row.q[k * 2][i] = row.q[k * 2][i - 1];
+						row.q[k * 2 + 1][i] = row.q[k * 2 + 1][i - 1];
+						continue;
+					}
+
+					const int32_t ox = (int32_t)(k % 3) - 1;
+					const int32_t oy = (int32_t)(k / 3) - 1;
+					const Vector2 p = cellPoint(IntVector2(cx[i] + ox, cy + oy));
+					row.q[k * 2][i] = (float)ox + p.x;
+					row.q[k * 2 + 1][i] = (float)oy + p.y;
+				}
+			}
+		}
+
+		inline void worleyRow(const int32_t *cx, size_t count, int32_t cy, int32_t cz, WorleyRow<3> &row)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				for (size_t k = 0; k < worleyPoints(3); k++)
+				{
+					if (i > 0 && cx[i] == cx[i - 1])
+					{
+						row.q[k * 3][i] = row.q[k * 3][i - 1];
+						row.q[k * 3 + 1][i] = row.q[k * 3 + 1][i - 1];
+						row.q[k * 3 + 2][i] = row.q[k * 3 + 2][i - 1];
+						continue;
+					}
+
+					const int32_t ox = (int32_t)(k % 3) - 1;
+					const int32_t oy = (int32_t)(k / 3 % 3) - 1;
+					const int32_t oz = (int32_t)(k / 9) - 1;
+					const Vector3 p = cellPoint(IntVector3(cx[i] + ox, cy + oy, cz + oz));
+					row.q[k * 3][i] = (float)ox + p.x;
+					row.q[k * 3 + 1][i] = (float)oy + p.y;
+					row.q[k * 3 + 2][i] = (float)oz + p.z;
+				}
+			}
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vworleyDistance(DistanceMetric metric, V dx, V dy)
+		{
+			if (metric == DistanceMetric_Manhattan)
+				return vadd(vabs(dx), vabs(dy));
+			if (metric == DistanceMetric_Chebyshev)
+				return vmax(vabs(dx), vabs(dy));
+			return vfmadd(dx, dx, vmul(dy, dy));
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vworleyDistance(DistanceMetric metric, V dx, V dy, V dz)
+		{
+			if (metric == DistanceMetric_Manhattan)
+				return vadd(vadd(vabs(dx), vabs(dy)), vabs(dz));
+			if (metric == DistanceMetric_Chebyshev)
+				return vmax(vmax(vabs(dx), vabs(dy)), vabs(dz));
+			return vfmadd(dx, dx, vfmadd(dy, dy, vmul(dz, dz)));
+		}
+
+		/*
+		Computes cellular noise for the samples of a chunk of a row. fx holds the
+		position of each sample within its cell along x, and fy and fz that of
+		the row.
+		*/
+		template <size_t N>
+		inline void worleyRowOutput(float *out, size_t count, const float *fx, float fy, float fz,
+			const WorleyRow<N> &row, DistanceMetric metric, WorleyOutput output)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				const auto x = vload(lane, fx + i);
+				const auto y = vset1(lane, fy);
+				const auto z = vset1(lane, fz);
+
+				auto f1 = vset1(lane, 1e30f);
+				auto f2 = f1;
+
+				for (size_t k = 0; k < worleyPoints(N); k++)
+				{
+					const auto dx = vsub(vload(lane, row.q[k * N] + i), x);
+					const auto dy = vsub(vload(lane, row.q[k * N + 1] + i), y);
+					const auto d = N == 2 ?
+						vworleyDistance(metric, dx, dy) :
+						vworleyDistance(metric, dx, dy, vsub(vload(lane, row.q[k * N + N - 1] + i), z));
+
+					f2 = vmin(f2, vmax(f1, d));
+					f1 = vmin(f1, d);
+				}
+
+				if (metric == DistanceMetric_Euclidean)
+				{
+					f1 = vsqrt(f1);
+					f2 = vsqrt(f2);
+				}
+
+				vstoreu(out + i, output == WorleyOutput_F1 ? f1 : output == WorleyOutput_F2 ? f2 : vsub(f2, f1));
+			});
+		}
+
+		// Finds the cell of each sample in a chunk of columns
+		inline void worleyColumns(size_t x, size_t count, float origin, float step, int32_t *cx, float *fx)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const float px = origin + (float)(x + i) * step;
+				const float f = mutil::floor(px);
+				cx[i] = (int32_t)f;
+				fx[i] = px - f;
+			}
+		}
+
+		/*
+		Fills the columns [x, x + columns) of the rows [y, y + rows) of a grid with
+		the samples fillNoise2D would compute for them. Every sample only depends on
+		its own column and row, so a grid can be filled in any number of regions.
+		*/
+		inline void fillNoise2DRegion(float *out, size_t width, size_t x, size_t y, size_t columns, size_t rows,
+			const Vector2 &origin, const Vector2 &step, int octaves, float persistence, NoiseType type, const NoiseTables &tables)
+		{
+			if (octaves <= 0)
+			{
+				for (size_t j = y; j < y + rows; j++)
+				{
+					for (size_t i = x; i < x + columns; i++)
+						out[j * width + i] = 0.0f;
+				}
+				return;
+			}
+
+			auto fillOctave = type == NoiseType_Simplex ? &fillSimplexOctave : &fillPerlinOctave;
+
+			for (size_t band = y; band < y + rows; band += kNoiseBand)
+			{
+				const size_t bandRows = y + rows - band < kNoiseBand ? y + rows - band : kNoiseBand;
+
+				for (size_t chunk = x; chunk < x + columns; chunk += kNoiseChunk)
+				{
+					const size_t count = x + columns - chunk < kNoiseChunk ? x + columns - chunk : kNoiseChunk;
+
+					float amplitude = 1.0f;
+					float frequency = 1.0f;
+
+					for (int i = 0; i < octaves; i++)
+					{
+						fillOctave(out, width, chunk, count, band, bandRows, origin, step, frequency, amplitude, i > 0, tables);
+						frequency *= 2.0f;
+						amplitude *= persistence;
+					}
+				}
+			}
+		}
+	}
+
+	/*!
+	Fills a grid with noise. The sample at column x and row y is
+	pnoise(origin + Vector2(x * step.x, y * step.y), persistence, octaves), or
+	the same with snoise. Samples are evaluated MUTIL_SIMD_WIDTH at a time, and
+	Perlin gradients are shared between samples in the same lattice cell.
+
+	@param out Receives the samples, row by row. Must hold width * height floats.
+	@param width The number of columns.
+	@param height The number of rows.
+	@param origin The position of the first sample.
+	@param step The distance between neighbouring columns and rows.
+	@param octaves The number of octaves.
+	@param persistence The amplitude of each octave relative to the previous one.
+	@param type The kind of noise to generate.
+	*/
+	inline void fillNoise2D(float *out, size_t width, size_t height, const Vector2 &origin, const Vector2 &step,
+		int octaves = 1, float persistence = 0.5f, NoiseType type = NoiseType_Perlin)
+	{
+		__1::fillNoise2DRegion(out, width, 0, 0, width, height, origin, step, octaves, persistence, type, __1::defaultNoiseTables());
+	}
+
+	/*!
+	Computes improved Perlin noise at many positions, equivalent to
+	out[i] = pnoise(in[i]).
+
+	@param in The positions.
+	@param out Receives the noise at each position.
+	@param count The number of positions.
+	*/
+	inline void pnoise(const Vector3 *in, float *out, size_t count)
+	{
+		__1::pnoise3Batch(__1::permutation(), count, __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Computes improved Perlin noise at every position in a stream, equivalent to
+	out[i] = pnoise(in.get(i)).
+
+	@param in The positions.
+	@param out Receives the noise at each position. Must hold in.size() floats.
+	*/
+	inline void pnoise(const Vector3Stream &in, float *out)
+	{
+		__1::pnoise3Batch(__1::permutation(), in.size(), __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Computes simplex noise at many positions, equivalent to
+	out[i] = snoise(in[i]).
+
+	@param in The positions.
+	@param out Receives the noise at each position.
+	@param count The number of positions.
+	*/
+	inline void snoise(const Vector3 *in, float *out, size_t count)
+	{
+		__1::snoise3Batch(__1::permutation(), count, __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Computes simplex noise at every position in a stream, equivalent to
+	out[i] = snoise(in.get(i)).
+
+	@param in The positions.
+	@param out Receives the noise at each position. Must hold in.size() floats.
+	*/
+	inline void snoise(const Vector3Stream &in, float *out)
+	{
+		__1::snoise3Batch(__1::permutation(), in.size(), __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Computes simplex noise at many positions, equivalent to
+	out[i] = snoise(in[i]).
+
+	@param in The positions.
+	@param out Receives the noise at each position.
+	@param count The number of positions.
+	*/
+	inline void snoise(const Vector4 *in, float *out, size_t count)
+	{
+		__1::snoise4Batch(__1::permutation(), count, __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Computes simplex noise at every position in a stream, equivalent to
+	out[i] = snoise(in.get(i)).
+
+	@param in The positions.
+	@param out Receives the noise at each position. Must hold in.size() floats.
+	*/
+	inline void snoise(const Vector4Stream &in, float *out)
+	{
+		__1::snoise4Batch(__1::permutation(), in.size(), __1::loadNoise(in), __1::storeNoise(out));
+	}
+
+	/*!
+	Fills a grid with cellular noise. The sample at column x and row y is
+	wnoise(origin + Vector2(x * step.x, y * step.y), metric, output). The
+	feature points around a cell are found once for all the samples in it, and
+	samples are evaluated MUTIL_SIMD_WIDTH at a time.
+
+	@param out Receives the samples, row by row. Must hold width * height floats.
+	@param width The number of columns.
+	@param height The number of rows.
+	@param origin The position of the first sample.
+	@param step The distance between neighbouring columns and rows.
+	@param metric How distances are measured.
+	@param output Which value to compute.
+	*/
+	inline void fillWorley2D(float *out, size_t width, size_t height, const Vector2 &origin, const Vector2 &step,
+		DistanceMetric metric = DistanceMetric_Euclidean, WorleyOutput output = WorleyOutput_F1)
+	{
+		using namespace __1;
+
+		alignas(MUTIL_STREAM_ALIGNMENT) float fx[kNoiseBatch];
+		int32_t cx[kNoiseBatch];
+		WorleyRow<2> row;
+
+		for (size_t x = 0; x < width; x += kNoiseBatch)
+		{
+			const size_t count = width - x < kNoiseBatch ? width - x : kNoiseBatch;
+			worleyColumns(x, count, origin.x, step.x, cx, fx);
+
+			bool cached = false;
+			int32_t cachedY = 0;
+
+			for (size_t y = 0; y < height; y++)
+			{
+				const float py = origin.y + (float)y * step.y;
+				const float f = mutil::floor(py);
+				const int32_t cy = (int32_t)f;
+
+				if (!cached || cy != cachedY)
+				{
+					worleyRow(cx, count, cy, row);
+					cached = true;
+					cachedY = cy;
+				}
+
+				worleyRowOutput(out + y * width + x, count, fx, py - f, 0.0f, row, metric, output);
+			}
+		}
+	}
+
+	/*!
+	Fills a volume with cellular noise. The sample at column x, row y and layer
+	z is wnoise(origin + Vector3(x * step.x, y * step.y, z * step.z), metric,
+	output).
+
+	@param out Receives the samples, row by row and layer by layer. Must hold
+	width * height * depth floats.
+	@param width The number of columns.
+	@param height The number of rows.
+	@param depth The number of layers.
+	@param origin The position of the first sample.
+	@param step The distance between neighbouring columns, rows and layers.
+	@param metric How distances are measured.
+	@param output Which value to compute.
+	*/
+	inline void fillWorley3D(float *out, size_t width, size_t height, size_t depth, const Vector3 &origin, const Vector3 &step,
+		DistanceMetric metric = DistanceMetric_Euclidean, WorleyOutput output = WorleyOutput_F1)
+	{
+		using namespace __1;
+
+		alignas(MUTIL_STREAM_ALIGNMENT) float fx[kNoiseBatch];
+		int32_t cx[kNoiseBatch];
+		WorleyRow<3> row;
+
+		for (size_t x = 0; x < width; x += kNoiseBatch)
+		{
+			const size_t count = width - x < kNoiseBatch ? width - x : kNoiseBatch;
+			worleyColumns(x, count, origin.x, step.x, cx, fx);
+
+			bool cached = false;
+			int32_t cachedY = 0, cachedZ = 0;
+
+			for (size_t z = 0; z < depth; z++)
+			{
+				const float pz = origin.z + (float)z * step.z;
+				const float gz = mutil::floor(pz);
+				const int32_t cz = (int32_t)gz;
+
+				for (size_t y = 0; y < height; y++)
+				{
+					const float py = origin.y + (float)y * step.y;
+					const float gy = mutil::floor(py);
+					const int32_t cy = (int32_t)gy;
+
+					if (!cached || cy != cachedY || cz != cachedZ)
+					{
+						worleyRow(cx, count, cy, cz, row);
+						cached = true;
+						cachedY = cy;
+						cachedZ = cz;
+					}
+
+					worleyRowOutput(out + (z * height + y) * width + x, count, fx, py - gy, pz - gz, row, metric, output);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,252 @@
+/*!
+\file
+Contains FractalNoise, which combines octaves of Perlin or simplex noise into
+fBm, billow, ridged, or turbulence noise, optionally with a warped domain.
+*/
+
+#pragma once
+
+#include "noise_batch.h"
+
+namespace mutil
+{
+	enum FractalType
+	{
+		FractalType_FBm,		// The sum of the octaves, as computed by pnoise(pos, persistence, octaves)
+		FractalType_Billow,		// The sum of 2|n| - 1 for each octave n, giving rounded lumps
+		FractalType_Ridged,		// Musgrave's ridged multifractal, giving sharp ridges
+		FractalType_Turbulence	// The sum of |n| for each octave n
+	};
+
+	/*!
+	Describes how noise is composed from several octaves of Perlin or simplex
+	noise. Each octave has lacunarity times the frequency and persistence times
+	the amplitude of the previous one.
+
+	With a nonzero warpAmplitude the domain is warped first: the position is
+	moved by warpAmplitude times a vector of three noise values sampled around
+	it, with warpFrequency times its frequency.
+
+	The batch versions of sample evaluate every octave of a few dozen positions
+	while they are in the L1 cache, combining the noise of each octave into the
+	result as soon as it is computed.
+	*/
+	struct FractalNoise
+	{
+		NoiseType type = NoiseType_Simplex;
+		FractalType fractal = FractalType_FBm;
+		int octaves = 4;
+		float frequency = 1.0f;
+		float lacunarity = 2.0f;
+		float persistence = 0.5f;
+		float warpAmplitude = 0.0f;
+		float warpFrequency = 1.0f;
+
+		/*!
+		@param pos The position to compute noise at.
+
+		@return The noise at pos. Not normalized, for FractalType_FBm and
+		FractalType_Billow it is in [-a, a] and for the other types in [0, a],
+		where a is the sum of the amplitudes of the octaves.
+		*/
+		inline float sample(const Vector3 &pos) const;
+
+		/*!
+		Computes noise at many positions, equivalent to out[i] = sample(in[i]).
+
+		@param in The positions.
+		@param out Receives the noise at each position.
+		@param count The number of positions.
+		*/
+		inline void sample(const Vector3 *in, float *out, size_t count) const;
+
+		/*!
+		Computes noise at every position in a stream, equivalent to
+		out[i] = sample(in.get(i)).
+
+		@param in The positions.
+		@param out Receives the noise at each position. Must hold in.size() floats.
+		*/
+		inline void sample(const Vector3Stream &in, float *out) const;
+	};
+
+	namespace __1
+	{
+		// Offsets between the samples giving the components of the warp, so they
+		// are not equal
+		constexpr float kWarpOffsets[3][3] = {
+			{ 0.0f, 0.0f, 0.0f },
+			{ 5.2f, 1.3f, 7.1f },
+			{ 1.7f, 9.2f, 3.4f }
+		};
+
+		inline float noise(NoiseType type, const Vector3 &pos)
+		{
+			return type == NoiseType_Perlin ? pnoise(pos) : snoise(pos);
+		}
+
+		template <typename Load, typename Store>
+		inline void noise3Batch(NoiseType type, size_t count, Load load, Store store)
+		{
+			if (type == NoiseType_Perlin)
+				pnoise3Batch(permutation(), count, load, store);
+			else
+				snoise3Batch(permutation(), count, load, store);
+		}
+
+		/*
+		Evaluates f at count positions. load(lane, i, x, y, z) loads the
+		coordinates of the positions starting at i.
+		*/
+		template <typename Load>
+		inline void fractalBatch(const FractalNoise &f, float *out, size_t count, Load load)
+		{
+			alignas(MUTIL_STREAM_ALIGNMENT) float p[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float warp[3][kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float total[kNoiseBatch];
+			alignas(MUTIL_STREAM_ALIGNMENT) float weight[kNoiseBatch];
+
+			for (size_t base = 0; base < count; base += kNoiseBatch)
+			{
+				const size_t n = count - base < kNoiseBatch ? count - base : kNoiseBatch;
+
+				streamFor(n, [&](auto lane, size_t i) {
+					decltype(lane) x, y, z;
+					load(lane, base + i, x, y, z);
+
+					const auto frequency = vset1(lane, f.frequency);
+					vstore(p[0] + i, vmul(x, frequency));
+					vstore(p[1] + i, vmul(y, frequency));
+					vstore(p[2] + i, vmul(z, frequency));
+					vstore(total + i, vset1(lane, 0.0f));
+					vstore(weight + i, vset1(lane, 1.0f));
+				});
+
+				if (f.warpAmplitude != 0.0f)
+				{
+					for (size_t c = 0; c < 3; c++)
+					{
+						noise3Batch(f.type, n, [&](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z) {
+							const auto frequency = vset1(lane, f.warpFrequency);
+							x = vfmadd(vload(lane, p[0] + i), frequency, vset1(lane, kWarpOffsets[c][0]));
+							y = vfmadd(vload(lane, p[1] + i), frequency, vset1(lane, kWarpOffsets[c][1]));
+							z = vfmadd(vload(lane, p[2] + i), frequency, vset1(lane, kWarpOffsets[c][2]));
+						}, storeNoise(warp[c]));
+					}
+
+					streamFor(n, [&](auto lane, size_t i) {
+						const auto amplitude = vset1(lane, f.warpAmplitude);
+						for (size_t c = 0; c < 3; c++)
+							vstore(p[c] + i, vfmadd(vload(lane, warp[c] + i), amplitude, vload(lane, p[c] + i)));
+					});
+				}
+
+				float frequency = 1.0f;
+				float amplitude = 1.0f;
+
+				for (int octave = 0; octave < f.octaves; octave++)
+				{
+					noise3Batch(f.type, n, [&](auto lane, size_t i, decltype(lane) &x, decltype(lane) &y, decltype(lane) &z) {
+						const auto s = vset1(lane, frequency);
+						x = vmul(vload(lane, p[0] + i), s);
+						y = vmul(vload(lane, p[1] + i), s);
+						z = vmul(vload(lane, p[2] + i), s);
+					}, [&](auto lane, size_t i, decltype(lane) value) {
+						const auto a = vset1(lane, amplitude);
+						const auto one = vset1(lane, 1.0f);
+						const auto t = vload(lane, total + i);
+
+						switch (f.fractal)
+						{
+						case FractalType_Billow:
+							vstore(total + i, vfmadd(vsub(vadd(vabs(value), vabs(value)), one), a, t));
+							break;
+						case FractalType_Ridged:
+						{
+							auto signal = vsub(one, vabs(value));
+							signal = vmul(vmul(signal, signal), vload(lane, weight + i));
+							vstore(weight + i, vmin(vmax(vadd(signal, signal), vset1(lane, 0.0f)), one));
+							vstore(total + i, vfmadd(signal, a, t));
+							break;
+						}
+						case FractalType_Turbulence:
+							vstore(total + i, vfmadd(vabs(value), a, t));
+							break;
+						default:
+							vstore(total + i, vfmadd(value, a, t));
+							break;
+						}
+					});
+
+					frequency *= f.lacunarity;
+					amplitude *= f.persistence;
+				}
+
+				streamFor(n, [&](auto lane, size_t i) {
+					vstoreu(out + base + i, vload(lane, total + i));
+				});
+			}
+		}
+	}
+
+	inline float FractalNoise::sample(const Vector3 &pos) const
+	{
+		using namespace __1;
+
+		Vector3 p = pos * frequency;
+
+		if (warpAmplitude != 0.0f)
+		{
+			Vector3 warp;
+			for (size_t c = 0; c < 3; c++)
+				warp[c] = noise(type, p * warpFrequency + Vector3(kWarpOffsets[c][0], kWarpOffsets[c][1], kWarpOffsets[c][2]));
+			p += warp * warpAmplitude;
+		}
+
+		float total = 0.0f;
+		float weight = 1.0f;
+		float f = 1.0f;
+		float amplitude = 1.0f;
+
+		for (int octave = 0; octave < octaves; octave++)
+		{
+			const float value = noise(type, p * f);
+
+			switch (fractal)
+			{
+			case FractalType_Billow:
+				total += (2.0f * mutil::abs(value) - 1.0f) * amplitude;
+				break;
+			case FractalType_Ridged:
+			{
+				float signal = 1.0f - mutil::abs(value);
+				signal = signal * signal * weight;
+				weight = mutil::clamp(2.0f * signal, 0.0f, 1.0f);
+				total += signal * amplitude;
+				break;
+			}
+			case FractalType_Turbulence:
+				total += mutil::abs(value) * amplitude;
+				break;
+			default:
+				total += value * amplitude;
+				break;
+			}
+
+			f *= lacunarity;
+			amplitude *= persistence;
+		}
+
+		return total;
+	}
+
+	inline void FractalNoise::sample(const Vector3 *in, float *out, size_t count) const
+	{
+		__1::fractalBatch(*this, out, count, __1::loadNoise(in));
+	}
+
+	inline void FractalNoise::sample(const Vector3Stream &in, float *out) const
+	{
+		__1::fractalBatch(*this, out, in.size(), __1::loadNoise(in));
+	}
+}
@@ -0,0 +1,75 @@
+/*!
+\file
+Contains the multithreaded versions of the noise grid functions.
+
+Not included by mutil.h, see parallel/thread_pool.h.
+*/
+
+#pragma once
+
+#include "../mutil.h"
+#include "../parallel/thread_pool.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		// Rows in each tile of a parallel fill. A tile of kNoiseChunk columns is
+		// 64 KiB, small enough to stay in the L2 cache of the thread filling it.
+		constexpr size_t kNoiseTileRows = 64;
+
+		inline void fillNoise2DParallel(float *out, size_t width, size_t height, const Vector2 &origin, const Vector2 &step,
+			int octaves, float persistence, NoiseType type, const NoiseTables &tables, Executor *executor)
+		{
+			Executor &e = executor ? *executor : ThreadPool::global();
+
+			const size_t tilesX = (width + kNoiseChunk - 1) / kNoiseChunk;
+			const size_t tilesY = (height + kNoiseTileRows - 1) / kNoiseTileRows;
+
+			e.parallelFor(tilesX * tilesY, [&](size_t tile) {
+				const size_t x = tile % tilesX * kNoiseChunk;
+				const size_t y = tile / tilesX * kNoiseTileRows;
+				const size_t columns = width - x < kNoiseChunk ? width - x : kNoiseChunk;
+				const size_t rows = height - y < kNoiseTileRows ? height - y : kNoiseTileRows;
+
+				fillNoise2DRegion(out, width, x, y, columns, rows, origin, step, octaves, persistence, type, tables);
+			});
+		}
+	}
+
+	/*!
+	Fills a grid with noise using several threads. The grid is split into tiles
+	which are filled independently, and the result is the same as that of
+	fillNoise2D, whatever the number of threads.
+
+	@param out Receives the samples, row by row. Must hold width * height floats.
+	@param width The number of columns.
+	@param height The number of rows.
+	@param origin The position of the first sample.
+	@param step The distance between neighbouring columns and rows.
+	@param octaves The number of octaves.
+	@param persistence The amplitude of each octave relative to the previous one.
+	@param type The kind of noise to generate.
+	@param executor Runs the tiles. If null, ThreadPool::global() is used.
+	*/
+	inline void fillNoise2DParallel(float *out, size_t width, size_t height, const Vector2 &origin, const Vector2 &step,
+		int octaves = 1, float persistence = 0.5f, NoiseType type = NoiseType_Perlin, Executor *executor = nullptr)
+	{
+		__1::fillNoise2DParallel(out, width, height, origin, step, octaves, persistence, type, __1::defaultNoiseTables(), executor);
+	}
+
+	/*!
+	Fills a grid with the noise of a generator using several threads, giving
+	the same result as generator.fillNoise2D. See
+	fillNoise2DParallel(float *, size_t, size_t, const Vector2 &, const Vector2 &, int, float, NoiseType, Executor *).
+
+	@param generator The generator to compute noise with.
+	*/
+	inline void fillNoise2DParallel(const NoiseGenerator &generator, float *out, size_t width, size_t height,
+		const Vector2 &origin, const Vector2 &step, int octaves = 1, float persistence = 0.5f, NoiseType type = NoiseType_Perlin,
+		Executor *executor = nullptr)
+	{
+		__1::fillNoise2DParallel(out, width, height, origin, step, octaves, persistence, type,
+			{ generator.permutation(), &generator.gradients() }, executor);
+	}
+}
@@ -16,8 +16,21 @@
 #include "quat/quaternion.h"
 
 #include "vec/vec_impl.h"
+#include "vec/vec_expr.h"
+#include "vec/vec_stream.h"
+#include "simd/simd_math.h"
+#include "simd/simd_vector.h"
+#include "math/f_math_precision.h"
+#include "math/noise_batch.h"
+#include "math/noise_generator.h"
+#include "math/noise_fractal.h"
 #include "mat/mat_impl.h"
+#include "mat/mat_expr.h"
+#include "mat/dynamic_matrix.h"
 #include "quat/quaternion_impl.h"
+#include "quat/quat_stream.h"
+#include "quat/dual_quaternion.h"
+#include "quat/transform.h"
 
 #if _WIN32
 #pragma warning(pop)
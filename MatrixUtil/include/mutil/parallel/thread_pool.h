@@ -0,0 +1,222 @@
+/*!
+\file
+Contains the executors used by the parallel batch functions. Executor is the
+interface a program can implement to run the work on its own threads, and
+ThreadPool is a small work-stealing implementation of it.
+
+Not included by mutil.h. Requires linking against the platform thread library,
+which the MatrixUtil CMake target does.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mutil
+{
+	/*!
+	Runs independent tasks on some set of threads.
+	*/
+	class Executor
+	{
+	public:
+		virtual ~Executor() = default;
+
+		/*!
+		Calls task(i) once for every i in [0, count), in any order and on any
+		thread, and returns once every call has finished. task must not throw.
+
+		@param count The number of tasks.
+		@param task The function to call for each task.
+		*/
+		virtual void parallelFor(size_t count, const std::function<void(size_t)> &task) = 0;
+	};
+
+	/*!
+	A fixed set of worker threads. The tasks of a parallelFor are split evenly
+	between the workers and the calling thread, and a thread which runs out of
+	tasks takes the last ones of another.
+
+	Calls to parallelFor from different threads are run one after another, and
+	calls made from inside a task run on the calling thread.
+	*/
+	class ThreadPool : public Executor
+	{
+	public:
+		/*!
+		Starts the worker threads.
+
+		@param threads The total number of threads running tasks, including the
+		thread calling parallelFor. If 0, std::thread::hardware_concurrency() is
+		used.
+		*/
+		explicit ThreadPool(size_t threads = 0) :
+			_queues(threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency()))
+		{
+			for (size_t i = 1; i < _queues.size(); i++)
+				_workers.emplace_back(&ThreadPool::workerMain, this, i);
+		}
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			_wake.notify_all();
+
+			for (std::thread &t : _workers)
+				t.join();
+		}
+
+		/*!
+		@return The number of threads running tasks, including the caller.
+		*/
+		size_t threadCount() const { return _queues.size(); }
+
+		void parallelFor(size_t count, const std::function<void(size_t)> &task) override
+		{
+			if (count == 0)
+				return;
+
+			if (count == 1 || _queues.size() == 1 || currentPool() == this)
+			{
+				for (size_t i = 0; i < count; i++)
+					task(i);
+				return;
+			}
+
+			std::lock_guard<std::mutex> submit(_submit);
+
+			_task = &task;
+			_remaining.store(count, std::memory_order_relaxed);
+
+			// queue i gets the tasks [count * i / n, count * (i + 1) / n)
+			const size_t n = _queues.size();
+			for (size_t i = 0; i < n; i++)
+			{
+				std::lock_guard<std::mutex> lock(_queues[i].mutex);
+				_queues[i].begin = count * i / n;
+				_queues[i].end = count * (i + 1) / n;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_generation++;
+			}
+			_wake.notify_all();
+
+			ThreadPool *previous = currentPool();
+			currentPool() = this;
+			work(0);
+			currentPool() = previous;
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			_done.wait(lock, [this]() { return _remaining.load(std::memory_order_acquire) == 0; });
+		}
+
+		/*!
+		@return A pool shared by the whole program, with one thread per hardware
+		thread. Created on first use.
+		*/
+		static ThreadPool &global()
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+
+	private:
+		// The tasks [begin, end) not yet taken. The owner takes from the front and
+		// other threads steal from the back.
+		struct Queue
+		{
+			std::mutex mutex;
+			size_t begin = 0;
+			size_t end = 0;
+		};
+
+		std::vector<Queue> _queues;
+		std::vector<std::thread> _workers;
+
+		std::mutex _submit;
+		const std::function<void(size_t)> *_task = nullptr;
+		std::atomic<size_t> _remaining{ 0 };
+
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _done;
+		size_t _generation = 0;
+		bool _stop = false;
+
+		static ThreadPool *&currentPool()
+		{
+			static thread_local ThreadPool *pool = nullptr;
+			return pool;
+		}
+
+		bool take(size_t queue, bool front, size_t &index)
+		{
+			Queue &q = _queues[queue];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (q.begin == q.end)
+				return false;
+
+			index = front ? q.begin++ : --q.end;
+			return true;
+		}
+
+		// Runs tasks from queue self, then from the others, until none are left
+		void work(size_t self)
+		{
+			const size_t n = _queues.size();
+			size_t index;
+
+			for (;;)
+			{
+				bool found = take(self, true, index);
+				for (size_t i = 1; !found && i < n; i++)
+					found = take((self + i) % n, false, index);
+
+				if (!found)
+					return;
+
+				(*_task)(index);
+
+				if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					_done.notify_all();
+				}
+			}
+		}
+
+		void workerMain(size_t self)
+		{
+			currentPool() = this;
+
+			size_t seen = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_wake.wait(lock, [&]() { return _stop || _generation != seen; });
+					if (_stop)
+						return;
+					seen = _generation;
+				}
+
+				work(self);
+			}
+		}
+	};
+}
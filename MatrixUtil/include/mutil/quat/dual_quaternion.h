@@ -0,0 +1,329 @@
+/*!
+\file
+Contains DualQuaternion, which represents a rotation and a translation, and
+dual quaternion skinning.
+*/
+
+#pragma once
+
+#include "quaternion_impl.h"
+#include "../simd/simd.h"
+
+namespace mutil
+{
+	/*!
+	A dual quaternion real + e * dual, where e * e = 0. When real is a unit
+	quaternion and dual = 0.5 * t * real for a translation t, written as a
+	quaternion with a real part of 0, it represents rotating by real and then
+	translating by t.
+
+	Dual quaternions compose like matrices, a * b transforms by b and then by a.
+	Unlike matrices they blend well: a weighted sum of rigid transforms,
+	normalized, is still a rigid transform, which avoids the collapsing joints
+	of linear blend skinning with matrices.
+	*/
+	class DualQuaternion
+	{
+	public:
+		Quaternion real;
+		Quaternion dual;
+
+		constexpr DualQuaternion() : real(), dual(0.0f, 0.0f, 0.0f, 0.0f) {}
+		constexpr DualQuaternion(const Quaternion &real, const Quaternion &dual) : real(real), dual(dual) {}
+		inline DualQuaternion(const Quaternion &rotation, const Vector3 &translation);
+
+		constexpr DualQuaternion &operator+=(const DualQuaternion &a)
+		{
+			real += a.real;
+			dual += a.dual;
+			return *this;
+		}
+
+		constexpr DualQuaternion &operator*=(float a)
+		{
+			real *= a;
+			dual *= a;
+			return *this;
+		}
+
+		inline DualQuaternion &operator*=(const DualQuaternion &a);
+
+		inline Vector3 translation() const;
+	};
+
+	constexpr DualQuaternion operator+(const DualQuaternion &a, const DualQuaternion &b) { return DualQuaternion(a.real + b.real, a.dual + b.dual); }
+	constexpr DualQuaternion operator-(const DualQuaternion &a, const DualQuaternion &b) { return DualQuaternion(a.real - b.real, a.dual - b.dual); }
+	constexpr DualQuaternion operator*(const DualQuaternion &a, float s) { return DualQuaternion(a.real * s, a.dual * s); }
+	constexpr DualQuaternion operator*(float s, const DualQuaternion &a) { return a * s; }
+	constexpr DualQuaternion operator-(const DualQuaternion &a) { return DualQuaternion(-a.real, -a.dual); }
+
+	inline DualQuaternion operator*(const DualQuaternion &a, const DualQuaternion &b)
+	{
+		return DualQuaternion(a.real * b.real, a.real * b.dual + a.dual * b.real);
+	}
+
+	inline DualQuaternion::DualQuaternion(const Quaternion &rotation, const Vector3 &translation) :
+		real(rotation), dual(Quaternion(0.0f, translation) * rotation * 0.5f)
+	{
+	}
+
+	inline DualQuaternion &DualQuaternion::operator*=(const DualQuaternion &a)
+	{
+		return *this = *this * a;
+	}
+
+	/*!
+	@param a A unit dual quaternion.
+
+	@return The inverse of a, which takes the conjugates of both parts.
+	*/
+	constexpr DualQuaternion conjugate(const DualQuaternion &a)
+	{
+		return DualQuaternion(conjugate(a.real), conjugate(a.dual));
+	}
+
+	/*!
+	Makes a dual quaternion unit length, so it represents a rigid transform.
+	Both parts are divided by the length of the real part, and the part of dual
+	which is not orthogonal to real is removed.
+
+	@param a The dual quaternion to normalize. The real part must not be 0.
+
+	@return The normalized dual quaternion.
+	*/
+	inline DualQuaternion normalize(const DualQuaternion &a)
+	{
+		const float inv = 1.0f / mutil::sqrt(dot(a.real, a.real));
+		const Quaternion real = a.real * inv;
+		const Quaternion dual = a.dual * inv;
+		return DualQuaternion(real, dual - real * dot(real, dual));
+	}
+
+	/*!
+	@param a A unit dual quaternion.
+
+	@return The translation of a.
+	*/
+	inline Vector3 translation(const DualQuaternion &a)
+	{
+		return imag(a.dual * conjugate(a.real)) * 2.0f;
+	}
+
+	inline Vector3 DualQuaternion::translation() const { return mutil::translation(*this); }
+
+	/*!
+	Transforms a point, rotating and then translating it.
+
+	@param a A unit dual quaternion.
+	@param p The point to transform.
+
+	@return The transformed point.
+	*/
+	inline Vector3 transformpoint(const DualQuaternion &a, const Vector3 &p)
+	{
+		return rotatevector(a.real, p) + translation(a);
+	}
+
+	/*!
+	Transforms a direction, which is only rotated.
+
+	@param a A unit dual quaternion.
+	@param v The direction to transform.
+
+	@return The rotated direction.
+	*/
+	inline Vector3 transformvector(const DualQuaternion &a, const Vector3 &v)
+	{
+		return rotatevector(a.real, v);
+	}
+
+	/*!
+	Converts a unit dual quaternion into the equivalent matrix.
+
+	@param a A unit dual quaternion.
+
+	@return A matrix which rotates by a.real and then translates.
+	*/
+	inline Matrix4 totransform(const DualQuaternion &a)
+	{
+		Matrix4 m = torotation(a.real);
+		const Vector3 t = translation(a);
+		m._14 = t.x;
+		m._24 = t.y;
+		m._34 = t.z;
+		return m;
+	}
+
+	/*!
+	Converts a matrix made of only a rotation and a translation into a dual
+	quaternion, the inverse of totransform.
+
+	@param m The matrix. The upper 3x3 must be a rotation, without scale.
+
+	@return The unit dual quaternion representing the transform.
+	*/
+	inline DualQuaternion fromtransform(const Matrix4 &m)
+	{
+		return DualQuaternion(fromrotation(m), Vector3(m._14, m._24, m._34));
+	}
+
+	/*!
+	Screw linear interpolation, which moves between two rigid transforms along
+	the screw motion joining them: a rotation about an axis and a translation
+	along it, both at a constant rate. It is to dual quaternions what slerp is
+	to quaternions, and takes the shorter path.
+
+	@param a The transform at t = 0, a unit dual quaternion.
+	@param b The transform at t = 1, a unit dual quaternion.
+	@param t The interpolation factor.
+
+	@return The interpolated transform.
+	*/
+	inline DualQuaternion sclerp(const DualQuaternion &a, const DualQuaternion &b, float t)
+	{
+		// a * (a' * b)^t, where the power is taken from the screw parameters
+		// of the difference: the angle and pitch scale by t, the axis and its
+		// moment do not
+		const DualQuaternion diff = conjugate(a) * (dot(a.real, b.real) < 0.0f ? -b : b);
+
+		const Vector3 v = imag(diff.real);
+		const float s = length(v);
+
+		// no rotation, only a translation to scale
+		if (s < 1e-6f)
+			return a * DualQuaternion(Quaternion(), Quaternion(0.0f, imag(diff.dual) * t));
+
+		const float theta = 2.0f * atan2f(s, diff.real.w);
+		const Vector3 axis = v / s;
+		const float pitch = -2.0f * diff.dual.w / s;
+		const Vector3 moment = (imag(diff.dual) - axis * (pitch * 0.5f * diff.real.w)) / s;
+
+		const float halfAngle = theta * t * 0.5f;
+		const float halfPitch = pitch * t * 0.5f;
+		const float sinHalf = sinf(halfAngle);
+		const float cosHalf = cosf(halfAngle);
+
+		const DualQuaternion power(
+			Quaternion(cosHalf, axis * sinHalf),
+			Quaternion(-halfPitch * sinHalf, moment * sinHalf + axis * (halfPitch * cosHalf)));
+
+		return a * power;
+	}
+
+	/*!
+	The joints which move a vertex during skinning and their weights. Unused
+	influences should have a weight of 0.
+	*/
+	struct SkinInfluence
+	{
+		uint32_t joints[4];
+		float weights[4];
+	};
+
+	namespace __1
+	{
+		// Vertices blended before they are transformed together
+		constexpr size_t kSkinBatch = 64;
+
+		// Blends the joints of one vertex into element i of the eight arrays in
+		// blend. Joints in the opposite hemisphere of the first are negated, as
+		// q and -q are the same rotation but would cancel out in the sum.
+		MUTIL_FORCEINLINE void blendJoints(const DualQuaternion *joints, const SkinInfluence &v, float (*blend)[kSkinBatch], size_t i)
+		{
+			const Quaternion &pivot = joints[v.joints[0]].real;
+
+			DualQuaternion sum(Quaternion(0.0f, 0.0f, 0.0f, 0.0f), Quaternion(0.0f, 0.0f, 0.0f, 0.0f));
+			for (size_t k = 0; k < 4; k++)
+			{
+				const DualQuaternion &joint = joints[v.joints[k]];
+				const float w = dot(joint.real, pivot) < 0.0f ? -v.weights[k] : v.weights[k];
+				sum.real += joint.real * w;
+				sum.dual += joint.dual * w;
+			}
+
+			for (size_t k = 0; k < 4; k++)
+			{
+				blend[k][i] = sum.real[k];
+				blend[k + 4][i] = sum.dual[k];
+			}
+		}
+	}
+
+	/*!
+	Skins vertices with dual quaternion blending. The transforms of the joints
+	influencing each vertex are blended by their weights and normalized, and the
+	vertex is transformed by the result.
+
+	Vertices are processed in batches, the transforms of a batch being blended
+	one vertex at a time and then applied to the whole batch using SIMD
+	instructions.
+
+	@param joints The transform of each joint, unit dual quaternions. Usually
+	the product of the pose of the joint and the inverse of its bind pose.
+	@param influences The joints influencing each vertex. The weights of each
+	vertex should sum to 1.
+	@param positions The positions of the vertices in the bind pose.
+	@param outPositions Receives the skinned positions. May be positions.
+	@param count The number of vertices.
+	@param normals The normals of the vertices in the bind pose, or null if
+	there are none.
+	@param outNormals Receives the skinned normals, if normals is not null. May
+	be normals.
+	*/
+	inline void skinDualQuaternion(const DualQuaternion *joints, const SkinInfluence *influences, const Vector3 *positions,
+		Vector3 *outPositions, size_t count, const Vector3 *normals = nullptr, Vector3 *outNormals = nullptr)
+	{
+		using namespace __1;
+
+		alignas(MUTIL_STREAM_ALIGNMENT) float blend[8][kSkinBatch];
+
+		for (size_t base = 0; base < count; base += kSkinBatch)
+		{
+			const size_t n = count - base < kSkinBatch ? count - base : kSkinBatch;
+
+			for (size_t i = 0; i < n; i++)
+				blendJoints(joints, influences[base + i], blend, i);
+
+			streamFor(n, [&](auto lane, size_t i) {
+				using V = decltype(lane);
+
+				V rw = vload(lane, blend[0] + i);
+				V rx = vload(lane, blend[1] + i);
+				V ry = vload(lane, blend[2] + i);
+				V rz = vload(lane, blend[3] + i);
+				V dw = vload(lane, blend[4] + i);
+				V dx = vload(lane, blend[5] + i);
+				V dy = vload(lane, blend[6] + i);
+				V dz = vload(lane, blend[7] + i);
+
+				const V inv = vdiv(vset1(lane, 1.0f), vsqrt(vfmadd(rw, rw, vfmadd(rx, rx, vfmadd(ry, ry, vmul(rz, rz))))));
+				rw = vmul(rw, inv);
+				rx = vmul(rx, inv);
+				ry = vmul(ry, inv);
+				rz = vmul(rz, inv);
+				dw = vmul(dw, inv);
+				dx = vmul(dx, inv);
+				dy = vmul(dy, inv);
+				dz = vmul(dz, inv);
+
+				// translation = 2 * imag(dual * conjugate(real))
+				//             = 2 * (rw * d - dw * r + cross(r, d))
+				V tx = vfnmadd(dw, rx, vfmadd(rw, dx, vfnmadd(rz, dy, vmul(ry, dz))));
+				V ty = vfnmadd(dw, ry, vfmadd(rw, dy, vfnmadd(rx, dz, vmul(rz, dx))));
+				V tz = vfnmadd(dw, rz, vfmadd(rw, dz, vfnmadd(ry, dx, vmul(rx, dy))));
+
+				V x, y, z;
+				vload3(lane, (const float *)(positions + base + i), x, y, z);
+				vrotate(rw, rx, ry, rz, x, y, z);
+				vstore3((float *)(outPositions + base + i), vadd(x, vadd(tx, tx)), vadd(y, vadd(ty, ty)), vadd(z, vadd(tz, tz)));
+
+				if (normals)
+				{
+					vload3(lane, (const float *)(normals + base + i), x, y, z);
+					vrotate(rw, rx, ry, rz, x, y, z);
+					vstore3((float *)(outNormals + base + i), x, y, z);
+				}
+			});
+		}
+	}
+}
@@ -0,0 +1,361 @@
+/*!
+\file
+Contains QuaternionStream, a structure-of-arrays container of quaternions, and
+the batched interpolation functions which operate on it and on arrays of
+quaternions.
+*/
+
+#pragma once
+
+#include "quaternion_impl.h"
+#include "../simd/simd_math.h"
+#include "../vec/vec_stream.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		struct QuaternionComponents
+		{
+			union
+			{
+				struct { float *w, *x, *y, *z; };
+				float *data[4];
+			};
+		};
+	}
+
+	/*!
+	A structure-of-arrays container of quaternions, laid out like a
+	Vector4Stream with the arrays named w, x, y and z.
+	*/
+	class QuaternionStream : public VectorStream<4, __1::QuaternionComponents>
+	{
+	public:
+		using VectorStream<4, __1::QuaternionComponents>::VectorStream;
+
+		Quaternion get(size_t i) const { return Quaternion(w[i], x[i], y[i], z[i]); }
+
+		void set(size_t i, const Quaternion &q)
+		{
+			w[i] = q.w;
+			x[i] = q.x;
+			y[i] = q.y;
+			z[i] = q.z;
+		}
+	};
+
+	namespace __1
+	{
+		static_assert(sizeof(Quaternion) == 4 * sizeof(float), "quaternions are loaded as 4 packed floats");
+
+		// Above this dot product slerp falls back to nlerp, as the sine of the
+		// angle between the quaternions is too small to divide by
+		constexpr float kSlerpParallel = 0.9995f;
+
+		// Normalizes the quaternion (w, x, y, z)
+		template <typename V>
+		MUTIL_FORCEINLINE void vnormalize4(V *q)
+		{
+			const V r = vrsqrt(vfmadd(q[0], q[0], vfmadd(q[1], q[1], vfmadd(q[2], q[2], vmul(q[3], q[3])))));
+			for (size_t k = 0; k < 4; k++)
+				q[k] = vmul(q[k], r);
+		}
+
+		// out = a * l + b * r
+		template <typename V>
+		MUTIL_FORCEINLINE void vblend4(const V *a, const V *b, V l, V r, V *out)
+		{
+			for (size_t k = 0; k < 4; k++)
+				out[k] = vfmadd(a[k], l, vmul(b[k], r));
+		}
+
+		// The dot product of a and b, with b negated where it is negative so the
+		// shorter arc is taken. sign receives the factor b was multiplied by.
+		template <typename V>
+		MUTIL_FORCEINLINE V vshortestDot(const V *a, const V *b, V &sign)
+		{
+			const V d = vfmadd(a[0], b[0], vfmadd(a[1], b[1], vfmadd(a[2], b[2], vmul(a[3], b[3]))));
+			const V one = vset1(d, 1.0f);
+			sign = vselect(vlt(d, vset1(d, 0.0f)), vneg(one), one);
+			return vabs(d);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE void vslerp(const V *a, const V *b, V t, V *out)
+		{
+			V sign;
+			const V d = vshortestDot(a, b, sign);
+			const V one = vset1(d, 1.0f);
+			const V s = vsqrt(vmax(vfnmadd(d, d, one), vset1(d, 0.0f)));
+			const V theta = vatan2(s, d);
+			const V inv = vdiv(one, s);
+
+			const auto parallel = vgt(d, vset1(d, kSlerpParallel));
+			const V l = vselect(parallel, vsub(one, t), vmul(vsin(vmul(vsub(one, t), theta)), inv));
+			const V r = vselect(parallel, t, vmul(vsin(vmul(t, theta)), inv));
+
+			vblend4(a, b, l, vmul(r, sign), out);
+
+			V n[4] = { out[0], out[1], out[2], out[3] };
+			vnormalize4(n);
+			for (size_t k = 0; k < 4; k++)
+				out[k] = vselect(parallel, n[k], out[k]);
+		}
+
+		// On scalar lanes only the branch that is taken is computed
+		MUTIL_FORCEINLINE void vslerp(const float *a, const float *b, float t, float *out)
+		{
+			float sign;
+			const float d = vshortestDot(a, b, sign);
+
+			if (d > kSlerpParallel)
+			{
+				vblend4(a, b, 1.0f - t, t * sign, out);
+				vnormalize4(out);
+				return;
+			}
+
+			const float theta = acosf(d);
+			const float inv = 1.0f / sinf(theta);
+			vblend4(a, b, sinf((1.0f - t) * theta) * inv, sinf(t * theta) * inv * sign, out);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE void vnlerp(const V *a, const V *b, V t, V *out)
+		{
+			const V one = vset1(t, 1.0f);
+			vblend4(a, b, vsub(one, t), t, out);
+			vnormalize4(out);
+		}
+
+		// nlerp with t adjusted by a polynomial in t and the angle between a and b
+		// so that the angle moves at nearly constant speed, see slerpFast
+		template <typename T>
+		MUTIL_FORCEINLINE T slerpFastT(T d, T t)
+		{
+			const T half = vsub(t, vset1(t, 0.5f));
+			const T A = vfmadd(d, vfmadd(d, vfmadd(d, vset1(d, -1.43519f), vset1(d, 3.55645f)), vset1(d, -3.2452f)), vset1(d, 1.0904f));
+			const T B = vfmadd(d, vfmadd(d, vset1(d, 0.215638f), vset1(d, -1.06021f)), vset1(d, 0.848013f));
+			const T k = vfmadd(vmul(A, half), half, B);
+			return vfmadd(vmul(vmul(t, half), vsub(t, vset1(t, 1.0f))), k, t);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE void vslerpFast(const V *a, const V *b, V t, V *out)
+		{
+			V sign;
+			const V d = vshortestDot(a, b, sign);
+			const V u = slerpFastT(d, t);
+			vblend4(a, b, vsub(vset1(d, 1.0f), u), vmul(u, sign), out);
+			vnormalize4(out);
+		}
+
+		/*
+		Interpolates count pairs of quaternions with f(a, b, t, out).
+		load(lane, i, q) loads the quaternions starting at i from an input, and
+		store(i, q) stores the results starting at i.
+		*/
+		template <typename F, typename LoadA, typename LoadB, typename Store>
+		inline void quaternionInterpolate(size_t count, const float *t, LoadA loadA, LoadB loadB, Store store, F f)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				decltype(lane) a[4], b[4], out[4];
+				loadA(lane, i, a);
+				loadB(lane, i, b);
+				f(a, b, vloadu(lane, t + i), out);
+				store(i, out);
+			});
+		}
+
+		inline auto loadQuaternions(const Quaternion *q)
+		{
+			return [q](auto lane, size_t i, decltype(lane) *v) {
+				vload4(lane, (const float *)(q + i), v[0], v[1], v[2], v[3]);
+			};
+		}
+
+		// The stream versions copy the pointers, which would otherwise be reloaded
+		// after every store
+		inline auto loadQuaternions(const QuaternionStream &q)
+		{
+			return [w = q.w, x = q.x, y = q.y, z = q.z](auto lane, size_t i, decltype(lane) *v) {
+				v[0] = vload(lane, w + i);
+				v[1] = vload(lane, x + i);
+				v[2] = vload(lane, y + i);
+				v[3] = vload(lane, z + i);
+			};
+		}
+
+		inline auto storeQuaternions(Quaternion *q)
+		{
+			return [q](size_t i, const auto *v) {
+				vstore4((float *)(q + i), v[0], v[1], v[2], v[3]);
+			};
+		}
+
+		inline auto storeQuaternions(QuaternionStream &q)
+		{
+			return [w = q.w, x = q.x, y = q.y, z = q.z](size_t i, const auto *v) {
+				vstore(w + i, v[0]);
+				vstore(x + i, v[1]);
+				vstore(y + i, v[2]);
+				vstore(z + i, v[3]);
+			};
+		}
+
+		// The interpolation kernels, as objects so they can be passed to
+		// quaternionInterpolate before the register type is known
+		struct SlerpKernel
+		{
+			template <typename V>
+			MUTIL_FORCEINLINE void operator()(const V *a, const V *b, V t, V *out) const { vslerp(a, b, t, out); }
+		};
+
+		struct NlerpKernel
+		{
+			template <typename V>
+			MUTIL_FORCEINLINE void operator()(const V *a, const V *b, V t, V *out) const { vnlerp(a, b, t, out); }
+		};
+
+		struct SlerpFastKernel
+		{
+			template <typename V>
+			MUTIL_FORCEINLINE void operator()(const V *a, const V *b, V t, V *out) const { vslerpFast(a, b, t, out); }
+		};
+	}
+
+	/*!
+	Approximates slerp by nlerp with a corrected interpolation factor, which is
+	several times faster. For unit quaternions, the rotation it gives differs
+	from that of slerp(a, b, t) by at most 8e-4 radians.
+
+	@param a The quaternion at t = 0.
+	@param b The quaternion at t = 1.
+	@param t The interpolation factor, in [0, 1].
+
+	@return The interpolated unit quaternion.
+	*/
+	inline Quaternion slerpFast(const Quaternion &a, const Quaternion &b, float t)
+	{
+		const float d = dot(a, b);
+		const float u = __1::slerpFastT(mutil::abs(d), t);
+		const Quaternion q = lerp(a, d < 0.0f ? -b : b, u);
+		return q / mutil::sqrt(dot(q, q));
+	}
+
+	/*!
+	Converts an array of quaternions into a stream.
+
+	@param src The quaternions to convert.
+	@param count The number of quaternions in src.
+	@param dst The stream to write to. It is resized to count.
+	*/
+	inline void gather(const Quaternion *src, size_t count, QuaternionStream &dst)
+	{
+		dst.resize(count);
+		__1::streamGather4((const Vector4 *)src, count, dst.data);
+	}
+
+	/*!
+	Converts a stream back into an array of quaternions.
+
+	@param src The stream to convert.
+	@param dst The array to write to. Must hold at least src.size() quaternions.
+	*/
+	inline void scatter(const QuaternionStream &src, Quaternion *dst)
+	{
+		__1::streamScatter4(src.data, src.size(), (Vector4 *)dst);
+	}
+
+	/*!
+	Spherically interpolates between pairs of unit quaternions along the shorter
+	arc, equivalent to out[i] = slerp(a[i], b[i], t[i]). Nearly equal pairs are
+	interpolated with nlerp.
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1.
+	@param t The interpolation factor of each pair.
+	@param out Receives the interpolated quaternions. May be a or b.
+	@param n The number of pairs.
+	*/
+	inline void slerpMany(const Quaternion *a, const Quaternion *b, const float *t, Quaternion *out, size_t n)
+	{
+		__1::quaternionInterpolate(n, t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::SlerpKernel());
+	}
+
+	/*!
+	Linearly interpolates between pairs of quaternions and normalizes the
+	results, equivalent to out[i] = nlerp(a[i], b[i], t[i]).
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1.
+	@param t The interpolation factor of each pair.
+	@param out Receives the interpolated quaternions. May be a or b.
+	@param n The number of pairs.
+	*/
+	inline void nlerpMany(const Quaternion *a, const Quaternion *b, const float *t, Quaternion *out, size_t n)
+	{
+		__1::quaternionInterpolate(n, t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::NlerpKernel());
+	}
+
+	/*!
+	Approximately spherically interpolates between pairs of unit quaternions,
+	equivalent to out[i] = slerpFast(a[i], b[i], t[i]).
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1.
+	@param t The interpolation factor of each pair.
+	@param out Receives the interpolated quaternions. May be a or b.
+	@param n The number of pairs.
+	*/
+	inline void slerpFastMany(const Quaternion *a, const Quaternion *b, const float *t, Quaternion *out, size_t n)
+	{
+		__1::quaternionInterpolate(n, t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::SlerpFastKernel());
+	}
+
+	/*!
+	Spherically interpolates between the quaternions of two streams, see
+	slerpMany.
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1, with at least a.size() elements.
+	@param t The interpolation factor of each pair, with at least a.size() elements.
+	@param out Receives the interpolated quaternions. It is resized to a.size().
+	*/
+	inline void slerp(const QuaternionStream &a, const QuaternionStream &b, const float *t, QuaternionStream &out)
+	{
+		out.resize(a.size());
+		__1::quaternionInterpolate(a.size(), t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::SlerpKernel());
+	}
+
+	/*!
+	Linearly interpolates between the quaternions of two streams and normalizes
+	the results, see nlerpMany.
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1, with at least a.size() elements.
+	@param t The interpolation factor of each pair, with at least a.size() elements.
+	@param out Receives the interpolated quaternions. It is resized to a.size().
+	*/
+	inline void nlerp(const QuaternionStream &a, const QuaternionStream &b, const float *t, QuaternionStream &out)
+	{
+		out.resize(a.size());
+		__1::quaternionInterpolate(a.size(), t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::NlerpKernel());
+	}
+
+	/*!
+	Approximately spherically interpolates between the quaternions of two
+	streams, see slerpFastMany.
+
+	@param a The quaternions at t = 0.
+	@param b The quaternions at t = 1, with at least a.size() elements.
+	@param t The interpolation factor of each pair, with at least a.size() elements.
+	@param out Receives the interpolated quaternions. It is resized to a.size().
+	*/
+	inline void slerpFast(const QuaternionStream &a, const QuaternionStream &b, const float *t, QuaternionStream &out)
+	{
+		out.resize(a.size());
+		__1::quaternionInterpolate(a.size(), t, __1::loadQuaternions(a), __1::loadQuaternions(b), __1::storeQuaternions(out), __1::SlerpFastKernel());
+	}
+}
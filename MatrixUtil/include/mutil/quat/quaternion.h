@@ -64,15 +64,7 @@ namespace mutil
 			return *this;
 		}
 
-		constexpr Quaternion &operator*=(const Quaternion &a)
-		{
-			Quaternion tmp = *this;
-			w = tmp.w * a.w - tmp.x * a.x - tmp.y * a.y - tmp.z * a.z;
-			x = tmp.w * a.x + tmp.x * a.w + tmp.y * a.z - tmp.z * a.y;
-			y = tmp.w * a.y + tmp.y * a.w + tmp.z * a.x - tmp.x * a.z;
-			z = tmp.w * a.z + tmp.z * a.w + tmp.x * a.y - tmp.y * a.x;
-			return *this;
-		}
+		MUTIL_SIMD_CONSTEXPR Quaternion &operator*=(const Quaternion &a);
 
 		constexpr float &operator[](size_t idx) { return q[idx]; }
 		constexpr const float &operator[](size_t idx) const { return q[idx]; }
@@ -95,7 +87,7 @@ namespace mutil
 
 	constexpr Quaternion operator-(const Quaternion &a);
 
-	constexpr Quaternion operator*(const Quaternion &a, const Quaternion &b);
+	MUTIL_SIMD_CONSTEXPR Quaternion MUTIL_VECTORCALL operator*(const Quaternion &a, const Quaternion &b);
 
 	constexpr Vector3 imag(const Quaternion &q);
 
@@ -108,9 +100,12 @@ namespace mutil
 
 	constexpr Matrix4 torotation(const Quaternion &q);
 	constexpr Matrix3 torotation3(const Quaternion &q);
+	inline Quaternion fromrotation(const Matrix4 &m);
+	inline Quaternion fromrotation(const Matrix3 &m);
 
 	inline Quaternion rotateaxis(const Vector3 &axis, float angle);
 	inline Vector3 rotatevector(const Quaternion &q, const Vector3 &p);
+	inline void rotateVectors(const Quaternion &q, const Vector3 *in, Vector3 *out, size_t count);
 
 	inline Vector3 toeuler(const Quaternion &q);
 	inline Quaternion fromeuler(float x, float y, float z);
@@ -2,6 +2,7 @@
 
 #include "quaternion.h"
 #include "../math/math.h"
+#include "../simd/simd.h"
 
 namespace mutil
 {
@@ -13,13 +14,36 @@ namespace mutil
 
 	constexpr Quaternion operator-(const Quaternion &a) { return Quaternion(-a.w, -a.x, -a.y, -a.z); }
 
-	constexpr Quaternion operator*(const Quaternion &a, const Quaternion &b)
+	MUTIL_SIMD_CONSTEXPR Quaternion MUTIL_VECTORCALL operator*(const Quaternion &a, const Quaternion &b)
 	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		// Each component of a scales b with its lanes permuted and some of them
+		// negated, where (w, x, y, z) are the components of b:
+		//
+		//     a * b = a.w * ( w,  x,  y,  z)
+		//           + a.x * (-x,  w, -z,  y)
+		//           + a.y * (-y,  z,  w, -x)
+		//           + a.z * (-z, -y,  x,  w)
+		const vfloat4 va = vloadu(vfloat4(), a.q);
+		const vfloat4 vb = vloadu(vfloat4(), b.q);
+
+		vfloat4 r = vmul(vshuffle<0, 0, 0, 0>(va, va), vb);
+		r = vfmadd(vmul(vshuffle<1, 1, 1, 1>(va, va), vsetr(vfloat4(), -1.0f, 1.0f, -1.0f, 1.0f)), vshuffle<1, 0, 3, 2>(vb, vb), r);
+		r = vfmadd(vmul(vshuffle<2, 2, 2, 2>(va, va), vsetr(vfloat4(), -1.0f, 1.0f, 1.0f, -1.0f)), vshuffle<2, 3, 0, 1>(vb, vb), r);
+		r = vfmadd(vmul(vshuffle<3, 3, 3, 3>(va, va), vsetr(vfloat4(), -1.0f, -1.0f, 1.0f, 1.0f)), vshuffle<3, 2, 1, 0>(vb, vb), r);
+
+		Quaternion result;
+		vstoreu(result.q, r);
+		return result;
+#else
 		return Quaternion(
 			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
 			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
 			a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z,
 			a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x);
+#endif
 	}
 
 	constexpr Vector3 imag(const Quaternion &q) { return Vector3(q.x, q.y, q.z); }
@@ -90,6 +114,63 @@ namespace mutil
 			2 * xz - 2 * yw, 2 * yz + 2 * xw, 1 - 2 * x2 - 2 * y2);
 	}
 
+	namespace __1
+	{
+		// Shepperd's method: the largest of w, x, y and z is found from the
+		// diagonal, where it is accurate, and the others are divided by it
+		template <typename M>
+		inline Quaternion fromRotation(const M &m)
+		{
+			const float trace = m._11 + m._22 + m._33;
+
+			if (trace > 0.0f)
+			{
+				const float s = 0.5f / sqrtf(trace + 1.0f);
+				return Quaternion(0.25f / s, (m._32 - m._23) * s, (m._13 - m._31) * s, (m._21 - m._12) * s);
+			}
+
+			if (m._11 > m._22 && m._11 > m._33)
+			{
+				const float s = 0.5f / sqrtf(1.0f + m._11 - m._22 - m._33);
+				return Quaternion((m._32 - m._23) * s, 0.25f / s, (m._12 + m._21) * s, (m._13 + m._31) * s);
+			}
+
+			if (m._22 > m._33)
+			{
+				const float s = 0.5f / sqrtf(1.0f + m._22 - m._11 - m._33);
+				return Quaternion((m._13 - m._31) * s, (m._12 + m._21) * s, 0.25f / s, (m._23 + m._32) * s);
+			}
+
+			const float s = 0.5f / sqrtf(1.0f + m._33 - m._11 - m._22);
+			return Quaternion((m._21 - m._12) * s, (m._13 + m._31) * s, (m._23 + m._32) * s, 0.25f / s);
+		}
+	}
+
+	/*!
+	Converts the rotation in the upper 3x3 of a matrix into a quaternion, the
+	inverse of torotation.
+
+	@param m The matrix. The upper 3x3 must be a rotation, without scale.
+
+	@return The unit quaternion representing the rotation.
+	*/
+	inline Quaternion fromrotation(const Matrix4 &m)
+	{
+		return __1::fromRotation(m);
+	}
+
+	/*!
+	Converts a rotation matrix into a quaternion, the inverse of torotation3.
+
+	@param m The rotation matrix, without scale.
+
+	@return The unit quaternion representing the rotation.
+	*/
+	inline Quaternion fromrotation(const Matrix3 &m)
+	{
+		return __1::fromRotation(m);
+	}
+
 	inline Quaternion rotateaxis(const Vector3 &axis, float angle)
 	{
 		return Quaternion(
@@ -97,11 +178,56 @@ namespace mutil
 			sinf(angle / 2) * axis);
 	}
 
+	namespace __1
+	{
+		// Rotates (x, y, z) by the unit quaternion (qw, qx, qy, qz). Expanding
+		// q * p * q' gives
+		//
+		//     p' = p + qw * t + cross(q.xyz, t),  t = 2 * cross(q.xyz, p)
+		//
+		// which takes 15 multiplications in place of the 32 of two products.
+		template <typename V>
+		MUTIL_FORCEINLINE void vrotate(V qw, V qx, V qy, V qz, V &x, V &y, V &z)
+		{
+			V tx = vfnmadd(qz, y, vmul(qy, z));
+			V ty = vfnmadd(qx, z, vmul(qz, x));
+			V tz = vfnmadd(qy, x, vmul(qx, y));
+			tx = vadd(tx, tx);
+			ty = vadd(ty, ty);
+			tz = vadd(tz, tz);
+
+			x = vfmadd(qw, tx, vadd(x, vfnmadd(qz, ty, vmul(qy, tz))));
+			y = vfmadd(qw, ty, vadd(y, vfnmadd(qx, tz, vmul(qz, tx))));
+			z = vfmadd(qw, tz, vadd(z, vfnmadd(qy, tx, vmul(qx, ty))));
+		}
+	}
+
 	inline Vector3 rotatevector(const Quaternion &q, const Vector3 &p)
 	{
-		// q * p * q'
-		Quaternion r = q * Quaternion(0.0f, p) * conjugate(q);
-		return imag(r);
+		Vector3 r = p;
+		__1::vrotate(q.w, q.x, q.y, q.z, r.x, r.y, r.z);
+		return r;
+	}
+
+	/*!
+	Rotates many vectors by the same quaternion, equivalent to
+	out[i] = rotatevector(q, in[i]).
+
+	@param q The rotation, a unit quaternion.
+	@param in The vectors to rotate.
+	@param out Receives the rotated vectors. May be in.
+	@param count The number of vectors.
+	*/
+	inline void rotateVectors(const Quaternion &q, const Vector3 *in, Vector3 *out, size_t count)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) x, y, z;
+			vload3(lane, (const float *)(in + i), x, y, z);
+			vrotate(vset1(lane, q.w), vset1(lane, q.x), vset1(lane, q.y), vset1(lane, q.z), x, y, z);
+			vstore3((float *)(out + i), x, y, z);
+		});
 	}
 
 	inline Vector3 toeuler(const Quaternion &q)
@@ -153,7 +279,13 @@ namespace mutil
 
 	inline Quaternion slerpNotShortest(const Quaternion &a, const Quaternion &b, float t)
 	{
-		const float theta = acosf(dot(a, b)) / 2; // half angle between a and b
+		const float d = dot(a, b);
+
+		// nearly equal, sin(theta) is too small to divide by
+		if (d > 0.9995f)
+			return nlerp(a, b, t);
+
+		const float theta = acosf(d); // angle between a and b
 		const float stheta = sinf(theta);
 		const float l = sinf((1.0f - t) * theta);
 		const float r = sinf(t * theta);
@@ -221,6 +353,11 @@ namespace mutil
 		return mutil::normalize(*this);
 	}
 
+	MUTIL_SIMD_CONSTEXPR Quaternion &Quaternion::operator*=(const Quaternion &a)
+	{
+		return *this = *this * a;
+	}
+
 	constexpr Quaternion Quaternion::conjugate() const
 	{
 		return mutil::conjugate(*this);
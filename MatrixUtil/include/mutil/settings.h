@@ -17,6 +17,18 @@
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include <immintrin.h>
+#if __AVX__
+#define MUTIL_USE_AVX 1
+#endif
+#if __AVX2__
+#define MUTIL_USE_AVX2 1
+#endif
+#if __FMA__ || (_MSC_VER && __AVX2__)
+#define MUTIL_USE_FMA 1
+#endif
+#if __AVX512F__
+#define MUTIL_USE_AVX512 1
+#endif
 #endif
 #elif MUTIL_ARM || MUTIL_ARM64
 #if __ARM_NEON__
@@ -36,6 +48,14 @@
 #define MUTIL_RESTRICT __restrict__
 #endif
 
+// Functions with a SIMD implementation, which are constexpr only in builds
+// that use the scalar one instead.
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+#define MUTIL_SIMD_CONSTEXPR inline
+#else
+#define MUTIL_SIMD_CONSTEXPR constexpr
+#endif
+
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -0,0 +1,687 @@
+/*!
+\file
+Contains the lane-parallel float primitives used by the batched kernels.
+*/
+
+#pragma once
+
+#include "../settings.h"
+
+#include <cmath>
+#include <new>
+
+#if _WIN32
+#include <malloc.h>
+#endif
+
+// Several AVX-512 intrinsics in GCC 12's avx512fintrin.h start from a vector
+// initialized from itself, which -Wall reports wherever they are inlined. The
+// warnings are disabled for the wrappers below, and so for every caller.
+#if MUTIL_USE_AVX512 && __GNUC__ && !__clang__ && __GNUC__ < 13
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// Number of float lanes in the widest register available to the batched kernels.
+#if MUTIL_USE_AVX512
+#define MUTIL_SIMD_WIDTH 16
+#elif MUTIL_USE_AVX
+#define MUTIL_SIMD_WIDTH 8
+#elif MUTIL_USE_SSE || MUTIL_USE_NEON
+#define MUTIL_SIMD_WIDTH 4
+#else
+#define MUTIL_SIMD_WIDTH 1
+#endif
+
+// Alignment of stream storage, one cache line. Enough for any register width.
+#define MUTIL_STREAM_ALIGNMENT 64
+
+namespace mutil
+{
+	namespace __1
+	{
+		inline void *alignedAlloc(size_t size, size_t alignment)
+		{
+#if _WIN32
+			void *p = _aligned_malloc(size, alignment);
+#else
+			void *p = nullptr;
+			if (posix_memalign(&p, alignment, size) != 0)
+				p = nullptr;
+#endif
+			if (!p)
+				throw std::bad_alloc();
+			return p;
+		}
+
+		inline void alignedFree(void *p)
+		{
+#if _WIN32
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+
+		// Every operation is overloaded on the register type so that a kernel can
+		// be written once and run over any of them. Loads take a register of the
+		// wanted type as a tag since they cannot be selected by return type.
+
+		MUTIL_FORCEINLINE float vload(float, const float *p) { return *p; }
+		MUTIL_FORCEINLINE float vloadu(float, const float *p) { return *p; }
+		MUTIL_FORCEINLINE float vset1(float, float a) { return a; }
+		MUTIL_FORCEINLINE void vstore(float *p, float a) { *p = a; }
+		MUTIL_FORCEINLINE void vstoreu(float *p, float a) { *p = a; }
+
+		MUTIL_FORCEINLINE float vadd(float a, float b) { return a + b; }
+		MUTIL_FORCEINLINE float vsub(float a, float b) { return a - b; }
+		MUTIL_FORCEINLINE float vmul(float a, float b) { return a * b; }
+		MUTIL_FORCEINLINE float vdiv(float a, float b) { return a / b; }
+		MUTIL_FORCEINLINE float vfmadd(float a, float b, float c) { return a * b + c; }
+		MUTIL_FORCEINLINE float vfnmadd(float a, float b, float c) { return c - a * b; }
+		MUTIL_FORCEINLINE float vmin(float a, float b) { return a < b ? a : b; }
+		MUTIL_FORCEINLINE float vmax(float a, float b) { return a > b ? a : b; }
+		MUTIL_FORCEINLINE float vsqrt(float a) { return sqrtf(a); }
+		MUTIL_FORCEINLINE float vrsqrt(float a) { return 1.0f / sqrtf(a); }
+
+#if MUTIL_USE_SSE
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vload(__m128, const float *p) { return _mm_load_ps(p); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vloadu(__m128, const float *p) { return _mm_loadu_ps(p); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vset1(__m128, float a) { return _mm_set1_ps(a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore(float *p, __m128 a) { _mm_store_ps(p, a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstoreu(float *p, __m128 a) { _mm_storeu_ps(p, a); }
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vadd(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vsub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vmul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vdiv(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vmin(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vmax(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vsqrt(__m128 a) { return _mm_sqrt_ps(a); }
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vfmadd(__m128 a, __m128 b, __m128 c)
+		{
+#if MUTIL_USE_FMA
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vfnmadd(__m128 a, __m128 b, __m128 c)
+		{
+#if MUTIL_USE_FMA
+			return _mm_fnmadd_ps(a, b, c);
+#else
+			return _mm_sub_ps(c, _mm_mul_ps(a, b));
+#endif
+		}
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vrsqrt(__m128 a)
+		{
+			// estimate plus one Newton-Raphson step, ~22 bits
+			__m128 r = _mm_rsqrt_ps(a);
+			__m128 h = _mm_mul_ps(_mm_mul_ps(a, r), r);
+			return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), h));
+		}
+#endif
+
+#if MUTIL_USE_AVX
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vload(__m256, const float *p) { return _mm256_load_ps(p); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vloadu(__m256, const float *p) { return _mm256_loadu_ps(p); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vset1(__m256, float a) { return _mm256_set1_ps(a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore(float *p, __m256 a) { _mm256_store_ps(p, a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstoreu(float *p, __m256 a) { _mm256_storeu_ps(p, a); }
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vadd(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vsub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vmul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vdiv(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vmin(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vmax(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vsqrt(__m256 a) { return _mm256_sqrt_ps(a); }
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vfmadd(__m256 a, __m256 b, __m256 c)
+		{
+#if MUTIL_USE_FMA
+			return _mm256_fmadd_ps(a, b, c);
+#else
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+		}
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vfnmadd(__m256 a, __m256 b, __m256 c)
+		{
+#if MUTIL_USE_FMA
+			return _mm256_fnmadd_ps(a, b, c);
+#else
+			return _mm256_sub_ps(c, _mm256_mul_ps(a, b));
+#endif
+		}
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vrsqrt(__m256 a)
+		{
+			__m256 r = _mm256_rsqrt_ps(a);
+			__m256 h = _mm256_mul_ps(_mm256_mul_ps(a, r), r);
+			return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), r), _mm256_sub_ps(_mm256_set1_ps(3.0f), h));
+		}
+#endif
+
+#if MUTIL_USE_AVX512
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vload(__m512, const float *p) { return _mm512_load_ps(p); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vloadu(__m512, const float *p) { return _mm512_loadu_ps(p); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vset1(__m512, float a) { return _mm512_set1_ps(a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore(float *p, __m512 a) { _mm512_store_ps(p, a); }
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstoreu(float *p, __m512 a) { _mm512_storeu_ps(p, a); }
+
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vadd(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vsub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vmul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vdiv(__m512 a, __m512 b) { return _mm512_div_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vmin(__m512 a, __m512 b) { return _mm512_min_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vmax(__m512 a, __m512 b) { return _mm512_max_ps(a, b); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vsqrt(__m512 a) { return _mm512_sqrt_ps(a); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vfmadd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vfnmadd(__m512 a, __m512 b, __m512 c) { return _mm512_fnmadd_ps(a, b, c); }
+
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vrsqrt(__m512 a)
+		{
+			// rsqrt14 is already accurate to 14 bits, one step brings it to full precision
+			__m512 r = _mm512_rsqrt14_ps(a);
+			__m512 h = _mm512_mul_ps(_mm512_mul_ps(a, r), r);
+			return _mm512_mul_ps(_mm512_mul_ps(_mm512_set1_ps(0.5f), r), _mm512_sub_ps(_mm512_set1_ps(3.0f), h));
+		}
+
+		// Repeats the four floats at p in every 128-bit lane.
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vbroadcast4(__m512, const float *p) { return _mm512_broadcast_f32x4(_mm_loadu_ps(p)); }
+
+		// Element I of every 128-bit lane, repeated across that lane.
+		template <int I>
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vsplat4(__m512 a) { return _mm512_permute_ps(a, _MM_SHUFFLE(I, I, I, I)); }
+#endif
+
+#if MUTIL_USE_NEON
+		MUTIL_FORCEINLINE float32x4_t vload(float32x4_t, const float *p) { return vld1q_f32(p); }
+		MUTIL_FORCEINLINE float32x4_t vloadu(float32x4_t, const float *p) { return vld1q_f32(p); }
+		MUTIL_FORCEINLINE float32x4_t vset1(float32x4_t, float a) { return vdupq_n_f32(a); }
+		MUTIL_FORCEINLINE void vstore(float *p, float32x4_t a) { vst1q_f32(p, a); }
+		MUTIL_FORCEINLINE void vstoreu(float *p, float32x4_t a) { vst1q_f32(p, a); }
+
+		MUTIL_FORCEINLINE float32x4_t vadd(float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vsub(float32x4_t a, float32x4_t b) { return vsubq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vmul(float32x4_t a, float32x4_t b) { return vmulq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vdiv(float32x4_t a, float32x4_t b) { return vdivq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vmin(float32x4_t a, float32x4_t b) { return vminq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vmax(float32x4_t a, float32x4_t b) { return vmaxq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vsqrt(float32x4_t a) { return vsqrtq_f32(a); }
+		MUTIL_FORCEINLINE float32x4_t vfmadd(float32x4_t a, float32x4_t b, float32x4_t c) { return vmlaq_f32(c, a, b); }
+		MUTIL_FORCEINLINE float32x4_t vfnmadd(float32x4_t a, float32x4_t b, float32x4_t c) { return vmlsq_f32(c, a, b); }
+
+		MUTIL_FORCEINLINE float32x4_t vrsqrt(float32x4_t a)
+		{
+			float32x4_t r = vrsqrteq_f32(a);
+			r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+			return vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+		}
+#endif
+
+		// Interleaved loads and stores. vload3 reads one register's worth of
+		// consecutive (x, y, z) triples from p and splits them into one register
+		// per component, vstore3 does the reverse. vload4 and vstore4 do the
+		// same for (x, y, z, w). None of them require p to be aligned.
+
+		MUTIL_FORCEINLINE void vload3(float, const float *p, float &x, float &y, float &z)
+		{
+			x = p[0];
+			y = p[1];
+			z = p[2];
+		}
+
+		MUTIL_FORCEINLINE void vstore3(float *p, float x, float y, float z)
+		{
+			p[0] = x;
+			p[1] = y;
+			p[2] = z;
+		}
+
+		MUTIL_FORCEINLINE void vload4(float, const float *p, float &x, float &y, float &z, float &w)
+		{
+			x = p[0];
+			y = p[1];
+			z = p[2];
+			w = p[3];
+		}
+
+		MUTIL_FORCEINLINE void vstore4(float *p, float x, float y, float z, float w)
+		{
+			p[0] = x;
+			p[1] = y;
+			p[2] = z;
+			p[3] = w;
+		}
+
+#if MUTIL_USE_SSE
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload3(__m128, const float *p, __m128 &x, __m128 &y, __m128 &z)
+		{
+			// v0 = x0 y0 z0 x1, v1 = y1 z1 x2 y2, v2 = z2 x3 y3 z3
+			__m128 v0 = _mm_loadu_ps(p);
+			__m128 v1 = _mm_loadu_ps(p + 4);
+			__m128 v2 = _mm_loadu_ps(p + 8);
+
+			__m128 t = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2));
+			x = _mm_shuffle_ps(v0, t, _MM_SHUFFLE(2, 0, 3, 0));
+
+			t = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1));
+			__m128 u = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3));
+			y = _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0));
+
+			t = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2));
+			z = _mm_shuffle_ps(t, v2, _MM_SHUFFLE(3, 0, 2, 0));
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore3(float *p, __m128 x, __m128 y, __m128 z)
+		{
+			__m128 t = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 1, 0));
+			__m128 u = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+			_mm_storeu_ps(p, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+
+			t = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+			u = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+			_mm_storeu_ps(p + 4, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+
+			t = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+			u = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+			_mm_storeu_ps(p + 8, _mm_shuffle_ps(t, u, _MM_SHUFFLE(2, 0, 2, 0)));
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload4(__m128, const float *p, __m128 &x, __m128 &y, __m128 &z, __m128 &w)
+		{
+			x = _mm_loadu_ps(p);
+			y = _mm_loadu_ps(p + 4);
+			z = _mm_loadu_ps(p + 8);
+			w = _mm_loadu_ps(p + 12);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore4(float *p, __m128 x, __m128 y, __m128 z, __m128 w)
+		{
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(p, x);
+			_mm_storeu_ps(p + 4, y);
+			_mm_storeu_ps(p + 8, z);
+			_mm_storeu_ps(p + 12, w);
+		}
+#endif
+
+#if MUTIL_USE_AVX
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vcombine(__m128 lo, __m128 hi)
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload3(__m256, const float *p, __m256 &x, __m256 &y, __m256 &z)
+		{
+			__m128 x0, y0, z0, x1, y1, z1;
+			vload3(__m128(), p, x0, y0, z0);
+			vload3(__m128(), p + 12, x1, y1, z1);
+			x = vcombine(x0, x1);
+			y = vcombine(y0, y1);
+			z = vcombine(z0, z1);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore3(float *p, __m256 x, __m256 y, __m256 z)
+		{
+			vstore3(p, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+			vstore3(p + 12, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload4(__m256, const float *p, __m256 &x, __m256 &y, __m256 &z, __m256 &w)
+		{
+			__m128 x0, y0, z0, w0, x1, y1, z1, w1;
+			vload4(__m128(), p, x0, y0, z0, w0);
+			vload4(__m128(), p + 16, x1, y1, z1, w1);
+			x = vcombine(x0, x1);
+			y = vcombine(y0, y1);
+			z = vcombine(z0, z1);
+			w = vcombine(w0, w1);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore4(float *p, __m256 x, __m256 y, __m256 z, __m256 w)
+		{
+			vstore4(p, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+			vstore4(p + 16, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+		}
+#endif
+
+#if MUTIL_USE_AVX512
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vcombine(__m256 lo, __m256 hi)
+		{
+			return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(lo)), _mm256_castps_pd(hi), 1));
+		}
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vhigh(__m512 a)
+		{
+			return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1));
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload3(__m512, const float *p, __m512 &x, __m512 &y, __m512 &z)
+		{
+			__m256 x0, y0, z0, x1, y1, z1;
+			vload3(__m256(), p, x0, y0, z0);
+			vload3(__m256(), p + 24, x1, y1, z1);
+			x = vcombine(x0, x1);
+			y = vcombine(y0, y1);
+			z = vcombine(z0, z1);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore3(float *p, __m512 x, __m512 y, __m512 z)
+		{
+			vstore3(p, _mm512_castps512_ps256(x), _mm512_castps512_ps256(y), _mm512_castps512_ps256(z));
+			vstore3(p + 24, vhigh(x), vhigh(y), vhigh(z));
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload4(__m512, const float *p, __m512 &x, __m512 &y, __m512 &z, __m512 &w)
+		{
+			__m256 x0, y0, z0, w0, x1, y1, z1, w1;
+			vload4(__m256(), p, x0, y0, z0, w0);
+			vload4(__m256(), p + 32, x1, y1, z1, w1);
+			x = vcombine(x0, x1);
+			y = vcombine(y0, y1);
+			z = vcombine(z0, z1);
+			w = vcombine(w0, w1);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore4(float *p, __m512 x, __m512 y, __m512 z, __m512 w)
+		{
+			vstore4(p, _mm512_castps512_ps256(x), _mm512_castps512_ps256(y), _mm512_castps512_ps256(z), _mm512_castps512_ps256(w));
+			vstore4(p + 32, vhigh(x), vhigh(y), vhigh(z), vhigh(w));
+		}
+#endif
+
+#if MUTIL_USE_NEON
+		MUTIL_FORCEINLINE void vload3(float32x4_t, const float *p, float32x4_t &x, float32x4_t &y, float32x4_t &z)
+		{
+			float32x4x3_t v = vld3q_f32(p);
+			x = v.val[0];
+			y = v.val[1];
+			z = v.val[2];
+		}
+
+		MUTIL_FORCEINLINE void vstore3(float *p, float32x4_t x, float32x4_t y, float32x4_t z)
+		{
+			float32x4x3_t v;
+			v.val[0] = x;
+			v.val[1] = y;
+			v.val[2] = z;
+			vst3q_f32(p, v);
+		}
+
+		MUTIL_FORCEINLINE void vload4(float32x4_t, const float *p, float32x4_t &x, float32x4_t &y, float32x4_t &z, float32x4_t &w)
+		{
+			float32x4x4_t v = vld4q_f32(p);
+			x = v.val[0];
+			y = v.val[1];
+			z = v.val[2];
+			w = v.val[3];
+		}
+
+		MUTIL_FORCEINLINE void vstore4(float *p, float32x4_t x, float32x4_t y, float32x4_t z, float32x4_t w)
+		{
+			float32x4x4_t v;
+			v.val[0] = x;
+			v.val[1] = y;
+			v.val[2] = z;
+			v.val[3] = w;
+			vst4q_f32(p, v);
+		}
+#endif
+
+		// Rounding, comparisons and exponent access for the transcendental kernels.
+		// vround rounds to the nearest integer, ties to even. The comparisons
+		// return a mask of whatever type vselect(mask, a, b) accepts, choosing a
+		// where the mask is set. vpow2n returns 2^n for an integral n in
+		// [-126, 127]. vfrexp splits a normal, finite x into a mantissa in
+		// [0.5, 1) and an exponent e with x = m * 2^e.
+
+		MUTIL_FORCEINLINE float vround(float a) { return nearbyintf(a); }
+		MUTIL_FORCEINLINE float vfloor(float a) { return floorf(a); }
+		MUTIL_FORCEINLINE bool vlt(float a, float b) { return a < b; }
+		MUTIL_FORCEINLINE bool vle(float a, float b) { return a <= b; }
+		MUTIL_FORCEINLINE bool vgt(float a, float b) { return a > b; }
+		MUTIL_FORCEINLINE bool veq(float a, float b) { return a == b; }
+		MUTIL_FORCEINLINE float vselect(bool m, float a, float b) { return m ? a : b; }
+		MUTIL_FORCEINLINE float vpow2n(float n) { return ldexpf(1.0f, (int)n); }
+
+		MUTIL_FORCEINLINE float vfrexp(float x, float &e)
+		{
+			int ie;
+			const float m = frexpf(x, &ie);
+			e = (float)ie;
+			return m;
+		}
+
+#if MUTIL_USE_SSE
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vround(__m128 a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vfloor(__m128 a) { return _mm_floor_ps(a); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vlt(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vle(__m128 a, __m128 b) { return _mm_cmple_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vgt(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL veq(__m128 a, __m128 b) { return _mm_cmpeq_ps(a, b); }
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vselect(__m128 m, __m128 a, __m128 b) { return _mm_blendv_ps(b, a, m); }
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vpow2n(__m128 n)
+		{
+			const __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+			return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+		}
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vfrexp(__m128 x, __m128 &e)
+		{
+			const __m128i bits = _mm_castps_si128(x);
+			const __m128i ie = _mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff));
+			e = _mm_cvtepi32_ps(_mm_sub_epi32(ie, _mm_set1_epi32(126)));
+			const __m128i m = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32((int)0x807fffff)), _mm_set1_epi32(0x3f000000));
+			return _mm_castsi128_ps(m);
+		}
+#endif
+
+#if MUTIL_USE_AVX
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vround(__m256 a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vfloor(__m256 a) { return _mm256_floor_ps(a); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vlt(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vle(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vgt(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL veq(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vselect(__m256 m, __m256 a, __m256 b) { return _mm256_blendv_ps(b, a, m); }
+
+#if MUTIL_USE_AVX2
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vpow2n(__m256 n)
+		{
+			const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+			return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+		}
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vfrexp(__m256 x, __m256 &e)
+		{
+			const __m256i bits = _mm256_castps_si256(x);
+			const __m256i ie = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xff));
+			e = _mm256_cvtepi32_ps(_mm256_sub_epi32(ie, _mm256_set1_epi32(126)));
+			const __m256i m = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32((int)0x807fffff)), _mm256_set1_epi32(0x3f000000));
+			return _mm256_castsi256_ps(m);
+		}
+#else
+		// AVX has no 256-bit integer instructions, so do each half separately
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vpow2n(__m256 n)
+		{
+			return vcombine(vpow2n(_mm256_castps256_ps128(n)), vpow2n(_mm256_extractf128_ps(n, 1)));
+		}
+
+		MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL vfrexp(__m256 x, __m256 &e)
+		{
+			__m128 lo, hi;
+			const __m256 m = vcombine(vfrexp(_mm256_castps256_ps128(x), lo), vfrexp(_mm256_extractf128_ps(x, 1), hi));
+			e = vcombine(lo, hi);
+			return m;
+		}
+#endif
+#endif
+
+#if MUTIL_USE_AVX512
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vround(__m512 a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vfloor(__m512 a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+		MUTIL_FORCEINLINE __mmask16 MUTIL_VECTORCALL vlt(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		MUTIL_FORCEINLINE __mmask16 MUTIL_VECTORCALL vle(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+		MUTIL_FORCEINLINE __mmask16 MUTIL_VECTORCALL vgt(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+		MUTIL_FORCEINLINE __mmask16 MUTIL_VECTORCALL veq(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vselect(__mmask16 m, __m512 a, __m512 b) { return _mm512_mask_blend_ps(m, b, a); }
+
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vpow2n(__m512 n)
+		{
+			const __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+			return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+		}
+
+		MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL vfrexp(__m512 x, __m512 &e)
+		{
+			const __m512i bits = _mm512_castps_si512(x);
+			const __m512i ie = _mm512_and_si512(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(0xff));
+			e = _mm512_cvtepi32_ps(_mm512_sub_epi32(ie, _mm512_set1_epi32(126)));
+			const __m512i m = _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32((int)0x807fffff)), _mm512_set1_epi32(0x3f000000));
+			return _mm512_castsi512_ps(m);
+		}
+#endif
+
+#if MUTIL_USE_NEON
+		MUTIL_FORCEINLINE float32x4_t vround(float32x4_t a) { return vrndnq_f32(a); }
+		MUTIL_FORCEINLINE float32x4_t vfloor(float32x4_t a) { return vrndmq_f32(a); }
+		MUTIL_FORCEINLINE uint32x4_t vlt(float32x4_t a, float32x4_t b) { return vcltq_f32(a, b); }
+		MUTIL_FORCEINLINE uint32x4_t vle(float32x4_t a, float32x4_t b) { return vcleq_f32(a, b); }
+		MUTIL_FORCEINLINE uint32x4_t vgt(float32x4_t a, float32x4_t b) { return vcgtq_f32(a, b); }
+		MUTIL_FORCEINLINE uint32x4_t veq(float32x4_t a, float32x4_t b) { return vceqq_f32(a, b); }
+		MUTIL_FORCEINLINE float32x4_t vselect(uint32x4_t m, float32x4_t a, float32x4_t b) { return vbslq_f32(m, a, b); }
+
+		MUTIL_FORCEINLINE float32x4_t vpow2n(float32x4_t n)
+		{
+			const int32x4_t e = vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127));
+			return vreinterpretq_f32_s32(vshlq_n_s32(e, 23));
+		}
+
+		MUTIL_FORCEINLINE float32x4_t vfrexp(float32x4_t x, float32x4_t &e)
+		{
+			const uint32x4_t bits = vreinterpretq_u32_f32(x);
+			const uint32x4_t ie = vandq_u32(vshrq_n_u32(bits, 23), vdupq_n_u32(0xff));
+			e = vsubq_f32(vcvtq_f32_u32(ie), vdupq_n_f32(126.0f));
+			const uint32x4_t m = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x807fffff)), vdupq_n_u32(0x3f000000));
+			return vreinterpretq_f32_u32(m);
+		}
+#endif
+
+		// Four lane shuffles. vshuffle<X, Y, Z, W>(a, b) returns (a[X], a[Y], b[Z], b[W]),
+		// the same selection as _mm_shuffle_ps. vsetr fills a register in lane order
+		// and vfirst extracts lane 0.
+
+#if MUTIL_USE_SSE
+		template <int X, int Y, int Z, int W>
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vshuffle(__m128 a, __m128 b)
+		{
+			return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+		}
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vsetr(__m128, float a, float b, float c, float d)
+		{
+			return _mm_setr_ps(a, b, c, d);
+		}
+
+		MUTIL_FORCEINLINE float MUTIL_VECTORCALL vfirst(__m128 a) { return _mm_cvtss_f32(a); }
+#elif MUTIL_USE_NEON
+		template <int X, int Y, int Z, int W>
+		MUTIL_FORCEINLINE float32x4_t vshuffle(float32x4_t a, float32x4_t b)
+		{
+			float32x4_t r = vdupq_n_f32(vgetq_lane_f32(a, X));
+			r = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+			r = vsetq_lane_f32(vgetq_lane_f32(b, Z), r, 2);
+			return vsetq_lane_f32(vgetq_lane_f32(b, W), r, 3);
+		}
+
+		MUTIL_FORCEINLINE float32x4_t vsetr(float32x4_t, float a, float b, float c, float d)
+		{
+			const float v[4] = { a, b, c, d };
+			return vld1q_f32(v);
+		}
+
+		MUTIL_FORCEINLINE float vfirst(float32x4_t a) { return vgetq_lane_f32(a, 0); }
+#endif
+
+		// A register of exactly four floats, for kernels working on a single
+		// Vector4 or Matrix4 column at a time.
+#if MUTIL_USE_SSE
+		using vfloat4 = __m128;
+#elif MUTIL_USE_NEON
+		using vfloat4 = float32x4_t;
+#endif
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		// Four consecutive (x, y, z) triples, such as the columns of an
+		// AffineMatrix, one per register. Unlike vload3 the triples are not
+		// transposed, and lane 3 of each register is unspecified.
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vload3x4(const float *p, vfloat4 &a, vfloat4 &b, vfloat4 &c, vfloat4 &d)
+		{
+			// v0 = a0 a1 a2 b0, v1 = b1 b2 c0 c1, v2 = c2 d0 d1 d2
+			const vfloat4 v0 = vloadu(vfloat4(), p);
+			const vfloat4 v1 = vloadu(vfloat4(), p + 4);
+			const vfloat4 v2 = vloadu(vfloat4(), p + 8);
+
+			a = v0;
+			b = vshuffle<0, 2, 1, 1>(vshuffle<3, 3, 0, 0>(v0, v1), v1);
+			c = vshuffle<2, 3, 0, 0>(v1, v2);
+			d = vshuffle<1, 2, 3, 3>(v2, v2);
+		}
+
+		MUTIL_FORCEINLINE void MUTIL_VECTORCALL vstore3x4(float *p, vfloat4 a, vfloat4 b, vfloat4 c, vfloat4 d)
+		{
+			vstoreu(p, vshuffle<0, 1, 0, 2>(a, vshuffle<2, 2, 0, 0>(a, b)));
+			vstoreu(p + 4, vshuffle<1, 2, 0, 1>(b, c));
+			vstoreu(p + 8, vshuffle<0, 2, 1, 2>(vshuffle<2, 2, 0, 0>(c, d), d));
+		}
+#endif
+
+		// The widest register type, holds MUTIL_SIMD_WIDTH floats.
+#if MUTIL_USE_AVX512
+		using vfloat = __m512;
+#elif MUTIL_USE_AVX
+		using vfloat = __m256;
+#elif MUTIL_USE_SSE
+		using vfloat = __m128;
+#elif MUTIL_USE_NEON
+		using vfloat = float32x4_t;
+#else
+		using vfloat = float;
+#endif
+
+		/*
+		Runs f(lane, i) over [0, count). f is first called with a vfloat lane for
+		every full register of elements and then with a float lane for the
+		remainder, so a kernel written against the overloads above is shared by
+		both the vector loop and its tail.
+		*/
+		template <typename F>
+		MUTIL_FORCEINLINE void streamFor(size_t count, F &&f)
+		{
+			size_t i = 0;
+#if MUTIL_SIMD_WIDTH > 1
+			// an exact bound lets the compiler see that the tail is empty when
+			// count is a known multiple of the width
+			const size_t full = count - count % MUTIL_SIMD_WIDTH;
+			for (; i < full; i += MUTIL_SIMD_WIDTH)
+				f(vfloat(), i);
+#endif
+			for (; i < count; i++)
+				f(0.0f, i);
+		}
+	}
+}
+
+#if MUTIL_USE_AVX512 && __GNUC__ && !__clang__ && __GNUC__ < 13
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,592 @@
+/*!
+\file
+Contains lane-parallel versions of the transcendental functions. Each function
+is provided for raw registers, Vector4, arrays of floats, and vector streams.
+
+The maximum errors listed for each function were measured against double
+precision results over the given input range, with and without FMA.
+*/
+
+#pragma once
+
+#include "simd.h"
+#include "../vec/vec_stream.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		// Kernels shared by every register type. Each is written against the
+		// overloads in simd.h, so one definition serves float, __m128, __m256,
+		// __m512 and float32x4_t.
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vneg(V a) { return vsub(vset1(a, 0.0f), a); }
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vabs(V a) { return vmax(a, vneg(a)); }
+
+		// Reduces x to r in [-pi/4, pi/4] with x = r + q * pi/2. pi/2 is split
+		// in three parts so that the first products are exact.
+		template <typename V>
+		MUTIL_FORCEINLINE V vreducePi2(V x, V &q)
+		{
+			q = vround(vmul(x, vset1(x, 0.636619772367581343f)));
+
+			V r = vfnmadd(q, vset1(x, 1.5703125f), x);
+			r = vfnmadd(q, vset1(x, 4.837512969970703125e-4f), r);
+			return vfnmadd(q, vset1(x, 7.54978995489188216e-8f), r);
+		}
+
+		// sin(r) and cos(r) for r in [-pi/4, pi/4]
+		template <typename V>
+		MUTIL_FORCEINLINE V vsinPoly(V r, V r2)
+		{
+			V p = vfmadd(vset1(r, -1.9515295891e-4f), r2, vset1(r, 8.3321608736e-3f));
+			p = vfmadd(p, r2, vset1(r, -1.6666654611e-1f));
+			return vfmadd(vmul(p, r2), r, r);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vcosPoly(V r2)
+		{
+			V p = vfmadd(vset1(r2, 2.443315711809948e-5f), r2, vset1(r2, -1.388731625493765e-3f));
+			p = vfmadd(p, r2, vset1(r2, 4.166664568298827e-2f));
+			return vfmadd(vmul(p, r2), r2, vfnmadd(vset1(r2, 0.5f), r2, vset1(r2, 1.0f)));
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE void vsincos(V x, V &s, V &c)
+		{
+			V q;
+			const V r = vreducePi2(x, q);
+			const V r2 = vmul(r, r);
+			const V ps = vsinPoly(r, r2);
+			const V pc = vcosPoly(r2);
+
+			// quadrant 0..3 selects which polynomial and sign each result takes
+			const V q4 = vfnmadd(vfloor(vmul(q, vset1(x, 0.25f))), vset1(x, 4.0f), q);
+			const V odd = vfnmadd(vfloor(vmul(q4, vset1(x, 0.5f))), vset1(x, 2.0f), q4);
+			const auto swap = vgt(odd, vset1(x, 0.5f));
+
+			s = vselect(swap, pc, ps);
+			c = vselect(swap, ps, pc);
+
+			s = vselect(vgt(q4, vset1(x, 1.5f)), vneg(s), s);
+			c = vselect(vlt(vabs(vsub(q4, vset1(x, 1.5f))), vset1(x, 1.0f)), vneg(c), c);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vsin(V x)
+		{
+			V s, c;
+			vsincos(x, s, c);
+			return s;
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vcos(V x)
+		{
+			V s, c;
+			vsincos(x, s, c);
+			return c;
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vtan(V x)
+		{
+			V q;
+			const V r = vreducePi2(x, q);
+			const V z = vmul(r, r);
+
+			V p = vfmadd(vset1(x, 9.38540185543e-3f), z, vset1(x, 3.11992232697e-3f));
+			p = vfmadd(p, z, vset1(x, 2.44301354525e-2f));
+			p = vfmadd(p, z, vset1(x, 5.34112807005e-2f));
+			p = vfmadd(p, z, vset1(x, 1.33387994085e-1f));
+			p = vfmadd(p, z, vset1(x, 3.33331568548e-1f));
+			p = vfmadd(vmul(p, z), r, r);
+
+			// tan(r + pi/2) = -1 / tan(r)
+			const V odd = vfnmadd(vfloor(vmul(q, vset1(x, 0.5f))), vset1(x, 2.0f), q);
+			return vselect(vgt(odd, vset1(x, 0.5f)), vdiv(vset1(x, -1.0f), p), p);
+		}
+
+		// 2^n for integral n in [-252, 254], split so that neither factor
+		// overflows and results in the subnormal range are still produced.
+		template <typename V>
+		MUTIL_FORCEINLINE V vscale2(V y, V n)
+		{
+			const V n1 = vfloor(vmul(n, vset1(n, 0.5f)));
+			return vmul(vmul(y, vpow2n(n1)), vpow2n(vsub(n, n1)));
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vexp(V x)
+		{
+			const V hi = vset1(x, 88.72283935546875f);
+			const V lo = vset1(x, -103.972076416015625f);
+			const V xc = vmax(lo, vmin(hi, x));
+
+			// x = r + n * ln(2), with ln(2) in two parts
+			const V n = vround(vmul(xc, vset1(x, 1.44269504088896341f)));
+			V r = vfnmadd(n, vset1(x, 0.693359375f), xc);
+			r = vfmadd(n, vset1(x, 2.12194440e-4f), r);
+
+			V p = vfmadd(vset1(x, 1.9875691500e-4f), r, vset1(x, 1.3981999507e-3f));
+			p = vfmadd(p, r, vset1(x, 8.3334519073e-3f));
+			p = vfmadd(p, r, vset1(x, 4.1665795894e-2f));
+			p = vfmadd(p, r, vset1(x, 1.6666665459e-1f));
+			p = vfmadd(p, r, vset1(x, 5.0000001201e-1f));
+			p = vfmadd(vmul(p, r), r, vadd(r, vset1(x, 1.0f)));
+
+			V result = vscale2(p, n);
+			result = vselect(vgt(x, hi), vset1(x, MUTIL_INFINITY), result);
+			result = vselect(vlt(x, lo), vset1(x, 0.0f), result);
+
+			// NaN fails every comparison above, so it is passed through here
+			return vselect(veq(x, x), result, x);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vexp2(V x)
+		{
+			const V hi = vset1(x, 128.0f);
+			const V lo = vset1(x, -150.0f);
+			const V xc = vmax(lo, vmin(hi, x));
+
+			const V n = vround(xc);
+			const V f = vsub(xc, n);
+
+			V p = vfmadd(vset1(x, 1.535336188319500e-4f), f, vset1(x, 1.339887440266574e-3f));
+			p = vfmadd(p, f, vset1(x, 9.618437357674640e-3f));
+			p = vfmadd(p, f, vset1(x, 5.550332471162809e-2f));
+			p = vfmadd(p, f, vset1(x, 2.402264791363012e-1f));
+			p = vfmadd(p, f, vset1(x, 6.931472028550421e-1f));
+			p = vfmadd(p, f, vset1(x, 1.0f));
+
+			V result = vscale2(p, n);
+			result = vselect(vle(hi, x), vset1(x, MUTIL_INFINITY), result);
+			result = vselect(vlt(x, lo), vset1(x, 0.0f), result);
+			return vselect(veq(x, x), result, x);
+		}
+
+		// Splits x into m * 2^e with m in [sqrt(1/2), sqrt(2)), leaving m - 1 in m,
+		// and returns the polynomial part of log(m) without its -(m - 1)^2 / 2 term.
+		template <typename V>
+		MUTIL_FORCEINLINE V vlogReduce(V x, V &m, V &e)
+		{
+			// subnormals are scaled into the normal range first
+			const auto sub = vlt(x, vset1(x, 1.17549435e-38f));
+			x = vselect(sub, vmul(x, vset1(x, 33554432.0f)), x);
+
+			m = vfrexp(x, e);
+			e = vsub(e, vselect(sub, vset1(x, 25.0f), vset1(x, 0.0f)));
+
+			const auto small = vlt(m, vset1(x, 0.707106781186547524f));
+			e = vsub(e, vselect(small, vset1(x, 1.0f), vset1(x, 0.0f)));
+			m = vsub(vadd(m, vselect(small, m, vset1(x, 0.0f))), vset1(x, 1.0f));
+
+			V p = vfmadd(vset1(x, 7.0376836292e-2f), m, vset1(x, -1.1514610310e-1f));
+			p = vfmadd(p, m, vset1(x, 1.1676998740e-1f));
+			p = vfmadd(p, m, vset1(x, -1.2420140846e-1f));
+			p = vfmadd(p, m, vset1(x, 1.4249322787e-1f));
+			p = vfmadd(p, m, vset1(x, -1.6668057665e-1f));
+			p = vfmadd(p, m, vset1(x, 2.0000714765e-1f));
+			p = vfmadd(p, m, vset1(x, -2.4999993993e-1f));
+			p = vfmadd(p, m, vset1(x, 3.3333331174e-1f));
+
+			const V z = vmul(m, m);
+			return vmul(vmul(p, m), z);
+		}
+
+		// log(0) = -inf, log(inf) = inf, log(x < 0) = NaN
+		template <typename V>
+		MUTIL_FORCEINLINE V vlogSpecial(V x, V result)
+		{
+			result = vselect(veq(x, vset1(x, MUTIL_INFINITY)), x, result);
+			result = vselect(veq(x, vset1(x, 0.0f)), vset1(x, MUTIL_NEG_INFINITY), result);
+			result = vselect(vlt(x, vset1(x, 0.0f)), vset1(x, MUTIL_NAN), result);
+			return vselect(veq(x, x), result, x);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vlog(V x)
+		{
+			V m, e;
+			V y = vlogReduce(x, m, e);
+
+			y = vfnmadd(e, vset1(x, 2.12194440e-4f), y);
+			y = vfnmadd(vset1(x, 0.5f), vmul(m, m), y);
+			const V result = vfmadd(e, vset1(x, 0.693359375f), vadd(m, y));
+
+			return vlogSpecial(x, result);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vlog2(V x)
+		{
+			V m, e;
+			V y = vlogReduce(x, m, e);
+			y = vfnmadd(vset1(x, 0.5f), vmul(m, m), y);
+
+			// log2(m) = (m + y) * log2(e), with log2(e) - 1 applied separately
+			const V log2ea = vset1(x, 0.44269504088896340736f);
+			V result = vmul(y, log2ea);
+			result = vfmadd(m, log2ea, result);
+			result = vadd(result, y);
+			result = vadd(result, m);
+			result = vadd(result, e);
+
+			return vlogSpecial(x, result);
+		}
+
+		// atan(a) for a >= 0
+		template <typename V>
+		MUTIL_FORCEINLINE V vatanPositive(V a)
+		{
+			const auto big = vgt(a, vset1(a, 2.414213562373095f));
+			const auto mid = vgt(a, vset1(a, 0.4142135623730950f));
+
+			const V one = vset1(a, 1.0f);
+			V t = vselect(mid, vdiv(vsub(a, one), vadd(a, one)), a);
+			t = vselect(big, vdiv(vset1(a, -1.0f), a), t);
+
+			V y = vselect(mid, vset1(a, MUTIL_PI4), vset1(a, 0.0f));
+			y = vselect(big, vset1(a, MUTIL_PI2), y);
+
+			const V z = vmul(t, t);
+			V p = vfmadd(vset1(a, 8.05374449538e-2f), z, vset1(a, -1.38776856032e-1f));
+			p = vfmadd(p, z, vset1(a, 1.99777106478e-1f));
+			p = vfmadd(p, z, vset1(a, -3.33329491539e-1f));
+			p = vfmadd(vmul(p, z), t, t);
+
+			return vadd(y, p);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vatan(V x)
+		{
+			const V r = vatanPositive(vabs(x));
+			return vselect(vlt(x, vset1(x, 0.0f)), vneg(r), r);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vatan2(V y, V x)
+		{
+			const V ax = vabs(x);
+			const V ay = vabs(y);
+			const V mx = vmax(ax, ay);
+			const V mn = vmin(ax, ay);
+
+			// the ratio is in [0, 1], avoiding the reciprocal branch of atan
+			const V a = vselect(veq(mx, vset1(x, 0.0f)), vset1(x, 0.0f), vdiv(mn, mx));
+			V r = vatanPositive(a);
+
+			r = vselect(vgt(ay, ax), vsub(vset1(x, MUTIL_PI2), r), r);
+			r = vselect(vlt(x, vset1(x, 0.0f)), vsub(vset1(x, MUTIL_PI), r), r);
+			return vselect(vlt(y, vset1(x, 0.0f)), vneg(r), r);
+		}
+
+		template <typename V>
+		MUTIL_FORCEINLINE V vpow(V x, V y)
+		{
+			const V result = vexp2(vmul(y, vlog2(x)));
+			return vselect(veq(y, vset1(x, 0.0f)), vset1(x, 1.0f), result);
+		}
+
+		// Applies a kernel to each element of a Vector4, an array or a stream.
+
+		template <typename F>
+		MUTIL_FORCEINLINE Vector4 vmapVector4(const Vector4 &x, F f)
+		{
+			Vector4 result;
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+			vstoreu(&result.x, f(vloadu(vfloat4(), &x.x)));
+#else
+			for (size_t i = 0; i < 4; i++)
+				result[i] = f(x[i]);
+#endif
+			return result;
+		}
+
+		template <typename F>
+		MUTIL_FORCEINLINE Vector4 vmapVector4(const Vector4 &a, const Vector4 &b, F f)
+		{
+			Vector4 result;
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+			vstoreu(&result.x, f(vloadu(vfloat4(), &a.x), vloadu(vfloat4(), &b.x)));
+#else
+			for (size_t i = 0; i < 4; i++)
+				result[i] = f(a[i], b[i]);
+#endif
+			return result;
+		}
+
+		template <typename F>
+		MUTIL_FORCEINLINE void vmapArray(const float *x, float *out, size_t count, F f)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				vstoreu(out + i, f(vloadu(lane, x + i)));
+			});
+		}
+
+		template <typename F>
+		MUTIL_FORCEINLINE void vmapArray(const float *a, const float *b, float *out, size_t count, F f)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				vstoreu(out + i, f(vloadu(lane, a + i), vloadu(lane, b + i)));
+			});
+		}
+
+		template <size_t N, typename F>
+		MUTIL_FORCEINLINE void vmapStream(const VectorStream<N> &x, VectorStream<N> &out, F f)
+		{
+			out.resize(x.size());
+			for (size_t k = 0; k < N; k++)
+			{
+				const float *src = x.data[k];
+				float *dst = out.data[k];
+				streamFor(x.size(), [&](auto lane, size_t i) {
+					vstore(dst + i, f(vload(lane, src + i)));
+				});
+			}
+		}
+
+		template <size_t N, typename F>
+		MUTIL_FORCEINLINE void vmapStream(const VectorStream<N> &a, const VectorStream<N> &b, VectorStream<N> &out, F f)
+		{
+			out.resize(a.size());
+			for (size_t k = 0; k < N; k++)
+			{
+				const float *sa = a.data[k];
+				const float *sb = b.data[k];
+				float *dst = out.data[k];
+				streamFor(a.size(), [&](auto lane, size_t i) {
+					vstore(dst + i, f(vload(lane, sa + i), vload(lane, sb + i)));
+				});
+			}
+		}
+	}
+
+	// Declares every overload of a lane-parallel function in terms of its kernel.
+
+#if MUTIL_USE_SSE
+#define __vmath_unary_sse(name) MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL name(__m128 x) { return __1::v##name(x); }
+#define __vmath_binary_sse(name) MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL name(__m128 a, __m128 b) { return __1::v##name(a, b); }
+#else
+#define __vmath_unary_sse(name)
+#define __vmath_binary_sse(name)
+#endif
+
+#if MUTIL_USE_AVX
+#define __vmath_unary_avx(name) MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL name(__m256 x) { return __1::v##name(x); }
+#define __vmath_binary_avx(name) MUTIL_FORCEINLINE __m256 MUTIL_VECTORCALL name(__m256 a, __m256 b) { return __1::v##name(a, b); }
+#else
+#define __vmath_unary_avx(name)
+#define __vmath_binary_avx(name)
+#endif
+
+#if MUTIL_USE_AVX512
+#define __vmath_unary_avx512(name) MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL name(__m512 x) { return __1::v##name(x); }
+#define __vmath_binary_avx512(name) MUTIL_FORCEINLINE __m512 MUTIL_VECTORCALL name(__m512 a, __m512 b) { return __1::v##name(a, b); }
+#else
+#define __vmath_unary_avx512(name)
+#define __vmath_binary_avx512(name)
+#endif
+
+#if MUTIL_USE_NEON
+#define __vmath_unary_neon(name) MUTIL_FORCEINLINE float32x4_t name(float32x4_t x) { return __1::v##name(x); }
+#define __vmath_binary_neon(name) MUTIL_FORCEINLINE float32x4_t name(float32x4_t a, float32x4_t b) { return __1::v##name(a, b); }
+#else
+#define __vmath_unary_neon(name)
+#define __vmath_binary_neon(name)
+#endif
+
+#define __vmath_unary(name) \
+	__vmath_unary_sse(name) \
+	__vmath_unary_avx(name) \
+	__vmath_unary_avx512(name) \
+	__vmath_unary_neon(name) \
+	inline Vector4 MUTIL_VECTORCALL name(const Vector4 &x) \
+	{ \
+		return __1::vmapVector4(x, [](auto v) { return __1::v##name(v); }); \
+	} \
+	inline void name(const float *x, float *out, size_t count) \
+	{ \
+		__1::vmapArray(x, out, count, [](auto v) { return __1::v##name(v); }); \
+	} \
+	template <size_t N> \
+	inline void name(const VectorStream<N> &x, VectorStream<N> &out) \
+	{ \
+		__1::vmapStream(x, out, [](auto v) { return __1::v##name(v); }); \
+	}
+
+#define __vmath_binary(name) \
+	__vmath_binary_sse(name) \
+	__vmath_binary_avx(name) \
+	__vmath_binary_avx512(name) \
+	__vmath_binary_neon(name) \
+	inline Vector4 MUTIL_VECTORCALL name(const Vector4 &a, const Vector4 &b) \
+	{ \
+		return __1::vmapVector4(a, b, [](auto u, auto v) { return __1::v##name(u, v); }); \
+	} \
+	inline void name(const float *a, const float *b, float *out, size_t count) \
+	{ \
+		__1::vmapArray(a, b, out, count, [](auto u, auto v) { return __1::v##name(u, v); }); \
+	} \
+	template <size_t N> \
+	inline void name(const VectorStream<N> &a, const VectorStream<N> &b, VectorStream<N> &out) \
+	{ \
+		__1::vmapStream(a, b, out, [](auto u, auto v) { return __1::v##name(u, v); }); \
+	}
+
+	/*!
+	Lane-parallel sine. Max error 2 ulp for |x| <= 8192, growing beyond that as
+	the range reduction loses precision. Near the zeros of large arguments the
+	error relative to the small result is larger, up to 122 ulp, but stays below
+	9.3e-8 absolute.
+	*/
+	__vmath_unary(sin)
+
+	/*!
+	Lane-parallel cosine. Max error 2 ulp for |x| <= 8192, growing beyond that as
+	the range reduction loses precision. As with sin, up to 21 ulp but below
+	9.3e-8 absolute near the zeros.
+	*/
+	__vmath_unary(cos)
+
+	/*!
+	Lane-parallel tangent. Max error 3 ulp for |x| <= 8192, except near the zeros
+	and poles of large x, where the relative error reaches 8e-6.
+	*/
+	__vmath_unary(tan)
+
+	/*!
+	Lane-parallel e^x. Max error 1.5 ulp. Overflows to infinity above 88.72 and
+	flushes to zero below -103.97.
+	*/
+	__vmath_unary(exp)
+
+	/*!
+	Lane-parallel 2^x. Max error 1.5 ulp. Overflows to infinity at 128 and
+	flushes to zero below -150.
+	*/
+	__vmath_unary(exp2)
+
+	/*!
+	Lane-parallel natural logarithm. Max error 1 ulp for all positive x,
+	including subnormals. log(0) is -infinity and negative x gives NaN.
+	*/
+	__vmath_unary(log)
+
+	/*!
+	Lane-parallel base 2 logarithm. Max error 1.5 ulp for all positive x,
+	including subnormals. log2(0) is -infinity and negative x gives NaN.
+	*/
+	__vmath_unary(log2)
+
+	/*!
+	Lane-parallel arctangent. Max error 3 ulp.
+	*/
+	__vmath_unary(atan)
+
+	/*!
+	Lane-parallel arctangent of a / b, using the signs of both to find the
+	quadrant. Max error 3.5 ulp. atan2(0, 0) is 0.
+	*/
+	__vmath_binary(atan2)
+
+	/*!
+	Lane-parallel a^b, computed as 2^(b * log2(a)). The error grows with the
+	magnitude of b * log2(a), reaching about 2 + 1.3 * |b * log2(a)| ulp. a must
+	not be negative. a^0 is 1.
+	*/
+	__vmath_binary(pow)
+
+#undef __vmath_unary
+#undef __vmath_binary
+#undef __vmath_unary_sse
+#undef __vmath_binary_sse
+#undef __vmath_unary_avx
+#undef __vmath_binary_avx
+#undef __vmath_unary_avx512
+#undef __vmath_binary_avx512
+#undef __vmath_unary_neon
+#undef __vmath_binary_neon
+
+	// sincos computes both results from a single range reduction.
+
+#if MUTIL_USE_SSE
+	MUTIL_FORCEINLINE void MUTIL_VECTORCALL sincos(__m128 x, __m128 &s, __m128 &c) { __1::vsincos(x, s, c); }
+#endif
+#if MUTIL_USE_AVX
+	MUTIL_FORCEINLINE void MUTIL_VECTORCALL sincos(__m256 x, __m256 &s, __m256 &c) { __1::vsincos(x, s, c); }
+#endif
+#if MUTIL_USE_AVX512
+	MUTIL_FORCEINLINE void MUTIL_VECTORCALL sincos(__m512 x, __m512 &s, __m512 &c) { __1::vsincos(x, s, c); }
+#endif
+#if MUTIL_USE_NEON
+	MUTIL_FORCEINLINE void sincos(float32x4_t x, float32x4_t &s, float32x4_t &c) { __1::vsincos(x, s, c); }
+#endif
+
+	/*!
+	Computes the sine and cosine of each component of a vector with the same
+	accuracy as sin and cos.
+
+	@param x The angles, in radians.
+	@param s Receives the sines.
+	@param c Receives the cosines.
+	*/
+	inline void MUTIL_VECTORCALL sincos(const Vector4 &x, Vector4 &s, Vector4 &c)
+	{
+		using namespace __1;
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		vfloat4 vs, vc;
+		vsincos(vloadu(vfloat4(), &x.x), vs, vc);
+		vstoreu(&s.x, vs);
+		vstoreu(&c.x, vc);
+#else
+		for (size_t i = 0; i < 4; i++)
+			vsincos(x[i], s[i], c[i]);
+#endif
+	}
+
+	/*!
+	Computes the sine and cosine of every element of an array.
+
+	@param x The angles, in radians.
+	@param s Receives the sines.
+	@param c Receives the cosines.
+	@param count The number of elements.
+	*/
+	inline void sincos(const float *x, float *s, float *c, size_t count)
+	{
+		using namespace __1;
+
+		streamFor(count, [&](auto lane, size_t i) {
+			decltype(lane) vs, vc;
+			vsincos(vloadu(lane, x + i), vs, vc);
+			vstoreu(s + i, vs);
+			vstoreu(c + i, vc);
+		});
+	}
+
+	/*!
+	Computes the sine and cosine of every component of a stream.
+
+	@param x The angles, in radians.
+	@param s Receives the sines. It is resized to x.size().
+	@param c Receives the cosines. It is resized to x.size().
+	*/
+	template <size_t N>
+	inline void sincos(const VectorStream<N> &x, VectorStream<N> &s, VectorStream<N> &c)
+	{
+		using namespace __1;
+
+		s.resize(x.size());
+		c.resize(x.size());
+		for (size_t k = 0; k < N; k++)
+			sincos(x.data[k], s.data[k], c.data[k], x.size());
+	}
+}
@@ -0,0 +1,464 @@
+/*!
+\file
+Contains SIMDVector4, a four float vector which is kept in a register
+between operations.
+*/
+
+#pragma once
+
+#include "simd.h"
+#include "../vec/vec_impl.h"
+
+namespace mutil
+{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+	namespace __1
+	{
+		template <int I>
+		MUTIL_FORCEINLINE float MUTIL_VECTORCALL vlane(vfloat4 a)
+		{
+#if MUTIL_USE_SSE
+			return _mm_cvtss_f32(vshuffle<I, I, I, I>(a, a));
+#else
+			return vgetq_lane_f32(a, I);
+#endif
+		}
+
+		// The sum of all four lanes, in every lane.
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL vsum4(vfloat4 a)
+		{
+			const vfloat4 s = vadd(a, vshuffle<2, 3, 0, 1>(a, a));
+			return vadd(s, vshuffle<1, 0, 3, 2>(s, s));
+		}
+	}
+#endif
+
+	/*!
+	Four floats held in a SIMD register. The vector types are stored in memory,
+	so a chain of operations such as normalize(a * b + c) on Vector4 loads and
+	stores every intermediate result. A chain on SIMDVector4 stays in registers
+	from the first load to the last store.
+
+	It is passed by value, which keeps it in a register across calls. Load it
+	from and store it to the vector types explicitly, with its constructors and
+	the to* functions. Functions which reduce the lanes, such as dot and length,
+	return their result in every lane so that it can be used in further
+	operations without a conversion. Use x() to get it as a float.
+
+	Without intrinsics, the lanes are four floats worked on one at a time.
+	*/
+	class SIMDVector4
+	{
+	public:
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		__1::vfloat4 v;
+#else
+		float v[4];
+#endif
+
+		MUTIL_FORCEINLINE SIMDVector4();
+		explicit MUTIL_FORCEINLINE SIMDVector4(float a);
+		MUTIL_FORCEINLINE SIMDVector4(float x, float y, float z, float w);
+		explicit MUTIL_FORCEINLINE SIMDVector4(const Vector4 &a);
+		explicit MUTIL_FORCEINLINE SIMDVector4(const Vector3 &a, float w = 0.0f);
+		explicit MUTIL_FORCEINLINE SIMDVector4(const Vector3A &a);
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		explicit MUTIL_FORCEINLINE SIMDVector4(__1::vfloat4 v) : v(v) {}
+#endif
+
+		/*!
+		Loads four floats.
+
+		@param p The floats to load, need not be aligned.
+		*/
+		static MUTIL_FORCEINLINE SIMDVector4 load(const float *p);
+
+		/*!
+		Loads four floats.
+
+		@param p The floats to load, which must be aligned to 16 bytes.
+		*/
+		static MUTIL_FORCEINLINE SIMDVector4 loadAligned(const float *p);
+
+		MUTIL_FORCEINLINE void store(float *p) const;
+		MUTIL_FORCEINLINE void storeAligned(float *p) const;
+
+		MUTIL_FORCEINLINE Vector4 tovector4() const;
+		MUTIL_FORCEINLINE Vector3 tovector3() const;
+		MUTIL_FORCEINLINE Vector3A tovector3a() const;
+
+		MUTIL_FORCEINLINE float x() const;
+		MUTIL_FORCEINLINE float y() const;
+		MUTIL_FORCEINLINE float z() const;
+		MUTIL_FORCEINLINE float w() const;
+
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator+=(SIMDVector4 a);
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator-=(SIMDVector4 a);
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator*=(SIMDVector4 a);
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator*=(float a);
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator/=(SIMDVector4 a);
+		MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL operator/=(float a);
+	};
+
+	/*!
+	The result of comparing two SIMDVector4, one flag per lane, for select,
+	any and all.
+	*/
+	class SIMDMask4
+	{
+	public:
+#if MUTIL_USE_SSE
+		__m128 m;
+#elif MUTIL_USE_NEON
+		uint32x4_t m;
+#else
+		bool m[4];
+#endif
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// SIMDVector4
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4() : v(__1::vset1(__1::vfloat4(), 0.0f)) {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(float a) : v(__1::vset1(__1::vfloat4(), a)) {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(float x, float y, float z, float w) : v(__1::vsetr(__1::vfloat4(), x, y, z, w)) {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector4 &a) : v(__1::vloadu(__1::vfloat4(), a.vec)) {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector3A &a) : v(__1::vload(__1::vfloat4(), a.vec)) {}
+
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector3 &a, float w)
+	{
+		// never a full register load, which would read past the end of a
+#if MUTIL_USE_SSE
+		v = _mm_insert_ps(__1::vloadvec3(a.vec), _mm_set_ss(w), 0x30);
+#else
+		v = vcombine_f32(vld1_f32(a.vec), vset_lane_f32(w, vdup_n_f32(a.z), 1));
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 SIMDVector4::load(const float *p) { return SIMDVector4(__1::vloadu(__1::vfloat4(), p)); }
+	MUTIL_FORCEINLINE SIMDVector4 SIMDVector4::loadAligned(const float *p) { return SIMDVector4(__1::vload(__1::vfloat4(), p)); }
+	MUTIL_FORCEINLINE void SIMDVector4::store(float *p) const { __1::vstoreu(p, v); }
+	MUTIL_FORCEINLINE void SIMDVector4::storeAligned(float *p) const { __1::vstore(p, v); }
+
+	MUTIL_FORCEINLINE Vector3 SIMDVector4::tovector3() const
+	{
+		Vector3 result;
+#if MUTIL_USE_SSE
+		_mm_storel_pi((__m64 *)result.vec, v);
+		_mm_store_ss(&result.z, _mm_movehl_ps(v, v));
+#else
+		vst1_f32(result.vec, vget_low_f32(v));
+		result.z = vgetq_lane_f32(v, 2);
+#endif
+		return result;
+	}
+
+	MUTIL_FORCEINLINE float SIMDVector4::x() const { return __1::vfirst(v); }
+	MUTIL_FORCEINLINE float SIMDVector4::y() const { return __1::vlane<1>(v); }
+	MUTIL_FORCEINLINE float SIMDVector4::z() const { return __1::vlane<2>(v); }
+	MUTIL_FORCEINLINE float SIMDVector4::w() const { return __1::vlane<3>(v); }
+#else
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4() : v{0.0f, 0.0f, 0.0f, 0.0f} {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(float a) : v{a, a, a, a} {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(float x, float y, float z, float w) : v{x, y, z, w} {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector4 &a) : v{a.x, a.y, a.z, a.w} {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector3A &a) : v{a.x, a.y, a.z, a.padding} {}
+	MUTIL_FORCEINLINE SIMDVector4::SIMDVector4(const Vector3 &a, float w) : v{a.x, a.y, a.z, w} {}
+
+	MUTIL_FORCEINLINE SIMDVector4 SIMDVector4::load(const float *p) { return SIMDVector4(p[0], p[1], p[2], p[3]); }
+	MUTIL_FORCEINLINE SIMDVector4 SIMDVector4::loadAligned(const float *p) { return load(p); }
+
+	MUTIL_FORCEINLINE void SIMDVector4::store(float *p) const
+	{
+		for (size_t i = 0; i < 4; i++)
+			p[i] = v[i];
+	}
+
+	MUTIL_FORCEINLINE void SIMDVector4::storeAligned(float *p) const { store(p); }
+
+	MUTIL_FORCEINLINE Vector3 SIMDVector4::tovector3() const { return Vector3(v[0], v[1], v[2]); }
+
+	MUTIL_FORCEINLINE float SIMDVector4::x() const { return v[0]; }
+	MUTIL_FORCEINLINE float SIMDVector4::y() const { return v[1]; }
+	MUTIL_FORCEINLINE float SIMDVector4::z() const { return v[2]; }
+	MUTIL_FORCEINLINE float SIMDVector4::w() const { return v[3]; }
+#endif
+
+	MUTIL_FORCEINLINE Vector4 SIMDVector4::tovector4() const
+	{
+		Vector4 result;
+		store(result.vec);
+		return result;
+	}
+
+	MUTIL_FORCEINLINE Vector3A SIMDVector4::tovector3a() const
+	{
+		Vector3A result;
+		storeAligned(result.vec);
+		return result;
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator+(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vadd(a.v, b.v));
+#else
+		return SIMDVector4(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]);
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator-(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vsub(a.v, b.v));
+#else
+		return SIMDVector4(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]);
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator*(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vmul(a.v, b.v));
+#else
+		return SIMDVector4(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator/(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vdiv(a.v, b.v));
+#else
+		return SIMDVector4(a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]);
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator*(SIMDVector4 a, float b) { return a * SIMDVector4(b); }
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator*(float a, SIMDVector4 b) { return SIMDVector4(a) * b; }
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator/(SIMDVector4 a, float b) { return a / SIMDVector4(b); }
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL operator-(SIMDVector4 a) { return SIMDVector4() - a; }
+
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator+=(SIMDVector4 a) { return *this = *this + a; }
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator-=(SIMDVector4 a) { return *this = *this - a; }
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator*=(SIMDVector4 a) { return *this = *this * a; }
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator*=(float a) { return *this = *this * a; }
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator/=(SIMDVector4 a) { return *this = *this / a; }
+	MUTIL_FORCEINLINE SIMDVector4 &MUTIL_VECTORCALL SIMDVector4::operator/=(float a) { return *this = *this / a; }
+
+	/*!
+	Computes a * b + c, fused into one instruction where the target has one.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL fmadd(SIMDVector4 a, SIMDVector4 b, SIMDVector4 c)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vfmadd(a.v, b.v, c.v));
+#else
+		return a * b + c;
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL min(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vmin(a.v, b.v));
+#else
+		return SIMDVector4(__1::vmin(a.v[0], b.v[0]), __1::vmin(a.v[1], b.v[1]), __1::vmin(a.v[2], b.v[2]), __1::vmin(a.v[3], b.v[3]));
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL max(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vmax(a.v, b.v));
+#else
+		return SIMDVector4(__1::vmax(a.v[0], b.v[0]), __1::vmax(a.v[1], b.v[1]), __1::vmax(a.v[2], b.v[2]), __1::vmax(a.v[3], b.v[3]));
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL abs(SIMDVector4 a)
+	{
+#if MUTIL_USE_SSE
+		return SIMDVector4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));
+#elif MUTIL_USE_NEON
+		return SIMDVector4(vabsq_f32(a.v));
+#else
+		return SIMDVector4(fabsf(a.v[0]), fabsf(a.v[1]), fabsf(a.v[2]), fabsf(a.v[3]));
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL sqrt(SIMDVector4 a)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vsqrt(a.v));
+#else
+		return SIMDVector4(sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]));
+#endif
+	}
+
+	/*!
+	Computes 1 / sqrt(a) in every lane, to about 22 bits.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL rsqrt(SIMDVector4 a)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vrsqrt(a.v));
+#else
+		return SIMDVector4(1.0f) / sqrt(a);
+#endif
+	}
+
+	/*!
+	Computes the dot product of all four lanes.
+
+	@return The dot product, in every lane.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL dot(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vsum4(__1::vmul(a.v, b.v)));
+#else
+		return SIMDVector4(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+#endif
+	}
+
+	/*!
+	Computes the dot product of the x, y and z lanes, ignoring w.
+
+	@return The dot product, in every lane.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL dot3(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vsum3(__1::vmul(a.v, b.v)));
+#else
+		return SIMDVector4(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2]);
+#endif
+	}
+
+	/*!
+	Computes the cross product of the x, y and z lanes.
+
+	@return The cross product, with w set to 0.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL cross(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		// as for Vector3A, the cross product is in zxy order. Its w lane is
+		// a.w * b.w - a.w * b.w, which is not 0 once fused into a single
+		// rounding, so it is replaced by a zero lane.
+		const vfloat4 c = vfnmadd(vshuffle<1, 2, 0, 3>(a.v, a.v), b.v, vmul(a.v, vshuffle<1, 2, 0, 3>(b.v, b.v)));
+		const vfloat4 z = vshuffle<0, 0, 0, 0>(c, vset1(c, 0.0f));
+		return SIMDVector4(vshuffle<1, 2, 0, 2>(c, z));
+#else
+		return SIMDVector4(
+			a.v[1] * b.v[2] - b.v[1] * a.v[2],
+			a.v[2] * b.v[0] - b.v[2] * a.v[0],
+			a.v[0] * b.v[1] - b.v[0] * a.v[1],
+			0.0f);
+#endif
+	}
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL length(SIMDVector4 a) { return sqrt(dot(a, a)); }
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL length3(SIMDVector4 a) { return sqrt(dot3(a, a)); }
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL normalize(SIMDVector4 a) { return a * rsqrt(dot(a, a)); }
+
+	/*!
+	Scales a so that its x, y and z lanes have a length of 1. The w lane is
+	scaled by the same factor.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL normalize3(SIMDVector4 a) { return a * rsqrt(dot3(a, a)); }
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL lerp(SIMDVector4 a, SIMDVector4 b, float t) { return fmadd(b - a, SIMDVector4(t), a); }
+
+	/*!
+	Rearranges the lanes of a vector.
+
+	@return (a[X], a[Y], a[Z], a[W]).
+	*/
+	template <int X, int Y, int Z, int W>
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL swizzle(SIMDVector4 a)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vshuffle<X, Y, Z, W>(a.v, a.v));
+#else
+		return SIMDVector4(a.v[X], a.v[Y], a.v[Z], a.v[W]);
+#endif
+	}
+
+	/*!
+	Combines the lanes of two vectors, as _mm_shuffle_ps.
+
+	@return (a[X], a[Y], b[Z], b[W]).
+	*/
+	template <int X, int Y, int Z, int W>
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL shuffle(SIMDVector4 a, SIMDVector4 b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		return SIMDVector4(__1::vshuffle<X, Y, Z, W>(a.v, b.v));
+#else
+		return SIMDVector4(a.v[X], a.v[Y], b.v[Z], b.v[W]);
+#endif
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// SIMDMask4
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL lessThan(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{__1::vlt(a.v, b.v)}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL lessThanEqual(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{__1::vle(a.v, b.v)}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL greaterThan(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{__1::vgt(a.v, b.v)}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL greaterThanEqual(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{__1::vle(b.v, a.v)}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL equal(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{__1::veq(a.v, b.v)}; }
+
+	/*!
+	Picks each lane from a where the mask is set and from b elsewhere.
+	*/
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL select(SIMDMask4 m, SIMDVector4 a, SIMDVector4 b) { return SIMDVector4(__1::vselect(m.m, a.v, b.v)); }
+#else
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL lessThan(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{{a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]}}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL lessThanEqual(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{{a.v[0] <= b.v[0], a.v[1] <= b.v[1], a.v[2] <= b.v[2], a.v[3] <= b.v[3]}}; }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL greaterThan(SIMDVector4 a, SIMDVector4 b) { return lessThan(b, a); }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL greaterThanEqual(SIMDVector4 a, SIMDVector4 b) { return lessThanEqual(b, a); }
+	MUTIL_FORCEINLINE SIMDMask4 MUTIL_VECTORCALL equal(SIMDVector4 a, SIMDVector4 b) { return SIMDMask4{{a.v[0] == b.v[0], a.v[1] == b.v[1], a.v[2] == b.v[2], a.v[3] == b.v[3]}}; }
+
+	MUTIL_FORCEINLINE SIMDVector4 MUTIL_VECTORCALL select(SIMDMask4 m, SIMDVector4 a, SIMDVector4 b)
+	{
+		return SIMDVector4(m.m[0] ? a.v[0] : b.v[0], m.m[1] ? a.v[1] : b.v[1], m.m[2] ? a.v[2] : b.v[2], m.m[3] ? a.v[3] : b.v[3]);
+	}
+#endif
+
+	/*!
+	Checks whether the mask is set in any lane.
+	*/
+	MUTIL_FORCEINLINE bool MUTIL_VECTORCALL any(SIMDMask4 m)
+	{
+#if MUTIL_USE_SSE
+		return _mm_movemask_ps(m.m) != 0;
+#elif MUTIL_USE_NEON
+		const uint32x2_t r = vorr_u32(vget_low_u32(m.m), vget_high_u32(m.m));
+		return (vget_lane_u32(r, 0) | vget_lane_u32(r, 1)) != 0;
+#else
+		return m.m[0] || m.m[1] || m.m[2] || m.m[3];
+#endif
+	}
+
+	/*!
+	Checks whether the mask is set in every lane.
+	*/
+	MUTIL_FORCEINLINE bool MUTIL_VECTORCALL all(SIMDMask4 m)
+	{
+#if MUTIL_USE_SSE
+		return _mm_movemask_ps(m.m) == 0xf;
+#elif MUTIL_USE_NEON
+		const uint32x2_t r = vand_u32(vget_low_u32(m.m), vget_high_u32(m.m));
+		return (vget_lane_u32(r, 0) & vget_lane_u32(r, 1)) != 0;
+#else
+		return m.m[0] && m.m[1] && m.m[2] && m.m[3];
+#endif
+	}
+}
@@ -9,3 +9,4 @@
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
+#include "vector3a.h"
@@ -0,0 +1,268 @@
+/*!
+\file
+Contains the opt-in expression templates which evaluate element-wise
+expressions on the generic vector and matrix types in a single loop.
+*/
+
+#pragma once
+
+#include "vec.h"
+
+namespace mutil
+{
+	namespace __1
+	{
+		/*
+		ExprTraits<R> describes the type R which an expression evaluates to:
+		its element type, its number of elements and whether operator* on two
+		of them multiplies element-wise. The elements of R are accessed
+		linearly through operator[].
+		*/
+		template <typename R>
+		struct ExprTraits;
+
+		template <typename T, size_t N>
+		struct ExprTraits<BasicVector<T, N>>
+		{
+			using type = T;
+			static constexpr size_t size = N;
+			static constexpr bool elementwise = true;
+		};
+
+		/*
+		Base of every expression node, E being the node itself. Nothing is
+		computed until the expression is converted to R, which then evaluates
+		all of it in one loop over the elements.
+		*/
+		template <typename E, typename R>
+		class Expr
+		{
+		public:
+			constexpr const E &self() const { return static_cast<const E &>(*this); }
+
+			constexpr R eval() const
+			{
+				R result;
+				for (size_t i = 0; i < ExprTraits<R>::size; i++)
+					result[i] = self()[i];
+				return result;
+			}
+
+			constexpr operator R() const { return eval(); }
+		};
+
+		template <typename R>
+		class ExprRef : public Expr<ExprRef<R>, R>
+		{
+		public:
+			using T = typename ExprTraits<R>::type;
+
+			constexpr explicit ExprRef(const R &a) : a(a) {}
+
+			constexpr T operator[](size_t i) const { return a[i]; }
+
+		private:
+			const R &a;
+		};
+
+		template <typename Op, typename A, typename B, typename R>
+		class ExprBinary : public Expr<ExprBinary<Op, A, B, R>, R>
+		{
+		public:
+			using T = typename ExprTraits<R>::type;
+
+			constexpr ExprBinary(const A &a, const B &b) : a(a), b(b) {}
+
+			constexpr T operator[](size_t i) const { return Op::apply(a[i], b[i]); }
+
+		private:
+			A a;
+			B b;
+		};
+
+		template <typename Op, typename A, typename R>
+		class ExprScalar : public Expr<ExprScalar<Op, A, R>, R>
+		{
+		public:
+			using T = typename ExprTraits<R>::type;
+
+			constexpr ExprScalar(const A &a, T b) : a(a), b(b) {}
+
+			constexpr T operator[](size_t i) const { return Op::apply(a[i], b); }
+
+		private:
+			A a;
+			T b;
+		};
+
+		template <typename A, typename R>
+		class ExprNegate : public Expr<ExprNegate<A, R>, R>
+		{
+		public:
+			using T = typename ExprTraits<R>::type;
+
+			constexpr explicit ExprNegate(const A &a) : a(a) {}
+
+			constexpr T operator[](size_t i) const { return -a[i]; }
+
+		private:
+			A a;
+		};
+
+		struct ExprAdd { template <typename T> static constexpr T apply(T a, T b) { return a + b; } };
+		struct ExprSub { template <typename T> static constexpr T apply(T a, T b) { return a - b; } };
+		struct ExprMul { template <typename T> static constexpr T apply(T a, T b) { return a * b; } };
+		struct ExprDiv { template <typename T> static constexpr T apply(T a, T b) { return a / b; } };
+	}
+
+	/*!
+	Starts a lazily evaluated expression. Operators on the result build the
+	expression instead of computing it, and converting it to the vector or
+	matrix type computes every element in one pass, without a temporary for
+	each step:
+
+	BasicVector<float, 64> r = lazy(a) * s + lazy(b) * t - c;
+
+	Only element-wise operations are lazy. For the specialized types
+	(Vector2, Matrix4, IntVector3, ...) lazy returns its argument, so they
+	keep their eager SIMD operators.
+
+	The expression refers to its operands, so it must be evaluated before
+	they are destroyed. Do not keep it in an auto variable.
+
+	@param a The vector to start the expression with.
+
+	@return An expression referring to a.
+	*/
+	template <typename T, size_t N>
+	constexpr __1::ExprRef<BasicVector<T, N>> lazy(const BasicVector<T, N> &a)
+	{
+		return __1::ExprRef<BasicVector<T, N>>(a);
+	}
+
+	constexpr const Vector2 &lazy(const Vector2 &a) { return a; }
+	constexpr const Vector3 &lazy(const Vector3 &a) { return a; }
+	constexpr const Vector4 &lazy(const Vector4 &a) { return a; }
+	constexpr const IntVector2 &lazy(const IntVector2 &a) { return a; }
+	constexpr const IntVector3 &lazy(const IntVector3 &a) { return a; }
+	constexpr const IntVector4 &lazy(const IntVector4 &a) { return a; }
+
+	/*!
+	Evaluates an expression into existing storage. Every element is read
+	only by its own position, so out may also be an operand.
+
+	@param out Receives the result.
+	@param e The expression to evaluate.
+	*/
+	template <typename E, typename R>
+	constexpr void assign(R &out, const __1::Expr<E, R> &e)
+	{
+		for (size_t i = 0; i < __1::ExprTraits<R>::size; i++)
+			out[i] = e.self()[i];
+	}
+
+	template <typename A, typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprAdd, A, B, R> operator+(const __1::Expr<A, R> &a, const __1::Expr<B, R> &b)
+	{
+		return __1::ExprBinary<__1::ExprAdd, A, B, R>(a.self(), b.self());
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprBinary<__1::ExprAdd, A, __1::ExprRef<R>, R> operator+(const __1::Expr<A, R> &a, const R &b)
+	{
+		return __1::ExprBinary<__1::ExprAdd, A, __1::ExprRef<R>, R>(a.self(), __1::ExprRef<R>(b));
+	}
+
+	template <typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprAdd, __1::ExprRef<R>, B, R> operator+(const R &a, const __1::Expr<B, R> &b)
+	{
+		return __1::ExprBinary<__1::ExprAdd, __1::ExprRef<R>, B, R>(__1::ExprRef<R>(a), b.self());
+	}
+
+	template <typename A, typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprSub, A, B, R> operator-(const __1::Expr<A, R> &a, const __1::Expr<B, R> &b)
+	{
+		return __1::ExprBinary<__1::ExprSub, A, B, R>(a.self(), b.self());
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprBinary<__1::ExprSub, A, __1::ExprRef<R>, R> operator-(const __1::Expr<A, R> &a, const R &b)
+	{
+		return __1::ExprBinary<__1::ExprSub, A, __1::ExprRef<R>, R>(a.self(), __1::ExprRef<R>(b));
+	}
+
+	template <typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprSub, __1::ExprRef<R>, B, R> operator-(const R &a, const __1::Expr<B, R> &b)
+	{
+		return __1::ExprBinary<__1::ExprSub, __1::ExprRef<R>, B, R>(__1::ExprRef<R>(a), b.self());
+	}
+
+	// operator* and operator/ on two operands are element-wise, which is only
+	// what they mean for vectors
+
+	template <typename A, typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprMul, A, B, R> operator*(const __1::Expr<A, R> &a, const __1::Expr<B, R> &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise products can be lazy");
+		return __1::ExprBinary<__1::ExprMul, A, B, R>(a.self(), b.self());
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprBinary<__1::ExprMul, A, __1::ExprRef<R>, R> operator*(const __1::Expr<A, R> &a, const R &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise products can be lazy");
+		return __1::ExprBinary<__1::ExprMul, A, __1::ExprRef<R>, R>(a.self(), __1::ExprRef<R>(b));
+	}
+
+	template <typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprMul, __1::ExprRef<R>, B, R> operator*(const R &a, const __1::Expr<B, R> &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise products can be lazy");
+		return __1::ExprBinary<__1::ExprMul, __1::ExprRef<R>, B, R>(__1::ExprRef<R>(a), b.self());
+	}
+
+	template <typename A, typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprDiv, A, B, R> operator/(const __1::Expr<A, R> &a, const __1::Expr<B, R> &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise quotients can be lazy");
+		return __1::ExprBinary<__1::ExprDiv, A, B, R>(a.self(), b.self());
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprBinary<__1::ExprDiv, A, __1::ExprRef<R>, R> operator/(const __1::Expr<A, R> &a, const R &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise quotients can be lazy");
+		return __1::ExprBinary<__1::ExprDiv, A, __1::ExprRef<R>, R>(a.self(), __1::ExprRef<R>(b));
+	}
+
+	template <typename B, typename R>
+	constexpr __1::ExprBinary<__1::ExprDiv, __1::ExprRef<R>, B, R> operator/(const R &a, const __1::Expr<B, R> &b)
+	{
+		static_assert(__1::ExprTraits<R>::elementwise, "only element-wise quotients can be lazy");
+		return __1::ExprBinary<__1::ExprDiv, __1::ExprRef<R>, B, R>(__1::ExprRef<R>(a), b.self());
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprScalar<__1::ExprMul, A, R> operator*(const __1::Expr<A, R> &a, typename __1::ExprTraits<R>::type b)
+	{
+		return __1::ExprScalar<__1::ExprMul, A, R>(a.self(), b);
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprScalar<__1::ExprMul, A, R> operator*(typename __1::ExprTraits<R>::type a, const __1::Expr<A, R> &b)
+	{
+		return __1::ExprScalar<__1::ExprMul, A, R>(b.self(), a);
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprScalar<__1::ExprDiv, A, R> operator/(const __1::Expr<A, R> &a, typename __1::ExprTraits<R>::type b)
+	{
+		return __1::ExprScalar<__1::ExprDiv, A, R>(a.self(), b);
+	}
+
+	template <typename A, typename R>
+	constexpr __1::ExprNegate<A, R> operator-(const __1::Expr<A, R> &a)
+	{
+		return __1::ExprNegate<A, R>(a.self());
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vec.h"
+#include "../simd/simd.h"
 
 namespace mutil
 {
@@ -238,6 +239,26 @@ namespace mutil
 		return result;
 	}
 
+#if MUTIL_USE_SSE
+	namespace __1
+	{
+		// Load exactly the 8 bytes of a Vector2 or the 12 of a Vector3 and zero
+		// the remaining lanes. A 16 byte load would read past the end of the
+		// object, which faults when the object ends a page.
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vloadvec2(const float *p)
+		{
+			// __m64 may alias the floats, unlike the double _mm_load_sd would take
+			return _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p);
+		}
+
+		MUTIL_FORCEINLINE __m128 MUTIL_VECTORCALL vloadvec3(const float *p)
+		{
+			return _mm_movelh_ps(vloadvec2(p), _mm_load_ss(p + 2));
+		}
+	}
+#endif
+
 	/////////////////////////////////////////////////////////////////
 	// Vector2
 
@@ -296,7 +317,7 @@ namespace mutil
 	{
 #if MUTIL_USE_SSE
 		constexpr int MASK = 0x31;
-		return _mm_cvtss_f32(_mm_dp_ps(_mm_loadu_ps((float *)&first), _mm_loadu_ps((float *)&second), MASK));
+		return _mm_cvtss_f32(_mm_dp_ps(__1::vloadvec2(&first.x), __1::vloadvec2(&second.x), MASK));
 #elif MUTIL_USE_NEON
 		float32x2_t a, b;
 
@@ -316,7 +337,7 @@ namespace mutil
 	{
 #if MUTIL_USE_SSE
 		constexpr int MASK = 0x31;
-		return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(_mm_loadu_ps((float *)&vec), _mm_loadu_ps((float *)&vec), MASK)));
+		return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(__1::vloadvec2(&vec.x), __1::vloadvec2(&vec.x), MASK)));
 #elif MUTIL_USE_NEON
 		float32_t result = dot(vec, vec);
 		float32x2_t a = vsqrt_f32(vld1_f32(&result));
@@ -342,6 +363,7 @@ namespace mutil
 	constexpr Vector3::BasicVector(float x, const Vector2 &yz) : x(x), y(yz.x), z(yz.y) {}
 	constexpr Vector3::BasicVector(const Vector2 &xy) : x(xy.x), y(xy.y), z(0) {}
 	constexpr Vector3::BasicVector(const Vector4 &a) : x(a.x), y(a.y), z(a.z) {}
+	constexpr Vector3::BasicVector(const Vector3A &a) : x(a.x), y(a.y), z(a.z) {}
 
 	constexpr Vector3 &Vector3::operator+=(const Vector3 &a)
 	{
@@ -397,7 +419,7 @@ namespace mutil
 	{
 #if MUTIL_USE_SSE
 		constexpr int MASK = 0x71;
-		return _mm_cvtss_f32(_mm_dp_ps(_mm_loadu_ps((float *)&a), _mm_loadu_ps((float *)&b), MASK));
+		return _mm_cvtss_f32(_mm_dp_ps(__1::vloadvec3(&a.x), __1::vloadvec3(&b.x), MASK));
 #elif MUTIL_USE_NEON
 		Vector4 va(a, 0.0f);
 		Vector4 vb(b, 0.0f);
@@ -426,7 +448,7 @@ namespace mutil
 	{
 #if MUTIL_USE_SSE
 		constexpr int MASK = 0x71;
-		return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(_mm_loadu_ps((float *)&a), _mm_loadu_ps((float *)&a), MASK)));
+		return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(__1::vloadvec3(&a.x), __1::vloadvec3(&a.x), MASK)));
 #elif MUTIL_USE_NEON
 		float32_t result = dot(a, a);
 		float32x2_t r = vsqrt_f32(vld1_f32(&result));
@@ -569,6 +591,221 @@ namespace mutil
 	MUTIL_FORCEINLINE Vector4 MUTIL_VECTORCALL normalize(const Vector4 &a) { return a * fastInverseSqrt(dot(a, a)); }
 	MUTIL_FORCEINLINE Vector4 MUTIL_VECTORCALL reflect(const Vector4 &a, const Vector4 &N) { return (N * (2.0f * dot(N, a))) - a; }
 
+	/////////////////////////////////////////////////////////////////
+	// Vector3A
+
+	constexpr Vector3A::Vector3A() : x(0), y(0), z(0), padding(0) {}
+	constexpr Vector3A::Vector3A(float a) : x(a), y(a), z(a), padding(0) {}
+	constexpr Vector3A::Vector3A(float x, float y, float z) : x(x), y(y), z(z), padding(0) {}
+	constexpr Vector3A::Vector3A(const Vector3 &a) : x(a.x), y(a.y), z(a.z), padding(0) {}
+
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+	namespace __1
+	{
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL vloadvec3a(const Vector3A &a) { return vload(vfloat4(), a.vec); }
+
+		MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL vtovec3a(vfloat4 a)
+		{
+			Vector3A result;
+			vstore(result.vec, a);
+			return result;
+		}
+
+		// The sum of lanes 0, 1 and 2, in every lane.
+		MUTIL_FORCEINLINE vfloat4 MUTIL_VECTORCALL vsum3(vfloat4 a)
+		{
+			const vfloat4 s = vadd(vadd(a, vshuffle<1, 1, 1, 1>(a, a)), vshuffle<2, 2, 2, 2>(a, a));
+			return vshuffle<0, 0, 0, 0>(s, s);
+		}
+	}
+#endif
+
+	inline Vector3A &Vector3A::operator+=(const Vector3A &a) { return *this = *this + a; }
+	inline Vector3A &Vector3A::operator-=(const Vector3A &a) { return *this = *this - a; }
+	inline Vector3A &Vector3A::operator*=(const Vector3A &a) { return *this = *this * a; }
+	inline Vector3A &Vector3A::operator*=(float a) { return *this = *this * a; }
+	inline Vector3A &Vector3A::operator/=(const Vector3A &a) { return *this = *this / a; }
+	inline Vector3A &Vector3A::operator/=(float a) { return *this = *this / a; }
+
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL Vector3A::length() const { return mutil::length(*this); }
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL Vector3A::lengthSq() const { return mutil::lengthSq(*this); }
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL Vector3A::normalized() const { return mutil::normalize(*this); }
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator+(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vadd(vloadvec3a(a), vloadvec3a(b)));
+#else
+		return Vector3A(a.x + b.x, a.y + b.y, a.z + b.z);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator-(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vsub(vloadvec3a(a), vloadvec3a(b)));
+#else
+		return Vector3A(a.x - b.x, a.y - b.y, a.z - b.z);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vmul(vloadvec3a(a), vloadvec3a(b)));
+#else
+		return Vector3A(a.x * b.x, a.y * b.y, a.z * b.z);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Vector3A &a, float b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vmul(vloadvec3a(a), vset1(vfloat4(), b)));
+#else
+		return Vector3A(a.x * b, a.y * b, a.z * b);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(float a, const Vector3A &b) { return b * a; }
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator/(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vdiv(vloadvec3a(a), vloadvec3a(b)));
+#else
+		return Vector3A(a.x / b.x, a.y / b.y, a.z / b.z);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator/(const Vector3A &a, float b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vdiv(vloadvec3a(a), vset1(vfloat4(), b)));
+#else
+		return Vector3A(a.x / b, a.y / b, a.z / b);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator-(const Vector3A &a)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vtovec3a(vsub(vset1(vfloat4(), 0.0f), vloadvec3a(a)));
+#else
+		return Vector3A(-a.x, -a.y, -a.z);
+#endif
+	}
+
+	constexpr bool operator==(const Vector3A &a, const Vector3A &b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+	constexpr bool operator!=(const Vector3A &a, const Vector3A &b) { return !(a == b); }
+
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL dot(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		return vfirst(vsum3(vmul(vloadvec3a(a), vloadvec3a(b))));
+#else
+		return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+#endif
+	}
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL cross(const Vector3A &a, const Vector3A &b)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		// a * b.yzx - a.yzx * b is the cross product in zxy order, so one
+		// rotation of the lanes less than the textbook form is needed
+		const vfloat4 va = vloadvec3a(a);
+		const vfloat4 vb = vloadvec3a(b);
+		const vfloat4 c = vfnmadd(vshuffle<1, 2, 0, 3>(va, va), vb, vmul(va, vshuffle<1, 2, 0, 3>(vb, vb)));
+		return vtovec3a(vshuffle<1, 2, 0, 3>(c, c));
+#else
+		return Vector3A(
+			(a.y * b.z - b.y * a.z),
+			(a.z * b.x - b.z * a.x),
+			(a.x * b.y - b.x * a.y));
+#endif
+	}
+
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL length(const Vector3A &a) { return sqrtf(dot(a, a)); }
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL lengthSq(const Vector3A &a) { return dot(a, a); }
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL distance(const Vector3A &a, const Vector3A &b) { return length(b - a); }
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL normalize(const Vector3A &a)
+	{
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+		const vfloat4 va = vloadvec3a(a);
+		return vtovec3a(vmul(va, vrsqrt(vsum3(vmul(va, va)))));
+#else
+		return a * fastInverseSqrt(dot(a, a));
+#endif
+	}
+
+	/*!
+	Converts tightly packed vectors into aligned ones. The padding of the
+	results is unspecified.
+
+	@param in The vectors to convert.
+	@param out Receives the converted vectors. Must not overlap in.
+	@param count The number of vectors.
+	*/
+	inline void alignVectors(const Vector3 *in, Vector3A *out, size_t count)
+	{
+		size_t i = 0;
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		// four vectors are exactly three registers, which vload3x4 splits
+		// without reading past the last of them
+		const size_t full = count - count % 4;
+		for (; i < full; i += 4)
+		{
+			vfloat4 a, b, c, d;
+			vload3x4(in[i].vec, a, b, c, d);
+			vstore(out[i].vec, a);
+			vstore(out[i + 1].vec, b);
+			vstore(out[i + 2].vec, c);
+			vstore(out[i + 3].vec, d);
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = Vector3A(in[i]);
+	}
+
+	/*!
+	Converts aligned vectors into tightly packed ones, dropping the padding.
+
+	@param in The vectors to convert.
+	@param out Receives the converted vectors. Must not overlap in.
+	@param count The number of vectors.
+	*/
+	inline void packVectors(const Vector3A *in, Vector3 *out, size_t count)
+	{
+		size_t i = 0;
+#if MUTIL_USE_SSE || MUTIL_USE_NEON
+		using namespace __1;
+
+		const size_t full = count - count % 4;
+		for (; i < full; i += 4)
+		{
+			vstore3x4(out[i].vec,
+				vload(vfloat4(), in[i].vec), vload(vfloat4(), in[i + 1].vec),
+				vload(vfloat4(), in[i + 2].vec), vload(vfloat4(), in[i + 3].vec));
+		}
+#endif
+		for (; i < count; i++)
+			out[i] = Vector3(in[i]);
+	}
+
 	/////////////////////////////////////////////////////////////////
 	// IntVector2
 
@@ -0,0 +1,503 @@
+/*!
+\file
+Contains structure-of-arrays vector containers and the batched kernels which
+operate on them.
+*/
+
+#pragma once
+
+#include "vec.h"
+#include "../simd/simd.h"
+
+#include <cstring>
+
+namespace mutil
+{
+	namespace __1
+	{
+		template <size_t N>
+		struct StreamComponents;
+
+		template <>
+		struct StreamComponents<3>
+		{
+			union
+			{
+				struct { float *x, *y, *z; };
+				float *data[3];
+			};
+		};
+
+		template <>
+		struct StreamComponents<4>
+		{
+			union
+			{
+				struct { float *x, *y, *z, *w; };
+				float *data[4];
+			};
+		};
+	}
+
+	/*!
+	A structure-of-arrays container of N-component vectors. Each component is
+	stored in its own array (x, y, z, ...), every array is aligned to
+	MUTIL_STREAM_ALIGNMENT bytes and the capacity is always a multiple of 16
+	elements, so a full register can be loaded from any multiple of
+	MUTIL_SIMD_WIDTH. Components declares the pointers to the arrays, which are
+	named differently by QuaternionStream.
+	*/
+	template <size_t N, typename Components = __1::StreamComponents<N>>
+	class VectorStream : public Components
+	{
+	public:
+		using Components::data;
+
+		VectorStream();
+		explicit VectorStream(size_t count);
+		VectorStream(const VectorStream &a);
+		VectorStream(VectorStream &&a);
+		~VectorStream();
+
+		VectorStream &operator=(const VectorStream &a);
+		VectorStream &operator=(VectorStream &&a);
+
+		size_t size() const { return _size; }
+		size_t capacity() const { return _capacity; }
+		bool empty() const { return _size == 0; }
+
+		void reserve(size_t count);
+		void resize(size_t count);
+		void clear() { _size = 0; }
+
+		Vector<N> get(size_t i) const;
+		void set(size_t i, const Vector<N> &a);
+
+	private:
+		float *_block;
+		size_t _size;
+		size_t _capacity;
+
+		void setPointers();
+	};
+
+	using Vector3Stream = VectorStream<3>;
+	using Vector4Stream = VectorStream<4>;
+
+	template <size_t N, typename C>
+	VectorStream<N, C>::VectorStream() : _block(nullptr), _size(0), _capacity(0)
+	{
+		setPointers();
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C>::VectorStream(size_t count) : VectorStream()
+	{
+		resize(count);
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C>::VectorStream(const VectorStream<N, C> &a) : VectorStream()
+	{
+		*this = a;
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C>::VectorStream(VectorStream<N, C> &&a) : _block(a._block), _size(a._size), _capacity(a._capacity)
+	{
+		setPointers();
+		a._block = nullptr;
+		a._size = 0;
+		a._capacity = 0;
+		a.setPointers();
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C>::~VectorStream()
+	{
+		__1::alignedFree(_block);
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C> &VectorStream<N, C>::operator=(const VectorStream<N, C> &a)
+	{
+		if (this != &a)
+		{
+			resize(a._size);
+			if (a._size != 0)
+			{
+				for (size_t k = 0; k < N; k++)
+					memcpy(data[k], a.data[k], a._size * sizeof(float));
+			}
+		}
+		return *this;
+	}
+
+	template <size_t N, typename C>
+	VectorStream<N, C> &VectorStream<N, C>::operator=(VectorStream<N, C> &&a)
+	{
+		if (this != &a)
+		{
+			__1::alignedFree(_block);
+			_block = a._block;
+			_size = a._size;
+			_capacity = a._capacity;
+			setPointers();
+
+			a._block = nullptr;
+			a._size = 0;
+			a._capacity = 0;
+			a.setPointers();
+		}
+		return *this;
+	}
+
+	template <size_t N, typename C>
+	void VectorStream<N, C>::reserve(size_t count)
+	{
+		if (count <= _capacity)
+			return;
+
+		// round up so every component array starts on an aligned boundary
+		constexpr size_t kPad = MUTIL_STREAM_ALIGNMENT / sizeof(float);
+		const size_t capacity = (count + kPad - 1) & ~(kPad - 1);
+
+		float *block = (float *)__1::alignedAlloc(N * capacity * sizeof(float), MUTIL_STREAM_ALIGNMENT);
+		// an empty stream has no block to copy from
+		if (_size != 0)
+		{
+			for (size_t k = 0; k < N; k++)
+				memcpy(block + k * capacity, data[k], _size * sizeof(float));
+		}
+
+		__1::alignedFree(_block);
+		_block = block;
+		_capacity = capacity;
+		setPointers();
+	}
+
+	template <size_t N, typename C>
+	void VectorStream<N, C>::resize(size_t count)
+	{
+		reserve(count);
+		_size = count;
+	}
+
+	template <size_t N, typename C>
+	Vector<N> VectorStream<N, C>::get(size_t i) const
+	{
+		Vector<N> result;
+		for (size_t k = 0; k < N; k++)
+			result[k] = data[k][i];
+		return result;
+	}
+
+	template <size_t N, typename C>
+	void VectorStream<N, C>::set(size_t i, const Vector<N> &a)
+	{
+		for (size_t k = 0; k < N; k++)
+			data[k][i] = a[k];
+	}
+
+	template <size_t N, typename C>
+	void VectorStream<N, C>::setPointers()
+	{
+		for (size_t k = 0; k < N; k++)
+			data[k] = _block ? _block + k * _capacity : nullptr;
+	}
+
+	namespace __1
+	{
+		// The stream kernels work on the component arrays of a stream rather than
+		// the stream itself, so that they can also be instantiated by the runtime
+		// dispatch library. Outputs must already be large enough.
+
+		inline void streamGather3(const Vector3 *src, size_t count, float *const *dst)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				decltype(lane) x, y, z;
+				vload3(lane, (const float *)(src + i), x, y, z);
+				vstore(dst[0] + i, x);
+				vstore(dst[1] + i, y);
+				vstore(dst[2] + i, z);
+			});
+		}
+
+		inline void streamGather4(const Vector4 *src, size_t count, float *const *dst)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				decltype(lane) x, y, z, w;
+				vload4(lane, (const float *)(src + i), x, y, z, w);
+				vstore(dst[0] + i, x);
+				vstore(dst[1] + i, y);
+				vstore(dst[2] + i, z);
+				vstore(dst[3] + i, w);
+			});
+		}
+
+		inline void streamScatter3(const float *const *src, size_t count, Vector3 *dst)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				vstore3((float *)(dst + i), vload(lane, src[0] + i), vload(lane, src[1] + i), vload(lane, src[2] + i));
+			});
+		}
+
+		inline void streamScatter4(const float *const *src, size_t count, Vector4 *dst)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				vstore4((float *)(dst + i), vload(lane, src[0] + i), vload(lane, src[1] + i), vload(lane, src[2] + i), vload(lane, src[3] + i));
+			});
+		}
+
+		template <size_t N>
+		inline void streamDot(const float *const *a, const float *const *b, float *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				auto r = vmul(vload(lane, a[0] + i), vload(lane, b[0] + i));
+				for (size_t k = 1; k < N; k++)
+					r = vfmadd(vload(lane, a[k] + i), vload(lane, b[k] + i), r);
+				vstoreu(out + i, r);
+			});
+		}
+
+		inline void streamCross(const float *const *a, const float *const *b, float *const *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				auto ax = vload(lane, a[0] + i), ay = vload(lane, a[1] + i), az = vload(lane, a[2] + i);
+				auto bx = vload(lane, b[0] + i), by = vload(lane, b[1] + i), bz = vload(lane, b[2] + i);
+
+				vstore(out[0] + i, vfnmadd(by, az, vmul(ay, bz)));
+				vstore(out[1] + i, vfnmadd(bz, ax, vmul(az, bx)));
+				vstore(out[2] + i, vfnmadd(bx, ay, vmul(ax, by)));
+			});
+		}
+
+		template <size_t N>
+		inline void streamLength(const float *const *a, float *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				auto c = vload(lane, a[0] + i);
+				auto r = vmul(c, c);
+				for (size_t k = 1; k < N; k++)
+				{
+					c = vload(lane, a[k] + i);
+					r = vfmadd(c, c, r);
+				}
+				vstoreu(out + i, vsqrt(r));
+			});
+		}
+
+		template <size_t N>
+		inline void streamNormalize(const float *const *a, float *const *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				decltype(lane) c[N];
+				c[0] = vload(lane, a[0] + i);
+				auto r = vmul(c[0], c[0]);
+				for (size_t k = 1; k < N; k++)
+				{
+					c[k] = vload(lane, a[k] + i);
+					r = vfmadd(c[k], c[k], r);
+				}
+
+				r = vrsqrt(r);
+				for (size_t k = 0; k < N; k++)
+					vstore(out[k] + i, vmul(c[k], r));
+			});
+		}
+
+		template <size_t N>
+		inline void streamLerp(const float *const *a, const float *const *b, float t, float *const *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				const auto vt = vset1(lane, t);
+				for (size_t k = 0; k < N; k++)
+				{
+					auto va = vload(lane, a[k] + i);
+					vstore(out[k] + i, vfmadd(vt, vsub(vload(lane, b[k] + i), va), va));
+				}
+			});
+		}
+
+		template <size_t N>
+		inline void streamClamp(const float *const *a, float min, float max, float *const *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				const auto lo = vset1(lane, min);
+				const auto hi = vset1(lane, max);
+				for (size_t k = 0; k < N; k++)
+					vstore(out[k] + i, vmin(vmax(vload(lane, a[k] + i), lo), hi));
+			});
+		}
+
+		template <size_t N>
+		inline void streamReflect(const float *const *a, const float *const *normal, float *const *out, size_t count)
+		{
+			streamFor(count, [&](auto lane, size_t i) {
+				decltype(lane) va[N], vn[N];
+				va[0] = vload(lane, a[0] + i);
+				vn[0] = vload(lane, normal[0] + i);
+				auto d = vmul(va[0], vn[0]);
+				for (size_t k = 1; k < N; k++)
+				{
+					va[k] = vload(lane, a[k] + i);
+					vn[k] = vload(lane, normal[k] + i);
+					d = vfmadd(va[k], vn[k], d);
+				}
+
+				d = vadd(d, d);
+				for (size_t k = 0; k < N; k++)
+					vstore(out[k] + i, vsub(vmul(vn[k], d), va[k]));
+			});
+		}
+	}
+
+	/*!
+	Converts an array of vectors into a stream.
+
+	@param src The vectors to convert.
+	@param count The number of vectors in src.
+	@param dst The stream to write to. It is resized to count.
+	*/
+	inline void gather(const Vector3 *src, size_t count, Vector3Stream &dst)
+	{
+		dst.resize(count);
+		__1::streamGather3(src, count, dst.data);
+	}
+
+	/*!
+	Converts an array of vectors into a stream.
+
+	@param src The vectors to convert.
+	@param count The number of vectors in src.
+	@param dst The stream to write to. It is resized to count.
+	*/
+	inline void gather(const Vector4 *src, size_t count, Vector4Stream &dst)
+	{
+		dst.resize(count);
+		__1::streamGather4(src, count, dst.data);
+	}
+
+	/*!
+	Converts a stream back into an array of vectors.
+
+	@param src The stream to convert.
+	@param dst The array to write to. Must hold at least src.size() vectors.
+	*/
+	inline void scatter(const Vector3Stream &src, Vector3 *dst)
+	{
+		__1::streamScatter3(src.data, src.size(), dst);
+	}
+
+	/*!
+	Converts a stream back into an array of vectors.
+
+	@param src The stream to convert.
+	@param dst The array to write to. Must hold at least src.size() vectors.
+	*/
+	inline void scatter(const Vector4Stream &src, Vector4 *dst)
+	{
+		__1::streamScatter4(src.data, src.size(), dst);
+	}
+
+	/*!
+	Computes the dot product of each pair of vectors.
+
+	@param a The first stream.
+	@param b The second stream, with at least a.size() elements.
+	@param out Receives a.size() dot products.
+	*/
+	template <size_t N>
+	inline void dot(const VectorStream<N> &a, const VectorStream<N> &b, float *out)
+	{
+		__1::streamDot<N>(a.data, b.data, out, a.size());
+	}
+
+	/*!
+	Computes the cross product of each pair of vectors.
+
+	@param a The first stream.
+	@param b The second stream, with at least a.size() elements.
+	@param out Receives the cross products. It is resized to a.size() and may
+	alias a or b.
+	*/
+	inline void cross(const Vector3Stream &a, const Vector3Stream &b, Vector3Stream &out)
+	{
+		out.resize(a.size());
+		__1::streamCross(a.data, b.data, out.data, a.size());
+	}
+
+	/*!
+	Computes the length of each vector.
+
+	@param a The stream.
+	@param out Receives a.size() lengths.
+	*/
+	template <size_t N>
+	inline void length(const VectorStream<N> &a, float *out)
+	{
+		__1::streamLength<N>(a.data, out, a.size());
+	}
+
+	/*!
+	Normalizes each vector.
+
+	@param a The stream.
+	@param out Receives the normalized vectors. It is resized to a.size() and
+	may alias a.
+	*/
+	template <size_t N>
+	inline void normalize(const VectorStream<N> &a, VectorStream<N> &out)
+	{
+		out.resize(a.size());
+		__1::streamNormalize<N>(a.data, out.data, a.size());
+	}
+
+	/*!
+	Linearly interpolates between each pair of vectors.
+
+	@param a The vectors at t = 0.
+	@param b The vectors at t = 1, with at least a.size() elements.
+	@param t The interpolation factor.
+	@param out Receives the interpolated vectors. It is resized to a.size() and
+	may alias a or b.
+	*/
+	template <size_t N>
+	inline void lerp(const VectorStream<N> &a, const VectorStream<N> &b, float t, VectorStream<N> &out)
+	{
+		out.resize(a.size());
+		__1::streamLerp<N>(a.data, b.data, t, out.data, a.size());
+	}
+
+	/*!
+	Clamps every component of each vector.
+
+	@param a The stream.
+	@param min The lower bound.
+	@param max The upper bound.
+	@param out Receives the clamped vectors. It is resized to a.size() and may
+	alias a.
+	*/
+	template <size_t N>
+	inline void clamp(const VectorStream<N> &a, float min, float max, VectorStream<N> &out)
+	{
+		out.resize(a.size());
+		__1::streamClamp<N>(a.data, min, max, out.data, a.size());
+	}
+
+	/*!
+	Reflects each vector about the matching normal, the same as
+	reflect(const Vector3 &, const Vector3 &).
+
+	@param a The vectors to reflect.
+	@param normal The normals, with at least a.size() elements.
+	@param out Receives the reflected vectors. It is resized to a.size() and may
+	alias a or normal.
+	*/
+	template <size_t N>
+	inline void reflect(const VectorStream<N> &a, const VectorStream<N> &normal, VectorStream<N> &out)
+	{
+		out.resize(a.size());
+		__1::streamReflect<N>(a.data, normal.data, out.data, a.size());
+	}
+}
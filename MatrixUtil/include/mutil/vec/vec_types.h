@@ -31,6 +31,13 @@ namespace mutil
 				vec[i] = a.vec[i];
 		}
 
+		constexpr BasicVector<T, N> &operator=(const BasicVector<T, N> &a)
+		{
+			for (size_t i = 0; i < N; i++)
+				vec[i] = a.vec[i];
+			return *this;
+		}
+
 		constexpr const T &operator[](size_t i) const { return vec[i]; }
 		constexpr T &operator[](size_t i) { return vec[i]; }
 	};
@@ -49,6 +56,8 @@ namespace mutil
 	using IntVector3 = IntVector<3>;
 	using IntVector4 = IntVector<4>;
 
+	class Vector3A;
+
 	template <typename T, size_t N>
 	constexpr BasicVector<T, N> operator+(const BasicVector<T, N> &a, const BasicVector<T, N> &b);
 
@@ -25,6 +25,7 @@ namespace mutil
 		constexpr BasicVector(float x, const Vector2 &yz);
 		explicit constexpr BasicVector(const Vector2 &xy);
 		explicit constexpr BasicVector(const Vector4 &a);
+		explicit constexpr BasicVector(const Vector3A &a);
 
 		constexpr Vector3 &operator+=(const Vector3 &a);
 		constexpr Vector3 &operator-=(const Vector3 &a);
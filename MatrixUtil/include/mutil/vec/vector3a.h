@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vec_types.h"
+
+namespace mutil
+{
+	/*!
+	A Vector3 padded to 16 bytes and aligned to 16, so that it always fills one
+	register and is loaded and stored whole with aligned instructions. A packed
+	Vector3 has to be assembled from partial loads instead, as a full register
+	load would read past its end.
+
+	The padding lane is zero after construction. The operators work on all four
+	lanes, so it is unspecified afterwards, but never affects x, y and z.
+
+	Use it for vectors which are worked on in registers, and convert arrays of
+	them with alignVectors and packVectors where the packed layout is needed.
+	Before C++17, new does not honor the alignment of the type, so heap arrays
+	need an aligned allocation.
+	*/
+	class alignas(16) Vector3A
+	{
+	public:
+		union
+		{
+			struct { float x, y, z, padding; };
+			float vec[4];
+		};
+
+		constexpr Vector3A();
+		explicit constexpr Vector3A(float a);
+		constexpr Vector3A(float x, float y, float z);
+		explicit constexpr Vector3A(const Vector3 &a);
+
+		inline Vector3A &operator+=(const Vector3A &a);
+		inline Vector3A &operator-=(const Vector3A &a);
+		inline Vector3A &operator*=(const Vector3A &a);
+		inline Vector3A &operator*=(float a);
+		inline Vector3A &operator/=(const Vector3A &a);
+		inline Vector3A &operator/=(float a);
+
+		constexpr const float &operator[](size_t i) const { return vec[i]; }
+		constexpr float &operator[](size_t i) { return vec[i]; }
+
+		MUTIL_FORCEINLINE float MUTIL_VECTORCALL length() const;
+		MUTIL_FORCEINLINE float MUTIL_VECTORCALL lengthSq() const;
+		MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL normalized() const;
+	};
+
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator+(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator-(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(const Vector3A &a, float b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator*(float a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator/(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator/(const Vector3A &a, float b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL operator-(const Vector3A &a);
+	constexpr bool operator==(const Vector3A &a, const Vector3A &b);
+	constexpr bool operator!=(const Vector3A &a, const Vector3A &b);
+
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL dot(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL cross(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL length(const Vector3A &a);
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL lengthSq(const Vector3A &a);
+	MUTIL_FORCEINLINE float MUTIL_VECTORCALL distance(const Vector3A &a, const Vector3A &b);
+	MUTIL_FORCEINLINE Vector3A MUTIL_VECTORCALL normalize(const Vector3A &a);
+
+	inline void alignVectors(const Vector3 *in, Vector3A *out, size_t count);
+	inline void packVectors(const Vector3A *in, Vector3 *out, size_t count);
+}
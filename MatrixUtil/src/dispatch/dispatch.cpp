@@ -0,0 +1,179 @@
+#include <mutil/dispatch/dispatch.h>
+
+#include <atomic>
+
+#if MUTIL_X86_64 || MUTIL_IA32
+#if _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace mutil
+{
+	namespace __1
+	{
+#if MUTIL_X86_64 || MUTIL_IA32
+		static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+		{
+#if _MSC_VER
+			int r[4];
+			__cpuidex(r, (int)leaf, (int)subleaf);
+			for (int i = 0; i < 4; i++)
+				regs[i] = (unsigned)r[i];
+#else
+			if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]))
+				regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+		}
+
+		// Returns which register states the operating system saves on a context
+		// switch. AVX registers may only be used when the OS preserves them.
+		static uint64_t xgetbv()
+		{
+#if _MSC_VER
+			return _xgetbv(0);
+#else
+			unsigned lo, hi;
+			__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+			return ((uint64_t)hi << 32) | lo;
+#endif
+		}
+
+		static uint32_t detectFeatures()
+		{
+			unsigned regs[4];
+			cpuid(0, 0, regs);
+			const unsigned maxLeaf = regs[0];
+
+			uint32_t features = 0;
+
+			cpuid(1, 0, regs);
+			const unsigned ecx1 = regs[2];
+			if (ecx1 & (1u << 19))
+				features |= CPUFeature_SSE41;
+
+			// OSXSAVE and AVX
+			if ((ecx1 & (1u << 27)) && (ecx1 & (1u << 28)))
+			{
+				const uint64_t xcr0 = xgetbv();
+				if ((xcr0 & 0x6) == 0x6)
+				{
+					features |= CPUFeature_AVX;
+					if (ecx1 & (1u << 12))
+						features |= CPUFeature_FMA;
+
+					if (maxLeaf >= 7)
+					{
+						cpuid(7, 0, regs);
+						if (regs[1] & (1u << 5))
+							features |= CPUFeature_AVX2;
+
+						// opmask and upper ZMM state
+						if ((regs[1] & (1u << 16)) && (xcr0 & 0xe0) == 0xe0)
+							features |= CPUFeature_AVX512F;
+					}
+				}
+			}
+
+			return features;
+		}
+#else
+		static uint32_t detectFeatures()
+		{
+#if MUTIL_ARM64 || MUTIL_USE_NEON
+			return CPUFeature_NEON;
+#else
+			return 0;
+#endif
+		}
+#endif
+
+		static const DispatchTable *tableFor(DispatchLevel level)
+		{
+			switch (level)
+			{
+			case DispatchLevel_Baseline:
+				return &kDispatchBaseline;
+#if MUTIL_DISPATCH_X86
+			case DispatchLevel_SSE41:
+				return &kDispatchSSE41;
+			case DispatchLevel_AVX2:
+				return &kDispatchAVX2;
+			case DispatchLevel_AVX512:
+				return &kDispatchAVX512;
+#endif
+			default:
+				return nullptr;
+			}
+		}
+
+		static DispatchLevel bestLevel()
+		{
+			DispatchLevel level = DispatchLevel_AVX512;
+			while (level != DispatchLevel_Baseline && !isDispatchLevelSupported(level))
+				level = (DispatchLevel)(level - 1);
+			return level;
+		}
+
+		static std::atomic<int> gLevel(-1);
+
+		const DispatchTable &dispatchTable()
+		{
+			int level = gLevel.load(std::memory_order_relaxed);
+			if (level < 0)
+			{
+				// keep the level if another thread set it in the meantime
+				int expected = -1;
+				level = bestLevel();
+				if (!gLevel.compare_exchange_strong(expected, level, std::memory_order_relaxed))
+					level = expected;
+			}
+
+			return *tableFor((DispatchLevel)level);
+		}
+	}
+
+	uint32_t cpuFeatures()
+	{
+		static const uint32_t features = __1::detectFeatures();
+		return features;
+	}
+
+	bool isDispatchLevelSupported(DispatchLevel level)
+	{
+		if (!__1::tableFor(level))
+			return false;
+
+		const uint32_t features = cpuFeatures();
+		switch (level)
+		{
+		case DispatchLevel_Baseline:
+			return true;
+		case DispatchLevel_SSE41:
+			return (features & CPUFeature_SSE41) != 0;
+		case DispatchLevel_AVX2:
+			return (features & (CPUFeature_AVX2 | CPUFeature_FMA)) == (CPUFeature_AVX2 | CPUFeature_FMA);
+		case DispatchLevel_AVX512:
+			return (features & (CPUFeature_AVX512F | CPUFeature_AVX2 | CPUFeature_FMA)) == (CPUFeature_AVX512F | CPUFeature_AVX2 | CPUFeature_FMA);
+		default:
+			return false;
+		}
+	}
+
+	DispatchLevel dispatchLevel()
+	{
+		__1::dispatchTable();
+		return (DispatchLevel)__1::gLevel.load(std::memory_order_relaxed);
+	}
+
+	bool setDispatchLevel(DispatchLevel level)
+	{
+		if (!isDispatchLevelSupported(level))
+			return false;
+
+		__1::gLevel.store(level, std::memory_order_relaxed);
+		return true;
+	}
+}
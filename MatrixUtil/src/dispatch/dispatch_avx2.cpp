@@ -0,0 +1,5 @@
+// Compiled with AVX2 and FMA enabled.
+
+#define MUTIL_DISPATCH_NAMESPACE mutil_avx2
+#define MUTIL_DISPATCH_TABLE kDispatchAVX2
+#include "dispatch_kernels.inl"
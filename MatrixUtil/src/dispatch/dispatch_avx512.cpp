@@ -0,0 +1,5 @@
+// Compiled with AVX-512F, AVX2 and FMA enabled.
+
+#define MUTIL_DISPATCH_NAMESPACE mutil_avx512
+#define MUTIL_DISPATCH_TABLE kDispatchAVX512
+#include "dispatch_kernels.inl"
@@ -0,0 +1,5 @@
+// Compiled with the flags of the project. Used when the CPU supports none of the other levels.
+
+#define MUTIL_DISPATCH_NAMESPACE mutil_baseline
+#define MUTIL_DISPATCH_TABLE kDispatchBaseline
+#include "dispatch_kernels.inl"
@@ -0,0 +1,107 @@
+// Instantiates every batch kernel for the instruction set this translation unit
+// is compiled for and exports them as a DispatchTable.
+//
+// Before including this file, define:
+//   MUTIL_DISPATCH_NAMESPACE - a namespace unique to the translation unit
+//   MUTIL_DISPATCH_TABLE - the name of the table to define
+//
+// The library is included with mutil renamed to MUTIL_DISPATCH_NAMESPACE. The
+// inline functions in the headers are compiled differently in each translation
+// unit, and if they shared a name the linker would be free to keep any one of
+// them, possibly one using instructions the CPU does not support.
+
+#include <mutil/dispatch/dispatch_table.h>
+
+#define mutil MUTIL_DISPATCH_NAMESPACE
+#include <mutil/mutil.h>
+#undef mutil
+
+namespace MUTIL_DISPATCH_NAMESPACE
+{
+	namespace
+	{
+		void transformPointsKernel(const float *m, const float *in, float *out, size_t count, bool perspective)
+		{
+			transformPoints(*(const Matrix4 *)m, (const Vector3 *)in, (Vector3 *)out, count, perspective);
+		}
+
+		void transformVectorsKernel(const float *m, const float *in, float *out, size_t count)
+		{
+			transformVectors(*(const Matrix4 *)m, (const Vector3 *)in, (Vector3 *)out, count);
+		}
+
+		void transformPoints4Kernel(const float *m, const float *in, float *out, size_t count, bool perspective)
+		{
+			transformPoints4(*(const Matrix4 *)m, (const Vector4 *)in, (Vector4 *)out, count, perspective);
+		}
+
+		void multiplyManyKernel(const float *a, const float *b, float *out, size_t count)
+		{
+			multiplyMany((const Matrix4 *)a, (const Matrix4 *)b, (Matrix4 *)out, count);
+		}
+
+		void sinKernel(const float *x, float *out, size_t count) { sin(x, out, count); }
+		void cosKernel(const float *x, float *out, size_t count) { cos(x, out, count); }
+		void tanKernel(const float *x, float *out, size_t count) { tan(x, out, count); }
+		void expKernel(const float *x, float *out, size_t count) { exp(x, out, count); }
+		void exp2Kernel(const float *x, float *out, size_t count) { exp2(x, out, count); }
+		void logKernel(const float *x, float *out, size_t count) { log(x, out, count); }
+		void log2Kernel(const float *x, float *out, size_t count) { log2(x, out, count); }
+		void atanKernel(const float *x, float *out, size_t count) { atan(x, out, count); }
+		void atan2Kernel(const float *y, const float *x, float *out, size_t count) { atan2(y, x, out, count); }
+		void powKernel(const float *a, const float *b, float *out, size_t count) { pow(a, b, out, count); }
+		void sincosKernel(const float *x, float *s, float *c, size_t count) { sincos(x, s, c, count); }
+
+		void gather3Kernel(const float *src, size_t count, float *const *dst) { __1::streamGather3((const Vector3 *)src, count, dst); }
+		void gather4Kernel(const float *src, size_t count, float *const *dst) { __1::streamGather4((const Vector4 *)src, count, dst); }
+		void scatter3Kernel(const float *const *src, size_t count, float *dst) { __1::streamScatter3(src, count, (Vector3 *)dst); }
+		void scatter4Kernel(const float *const *src, size_t count, float *dst) { __1::streamScatter4(src, count, (Vector4 *)dst); }
+
+		void fillNoise2DKernel(float *out, size_t width, size_t height, const float *origin, const float *step, int octaves, float persistence, int type)
+		{
+			fillNoise2D(out, width, height, *(const Vector2 *)origin, *(const Vector2 *)step, octaves, persistence, (NoiseType)type);
+		}
+	}
+}
+
+namespace mutil
+{
+	namespace __1
+	{
+		extern const DispatchTable MUTIL_DISPATCH_TABLE;
+
+		const DispatchTable MUTIL_DISPATCH_TABLE = {
+			&MUTIL_DISPATCH_NAMESPACE::transformPointsKernel,
+			&MUTIL_DISPATCH_NAMESPACE::transformVectorsKernel,
+			&MUTIL_DISPATCH_NAMESPACE::transformPoints4Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::multiplyManyKernel,
+
+			&MUTIL_DISPATCH_NAMESPACE::sinKernel,
+			&MUTIL_DISPATCH_NAMESPACE::cosKernel,
+			&MUTIL_DISPATCH_NAMESPACE::tanKernel,
+			&MUTIL_DISPATCH_NAMESPACE::expKernel,
+			&MUTIL_DISPATCH_NAMESPACE::exp2Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::logKernel,
+			&MUTIL_DISPATCH_NAMESPACE::log2Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::atanKernel,
+			&MUTIL_DISPATCH_NAMESPACE::atan2Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::powKernel,
+			&MUTIL_DISPATCH_NAMESPACE::sincosKernel,
+
+			&MUTIL_DISPATCH_NAMESPACE::gather3Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::gather4Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::scatter3Kernel,
+			&MUTIL_DISPATCH_NAMESPACE::scatter4Kernel,
+
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamDot<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamDot<4> },
+			&MUTIL_DISPATCH_NAMESPACE::__1::streamCross,
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamLength<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamLength<4> },
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamNormalize<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamNormalize<4> },
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamLerp<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamLerp<4> },
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamClamp<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamClamp<4> },
+			{ &MUTIL_DISPATCH_NAMESPACE::__1::streamReflect<3>, &MUTIL_DISPATCH_NAMESPACE::__1::streamReflect<4> },
+
+			&MUTIL_DISPATCH_NAMESPACE::fillNoise2DKernel,
+		};
+	}
+}
@@ -0,0 +1,5 @@
+// Compiled with SSE4.1 enabled.
+
+#define MUTIL_DISPATCH_NAMESPACE mutil_sse41
+#define MUTIL_DISPATCH_TABLE kDispatchSSE41
+#include "dispatch_kernels.inl"
@@ -0,0 +1,203 @@
+// Sweeps the approximated functions of f_math.h at every precision tier against
+// a double precision reference, and reports the maximum error and throughput
+// of each. Unlike MatrixUtilBench, inputs cover the whole domain of each
+// function rather than a small batch.
+
+#include <mutil/mutil.h>
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace mutil;
+
+typedef float (MUTIL_VECTORCALL *FloatFn)(float);
+typedef void (*EvalFn)(const float *x, float *out, size_t count);
+
+template <FloatFn F>
+static void eval(const float *x, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		out[i] = F(x[i]);
+}
+
+static const char *const kTiers[] = { "default", "fast", "balanced", "precise" };
+
+struct Function
+{
+	const char *name;
+
+	// the domain which is swept for errors
+	float lo, hi;
+
+	// throughput is measured on uniformly distributed inputs in this range, as
+	// the sweep is dominated by tiny and denormal values
+	float timeLo, timeHi;
+
+	double (*reference)(double);
+	EvalFn tiers[4];
+};
+
+static double refInverseSqrt(double x) { return 1.0 / std::sqrt(x); }
+static double refSin(double x) { return std::sin(x); }
+static double refCos(double x) { return std::cos(x); }
+static double refTan(double x) { return std::tan(x); }
+static double refAsin(double x) { return std::asin(x); }
+static double refAcos(double x) { return std::acos(x); }
+static double refAtan(double x) { return std::atan(x); }
+static double refLog2(double x) { return std::log2(x); }
+static double refLog(double x) { return std::log(x); }
+static double refLog10(double x) { return std::log10(x); }
+
+#define TIERS(fn) { &eval<&fn>, &eval<&fn<precision::Fast>>, &eval<&fn<precision::Balanced>>, &eval<&fn<precision::Precise>> }
+
+static const Function kFunctions[] = {
+	{ "inverseSqrt", FLT_MIN, FLT_MAX, 0.001f, 1000.0f, &refInverseSqrt, TIERS(mutil::inverseSqrt) },
+	{ "sin", -8192.0f, 8192.0f, -100.0f, 100.0f, &refSin, TIERS(mutil::sin) },
+	{ "cos", -8192.0f, 8192.0f, -100.0f, 100.0f, &refCos, TIERS(mutil::cos) },
+	{ "tan", -8192.0f, 8192.0f, -100.0f, 100.0f, &refTan, TIERS(mutil::tan) },
+	{ "asin", -1.0f, 1.0f, -1.0f, 1.0f, &refAsin, TIERS(mutil::asin) },
+	{ "acos", -1.0f, 1.0f, -1.0f, 1.0f, &refAcos, TIERS(mutil::acos) },
+	{ "atan", -FLT_MAX, FLT_MAX, -100.0f, 100.0f, &refAtan, TIERS(mutil::atan) },
+	{ "log2", FLT_MIN, FLT_MAX, 0.001f, 1000.0f, &refLog2, TIERS(mutil::log2) },
+	{ "log", FLT_MIN, FLT_MAX, 0.001f, 1000.0f, &refLog, TIERS(mutil::log) },
+	{ "log10", FLT_MIN, FLT_MAX, 0.001f, 1000.0f, &refLog10, TIERS(mutil::log10) },
+};
+
+// Maps floats to integers with the same ordering, so that consecutive integers
+// are consecutive floats.
+static int64_t toOrdered(float f)
+{
+	int32_t i;
+	memcpy(&i, &f, sizeof(i));
+	return i < 0 ? -(int64_t)(i & 0x7fffffff) : (int64_t)i;
+}
+
+static float fromOrdered(int64_t o)
+{
+	const int32_t i = o < 0 ? (int32_t)((-o) | 0x80000000u) : (int32_t)o;
+	float f;
+	memcpy(&f, &i, sizeof(f));
+	return f;
+}
+
+static double ulpOf(double x)
+{
+	int e;
+	frexp(x, &e);
+	return ldexp(1.0, e - 24 < -149 ? -149 : e - 24);
+}
+
+struct Error
+{
+	double ulp, abs, rel;
+	double ns;
+};
+
+static void sweep(const Function &f, int64_t stride, Error errors[4])
+{
+	static constexpr size_t kChunk = 1 << 16;
+	std::vector<float> x(kChunk), r(kChunk);
+	std::vector<double> expected(kChunk);
+
+	for (int t = 0; t < 4; t++)
+		errors[t] = Error{ 0.0, 0.0, 0.0, 0.0 };
+
+	const int64_t lo = toOrdered(f.lo), hi = toOrdered(f.hi);
+	for (int64_t o = lo; o <= hi;)
+	{
+		size_t n = 0;
+		for (; n < kChunk && o <= hi; n++, o += stride)
+		{
+			x[n] = fromOrdered(o);
+			expected[n] = f.reference((double)x[n]);
+		}
+
+		for (int t = 0; t < 4; t++)
+		{
+			f.tiers[t](x.data(), r.data(), n);
+			for (size_t i = 0; i < n; i++)
+			{
+				const double e = fabs((double)r[i] - expected[i]);
+				if (e != e)
+				{
+					// a NaN result for a finite reference counts as unbounded error
+					errors[t].ulp = errors[t].abs = errors[t].rel = INFINITY;
+					continue;
+				}
+
+				const double ulp = e / ulpOf(expected[i]);
+				const double rel = expected[i] != 0.0 ? e / fabs(expected[i]) : e;
+				if (ulp > errors[t].ulp) errors[t].ulp = ulp;
+				if (e > errors[t].abs) errors[t].abs = e;
+				if (rel > errors[t].rel) errors[t].rel = rel;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < kChunk; i++)
+		x[i] = f.timeLo + (f.timeHi - f.timeLo) * (float)i / (float)kChunk;
+
+	for (int t = 0; t < 4; t++)
+	{
+		// best of several runs
+		double best = INFINITY;
+		for (int run = 0; run < 20; run++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			f.tiers[t](x.data(), r.data(), kChunk);
+			const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			if (ns < best)
+				best = ns;
+		}
+		errors[t].ns = best / (double)kChunk;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int64_t stride = 127;
+	std::string only;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strncmp(argv[i], "--stride=", 9))
+			stride = atoll(argv[i] + 9);
+		else if (!strncmp(argv[i], "--function=", 11))
+			only = argv[i] + 11;
+		else
+		{
+			printf("Usage: %s [--stride=<n>] [--function=<name>]\n", argv[0]);
+			printf("Tests every n-th float in the domain of each function (default 127).\n");
+			return 1;
+		}
+	}
+
+	if (stride < 1)
+		stride = 1;
+
+	printf("| Function    | Domain                 | Tier     | Max ulp    | Max abs    | Max rel    | ns/op  |\n");
+	printf("|-------------|------------------------|----------|------------|------------|------------|--------|\n");
+	for (const Function &f : kFunctions)
+	{
+		if (!only.empty() && only != f.name)
+			continue;
+
+		Error errors[4];
+		sweep(f, stride, errors);
+
+		char domain[64];
+		snprintf(domain, sizeof(domain), "[%.3g, %.3g]", f.lo, f.hi);
+		for (int t = 0; t < 4; t++)
+		{
+			printf("| %-11s | %-22s | %-8s | %10.3g | %10.3g | %10.3g | %6.2f |\n", f.name, domain, kTiers[t],
+				errors[t].ulp, errors[t].abs, errors[t].rel, errors[t].ns);
+		}
+	}
+
+	return 0;
+}
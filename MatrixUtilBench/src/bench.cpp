@@ -0,0 +1,292 @@
+#include "bench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#if MUTIL_X86_64 || MUTIL_IA32
+#if _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define BENCH_HAS_TSC 1
+#endif
+
+struct Benchmark
+{
+	const char *name;
+	BenchmarkFn fn;
+};
+
+struct Result
+{
+	const char *name;
+	size_t iterations;
+	double nsPerIteration;
+	double nsPerOp;
+	double itemsPerSecond;
+	double cyclesPerOp;
+};
+
+static std::vector<Benchmark> &benchmarks()
+{
+	static std::vector<Benchmark> list;
+	return list;
+}
+
+int registerBenchmark(const char *name, BenchmarkFn fn)
+{
+	benchmarks().push_back({ name, fn });
+	return 0;
+}
+
+static uint64_t now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t readCycles()
+{
+#if BENCH_HAS_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+void State::start()
+{
+	_startCycles = readCycles();
+	_start = now();
+}
+
+void State::stop()
+{
+	_ticks = now() - _start;
+	_cycles = readCycles() - _startCycles;
+}
+
+static uint32_t gRandom = 0x12345678;
+
+float randomFloat(float lo, float hi)
+{
+	// xorshift32
+	gRandom ^= gRandom << 13;
+	gRandom ^= gRandom >> 17;
+	gRandom ^= gRandom << 5;
+	return lo + (hi - lo) * (float)(gRandom >> 8) * (1.0f / 16777216.0f);
+}
+
+Vector3 randomVector3(float lo, float hi)
+{
+	return Vector3(randomFloat(lo, hi), randomFloat(lo, hi), randomFloat(lo, hi));
+}
+
+Vector4 randomVector4(float lo, float hi)
+{
+	return Vector4(randomFloat(lo, hi), randomFloat(lo, hi), randomFloat(lo, hi), randomFloat(lo, hi));
+}
+
+Matrix4 randomMatrix4()
+{
+	// well conditioned, so inverse benchmarks do not hit degenerate inputs
+	Matrix4 m;
+	for (int i = 0; i < 16; i++)
+		m.mat[i] = randomFloat(-1.0f, 1.0f) + (i % 5 == 0 ? 4.0f : 0.0f);
+	return m;
+}
+
+Quaternion randomQuaternion()
+{
+	Vector4 v = randomVector4(-1.0f, 1.0f);
+	v = v / sqrtf(dot(v, v));
+	return Quaternion(v.x, v.y, v.z, v.w);
+}
+
+// The instruction set the library was compiled for in this executable.
+static const char *variant()
+{
+#if MUTIL_NO_INTRINSICS
+	return "no_intrinsics";
+#elif MUTIL_USE_AVX512
+	return "avx512";
+#elif MUTIL_USE_AVX2
+	return "avx2";
+#elif MUTIL_USE_AVX
+	return "avx";
+#elif MUTIL_USE_SSE
+	return "sse4.1";
+#elif MUTIL_USE_NEON
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+static Result run(const Benchmark &b, double minTime)
+{
+	const uint64_t minTicks = (uint64_t)(minTime * 1e9);
+
+	size_t iterations = 1;
+	for (;;)
+	{
+		State state(iterations);
+		b.fn(state);
+
+		// grow the iteration count until the run takes long enough to be measured
+		const uint64_t ticks = state.ticks() ? state.ticks() : 1;
+		if (ticks >= minTicks || iterations >= 1000000000)
+		{
+			Result r;
+			r.name = b.name;
+			r.iterations = iterations;
+			r.nsPerIteration = (double)ticks / (double)iterations;
+			r.nsPerOp = (double)ticks / (double)state.items();
+			r.itemsPerSecond = (double)state.items() * 1e9 / (double)ticks;
+			r.cyclesPerOp = (double)state.cycles() / (double)state.items();
+			return r;
+		}
+
+		double multiplier = (double)minTicks * 1.4 / (double)ticks;
+		if (multiplier > 10.0)
+			multiplier = 10.0;
+		const size_t next = (size_t)((double)iterations * multiplier);
+		iterations = next > iterations ? next : iterations + 1;
+	}
+}
+
+static void printConsole(FILE *out, const std::vector<Result> &results)
+{
+	fprintf(out, "MatrixUtilBench (%s)\n", variant());
+	fprintf(out, "%-40s %14s %12s %12s %12s\n", "Benchmark", "Iterations", "ns/iter", "ns/op", "ops/cycle");
+	for (const Result &r : results)
+	{
+		fprintf(out, "%-40s %14zu %12.2f %12.3f ", r.name, r.iterations, r.nsPerIteration, r.nsPerOp);
+		if (r.cyclesPerOp > 0.0)
+			fprintf(out, "%12.3f\n", 1.0 / r.cyclesPerOp);
+		else
+			fprintf(out, "%12s\n", "-");
+	}
+}
+
+static void printJson(FILE *out, const std::vector<Result> &results)
+{
+	char date[64];
+	const time_t t = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+
+	fprintf(out, "{\n");
+	fprintf(out, "  \"context\": {\n");
+	fprintf(out, "    \"date\": \"%s\",\n", date);
+	fprintf(out, "    \"variant\": \"%s\",\n", variant());
+	fprintf(out, "    \"simd_width\": %d,\n", (int)MUTIL_SIMD_WIDTH);
+#if BENCH_HAS_TSC
+	fprintf(out, "    \"cycle_counter\": \"tsc\"\n");
+#else
+	fprintf(out, "    \"cycle_counter\": null\n");
+#endif
+	fprintf(out, "  },\n");
+	fprintf(out, "  \"benchmarks\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result &r = results[i];
+		fprintf(out, "    {\n");
+		fprintf(out, "      \"name\": \"%s\",\n", r.name);
+		fprintf(out, "      \"run_type\": \"iteration\",\n");
+		fprintf(out, "      \"iterations\": %zu,\n", r.iterations);
+		fprintf(out, "      \"real_time\": %.6g,\n", r.nsPerIteration);
+		fprintf(out, "      \"time_unit\": \"ns\",\n");
+		fprintf(out, "      \"items_per_second\": %.6g,\n", r.itemsPerSecond);
+		fprintf(out, "      \"ns_per_op\": %.6g,\n", r.nsPerOp);
+		if (r.cyclesPerOp > 0.0)
+			fprintf(out, "      \"ops_per_cycle\": %.6g\n", 1.0 / r.cyclesPerOp);
+		else
+			fprintf(out, "      \"ops_per_cycle\": null\n");
+		fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n");
+	fprintf(out, "}\n");
+}
+
+static bool startsWith(const char *s, const char *prefix, const char **rest)
+{
+	const size_t len = strlen(prefix);
+	if (strncmp(s, prefix, len))
+		return false;
+
+	*rest = s + len;
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	std::string filter, format = "console", outPath, outFormat = "json";
+	double minTime = 0.1;
+	bool list = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *v;
+		if (startsWith(argv[i], "--benchmark_filter=", &v))
+			filter = v;
+		else if (startsWith(argv[i], "--benchmark_format=", &v))
+			format = v;
+		else if (startsWith(argv[i], "--benchmark_out=", &v))
+			outPath = v;
+		else if (startsWith(argv[i], "--benchmark_out_format=", &v))
+			outFormat = v;
+		else if (startsWith(argv[i], "--benchmark_min_time=", &v))
+			minTime = atof(v);
+		else if (!strcmp(argv[i], "--benchmark_list_tests"))
+			list = true;
+		else
+		{
+			printf("Usage: %s [--benchmark_filter=<substring>] [--benchmark_format=console|json]\n", argv[0]);
+			printf("       [--benchmark_out=<file>] [--benchmark_out_format=console|json]\n");
+			printf("       [--benchmark_min_time=<seconds>] [--benchmark_list_tests]\n");
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+	for (const Benchmark &b : benchmarks())
+	{
+		if (!filter.empty() && !strstr(b.name, filter.c_str()))
+			continue;
+
+		if (list)
+			printf("%s\n", b.name);
+		else
+			results.push_back(run(b, minTime));
+	}
+
+	if (list)
+		return 0;
+
+	if (format == "json")
+		printJson(stdout, results);
+	else
+		printConsole(stdout, results);
+
+	if (!outPath.empty())
+	{
+		FILE *out = fopen(outPath.c_str(), "w");
+		if (!out)
+		{
+			fprintf(stderr, "Failed to open %s\n", outPath.c_str());
+			return 1;
+		}
+
+		if (outFormat == "json")
+			printJson(out, results);
+		else
+			printConsole(out, results);
+		fclose(out);
+	}
+
+	return 0;
+}
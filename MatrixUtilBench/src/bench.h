@@ -0,0 +1,131 @@
+#pragma once
+
+#include <mutil/mutil.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#if _MSC_VER
+#include <intrin.h>
+#define BENCH_UNUSED
+#else
+#define BENCH_UNUSED __attribute__((unused))
+#endif
+
+using namespace mutil;
+
+// Number of inputs each benchmark works through per iteration. Large enough to
+// hide loop overhead and keep loads independent, small enough to stay in L1.
+static constexpr size_t kBatch = 1024;
+
+class State
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator(State *state, size_t remaining) : _state(state), _remaining(remaining) {}
+
+		bool operator!=(const Iterator &)
+		{
+			if (_remaining)
+				return true;
+
+			_state->stop();
+			return false;
+		}
+
+		Iterator &operator++()
+		{
+			_remaining--;
+			return *this;
+		}
+
+		// The loop variable of `for (auto _ : state)`, which is never read.
+		struct BENCH_UNUSED Value {};
+
+		Value operator*() const { return Value(); }
+	private:
+		State *_state;
+		size_t _remaining;
+	};
+
+	explicit State(size_t iterations) : _iterations(iterations), _items(iterations), _start(0), _ticks(0), _startCycles(0), _cycles(0) {}
+
+	Iterator begin()
+	{
+		start();
+		return Iterator(this, _iterations);
+	}
+
+	Iterator end() { return Iterator(this, 0); }
+
+	size_t iterations() const { return _iterations; }
+
+	/*!
+	Sets the number of operations performed by the benchmark, if it is not the
+	number of iterations.
+
+	@param items The total number of operations.
+	*/
+	void setItemsProcessed(size_t items) { _items = items; }
+
+	size_t items() const { return _items; }
+	uint64_t ticks() const { return _ticks; }
+	uint64_t cycles() const { return _cycles; }
+private:
+	size_t _iterations;
+	size_t _items;
+	uint64_t _start, _ticks;
+	uint64_t _startCycles, _cycles;
+
+	void start();
+	void stop();
+};
+
+typedef void (*BenchmarkFn)(State &state);
+
+int registerBenchmark(const char *name, BenchmarkFn fn);
+
+/*!
+Registers a benchmark, which is run by MatrixUtilBench unless it is filtered out.
+*/
+#define BENCHMARK(fn) static const int fn##_registered = registerBenchmark(#fn, &fn)
+
+/*!
+Forces value to be computed, without the compiler being able to reason about
+its use.
+*/
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if _MSC_VER
+	const volatile char *p = (const volatile char *)&value;
+	(void)*p;
+	_ReadWriteBarrier();
+#else
+	__asm__ __volatile__("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/*!
+Forces pending writes to memory to be performed.
+*/
+inline void clobberMemory()
+{
+#if _MSC_VER
+	_ReadWriteBarrier();
+#else
+	__asm__ __volatile__("" : : : "memory");
+#endif
+}
+
+/*!
+Returns a deterministic pseudo random float in [lo, hi).
+*/
+float randomFloat(float lo, float hi);
+
+Vector3 randomVector3(float lo, float hi);
+Vector4 randomVector4(float lo, float hi);
+Matrix4 randomMatrix4();
+Quaternion randomQuaternion();
@@ -0,0 +1,59 @@
+#include "bench.h"
+
+// Measures throughput of a float function over kBatch independent inputs in [lo, hi).
+#define BENCH_UNARY(name, expr, lo, hi) \
+	static void BM_FMath##name(State &state) \
+	{ \
+		float in[kBatch], out[kBatch]; \
+		for (size_t i = 0; i < kBatch; i++) \
+			in[i] = randomFloat(lo, hi); \
+		for (auto _ : state) \
+		{ \
+			for (size_t i = 0; i < kBatch; i++) \
+			{ \
+				const float x = in[i]; \
+				out[i] = (expr); \
+			} \
+			doNotOptimize(out); \
+		} \
+		state.setItemsProcessed(state.iterations() * kBatch); \
+	} \
+	BENCHMARK(BM_FMath##name)
+
+BENCH_UNARY(Radians, radians(x), -360.0f, 360.0f);
+BENCH_UNARY(Degrees, degrees(x), -10.0f, 10.0f);
+BENCH_UNARY(Sgn, sgn(x), -1.0f, 1.0f);
+BENCH_UNARY(Min, min(x, 0.5f), -1.0f, 1.0f);
+BENCH_UNARY(Max, max(x, 0.5f), -1.0f, 1.0f);
+BENCH_UNARY(Sqrt, mutil::sqrt(x), 0.0f, 1000.0f);
+BENCH_UNARY(InverseSqrt, inverseSqrt(x), 0.001f, 1000.0f);
+BENCH_UNARY(FastInverseSqrt, fastInverseSqrt(x), 0.001f, 1000.0f);
+BENCH_UNARY(Abs, mutil::abs(x), -1.0f, 1.0f);
+BENCH_UNARY(Clamp, clamp(x, -0.5f, 0.5f), -1.0f, 1.0f);
+BENCH_UNARY(Ceil, mutil::ceil(x), -100.0f, 100.0f);
+BENCH_UNARY(Floor, mutil::floor(x), -100.0f, 100.0f);
+BENCH_UNARY(Trunc, mutil::trunc(x), -100.0f, 100.0f);
+BENCH_UNARY(Mod, mod(x, 3.0f), -100.0f, 100.0f);
+BENCH_UNARY(Fract, fract(x), -100.0f, 100.0f);
+BENCH_UNARY(Round, mutil::round(x), -100.0f, 100.0f);
+BENCH_UNARY(Lerp, lerp(1.0f, 3.0f, x), 0.0f, 1.0f);
+BENCH_UNARY(SmoothStep, smoothstep(0.0f, 1.0f, x), -0.5f, 1.5f);
+BENCH_UNARY(SmootherStep, smootherstep(0.0f, 1.0f, x), -0.5f, 1.5f);
+BENCH_UNARY(Sin, mutil::sin(x), -100.0f, 100.0f);
+BENCH_UNARY(Cos, mutil::cos(x), -100.0f, 100.0f);
+BENCH_UNARY(Tan, mutil::tan(x), -1.5f, 1.5f);
+BENCH_UNARY(Asin, mutil::asin(x), -1.0f, 1.0f);
+BENCH_UNARY(Acos, mutil::acos(x), -1.0f, 1.0f);
+BENCH_UNARY(Atan, mutil::atan(x), -100.0f, 100.0f);
+BENCH_UNARY(Log2, mutil::log2(x), 0.001f, 1000.0f);
+BENCH_UNARY(Log, mutil::log(x), 0.001f, 1000.0f);
+BENCH_UNARY(Log10, mutil::log10(x), 0.001f, 1000.0f);
+BENCH_UNARY(Logistic, logistic(2.0f, x), -10.0f, 10.0f);
+BENCH_UNARY(SinStep, sinstep(0.0f, 1.0f, x), -0.5f, 1.5f);
+BENCH_UNARY(Step, step(0.0f, x), -1.0f, 1.0f);
+
+// The C library, for comparison.
+BENCH_UNARY(StdSin, sinf(x), -100.0f, 100.0f);
+BENCH_UNARY(StdAtan, atanf(x), -100.0f, 100.0f);
+BENCH_UNARY(StdLog, logf(x), 0.001f, 1000.0f);
+BENCH_UNARY(StdInverseSqrt, 1.0f / sqrtf(x), 0.001f, 1000.0f);
@@ -0,0 +1,460 @@
+#include "bench.h"
+
+#include <mutil/mat/dynamic_matrix_parallel.h>
+
+static Matrix4 gA[kBatch], gB[kBatch], gOut[kBatch];
+
+static void fillMatrices()
+{
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		gA[i] = randomMatrix4();
+		gB[i] = randomMatrix4();
+	}
+}
+
+static void BM_Matrix4Multiply(State &state)
+{
+	fillMatrices();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = gA[i] * gB[i];
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4Multiply);
+
+static void BM_Matrix4MultiplyMany(State &state)
+{
+	fillMatrices();
+	for (auto _ : state)
+	{
+		multiplyMany(gA, gB, gOut, kBatch);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4MultiplyMany);
+
+static void BM_Matrix4AMultiply(State &state)
+{
+	static Matrix4A a[kBatch], b[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		a[i] = Matrix4A(randomMatrix4());
+		b[i] = Matrix4A(randomMatrix4());
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = a[i] * b[i];
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4AMultiply);
+
+static void BM_Matrix4MulVector(State &state)
+{
+	fillMatrices();
+	static Vector4 v[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		v[i] = randomVector4(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = gA[i] * v[i];
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4MulVector);
+
+static void BM_Matrix4Transpose(State &state)
+{
+	fillMatrices();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = transpose(gA[i]);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4Transpose);
+
+static void BM_Matrix4Determinant(State &state)
+{
+	fillMatrices();
+	static float out[kBatch];
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = determinant(gA[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4Determinant);
+
+static void BM_Matrix4Inverse(State &state)
+{
+	fillMatrices();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = inverse(gA[i]);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4Inverse);
+
+static void BM_Matrix4InverseScalar(State &state)
+{
+	fillMatrices();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = inverseScalar(gA[i]);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4InverseScalar);
+
+static void BM_Matrix4InverseAffine(State &state)
+{
+	for (size_t i = 0; i < kBatch; i++)
+		gA[i] = translate(scale(Matrix4(1.0f), randomVector3(0.5f, 2.0f)), randomVector3(-10.0f, 10.0f));
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = inverseAffine(gA[i]);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4InverseAffine);
+
+static void BM_Matrix4TransformPoints(State &state)
+{
+	const Matrix4 m = randomMatrix4();
+	static Vector3 in[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = randomVector3(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		transformPoints(m, in, out, kBatch);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4TransformPoints);
+
+static void BM_Matrix4TransformPoints4(State &state)
+{
+	const Matrix4 m = randomMatrix4();
+	static Vector4 in[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = randomVector4(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		transformPoints4(m, in, out, kBatch);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix4TransformPoints4);
+
+static AffineMatrix gAffineA[kBatch], gAffineB[kBatch], gAffineOut[kBatch];
+
+static void BM_AffineMultiply(State &state)
+{
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		gAffineA[i] = AffineMatrix(randomMatrix4());
+		gAffineB[i] = AffineMatrix(randomMatrix4());
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gAffineOut[i] = gAffineA[i] * gAffineB[i];
+		doNotOptimize(gAffineOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_AffineMultiply);
+
+static void BM_AffineInverse(State &state)
+{
+	for (size_t i = 0; i < kBatch; i++)
+		gAffineA[i] = AffineMatrix(translate(scale(Matrix4(1.0f), randomVector3(0.5f, 2.0f)), randomVector3(-10.0f, 10.0f)));
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gAffineOut[i] = inverse(gAffineA[i]);
+		doNotOptimize(gAffineOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_AffineInverse);
+
+static void BM_AffineTransformPoints(State &state)
+{
+	const AffineMatrix m(randomMatrix4());
+	static Vector3 in[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = randomVector3(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		transformPoints(m, in, out, kBatch);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_AffineTransformPoints);
+
+// A hierarchy of kBatch nodes in which each node's parent is a few nodes back,
+// like a scene graph or skeleton stored in depth-first order
+struct Hierarchy
+{
+	int32_t parents[kBatch];
+	Transform local[kBatch];
+	Transform world[kBatch];
+	Matrix4 localMatrices[kBatch];
+	Matrix4 worldMatrices[kBatch];
+
+	Hierarchy()
+	{
+		for (size_t i = 0; i < kBatch; i++)
+		{
+			parents[i] = i % 64 == 0 ? -1 : (int32_t)(i - 1 - i % 3);
+			local[i] = Transform(randomVector3(-1.0f, 1.0f), randomQuaternion(), randomFloat(0.5f, 2.0f));
+			localMatrices[i] = local[i].tomatrix();
+		}
+	}
+};
+
+static void BM_HierarchyMatrix(State &state)
+{
+	static Hierarchy h;
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+		{
+			const int32_t parent = h.parents[i];
+			h.worldMatrices[i] = parent < 0 ? h.localMatrices[i] : h.worldMatrices[parent] * h.localMatrices[i];
+		}
+		doNotOptimize(h.worldMatrices);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_HierarchyMatrix);
+
+static void BM_HierarchyTransform(State &state)
+{
+	static Hierarchy h;
+	for (auto _ : state)
+	{
+		updateHierarchy(h.local, h.parents, h.world, kBatch);
+		doNotOptimize(h.world);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_HierarchyTransform);
+
+static void BM_HierarchyTransformMatrices(State &state)
+{
+	static Hierarchy h;
+	for (auto _ : state)
+	{
+		updateHierarchy(h.local, h.parents, h.world, kBatch, h.worldMatrices);
+		doNotOptimize(h.worldMatrices);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_HierarchyTransformMatrices);
+
+// The generic BasicMatrix product, called explicitly on the sizes which have
+// hand-written versions to compare against them, and on larger sizes.
+template <size_t N>
+static void benchGenericMultiply(State &state)
+{
+	static Matrix<N, N> a[kBatch], b[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		for (size_t k = 0; k < N * N; k++)
+		{
+			a[i].mat[k] = randomFloat(-1.0f, 1.0f);
+			b[i].mat[k] = randomFloat(-1.0f, 1.0f);
+		}
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = operator*<float, N, N, N>(a[i], b[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+
+static void BM_Matrix2Multiply(State &state)
+{
+	static Matrix2 a[kBatch], b[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		a[i] = Matrix2(randomMatrix4());
+		b[i] = Matrix2(randomMatrix4());
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = a[i] * b[i];
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix2Multiply);
+
+static void BM_Matrix3Multiply(State &state)
+{
+	static Matrix3 a[kBatch], b[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		a[i] = Matrix3(randomMatrix4());
+		b[i] = Matrix3(randomMatrix4());
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = a[i] * b[i];
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Matrix3Multiply);
+
+static void BM_Matrix2MultiplyGeneric(State &state) { benchGenericMultiply<2>(state); }
+BENCHMARK(BM_Matrix2MultiplyGeneric);
+
+static void BM_Matrix3MultiplyGeneric(State &state) { benchGenericMultiply<3>(state); }
+BENCHMARK(BM_Matrix3MultiplyGeneric);
+
+static void BM_Matrix4MultiplyGeneric(State &state) { benchGenericMultiply<4>(state); }
+BENCHMARK(BM_Matrix4MultiplyGeneric);
+
+static void BM_Matrix8MultiplyGeneric(State &state) { benchGenericMultiply<8>(state); }
+BENCHMARK(BM_Matrix8MultiplyGeneric);
+
+// above the unrolled sizes
+static void BM_Matrix9MultiplyGeneric(State &state) { benchGenericMultiply<9>(state); }
+BENCHMARK(BM_Matrix9MultiplyGeneric);
+
+static void BM_Matrix16MultiplyGeneric(State &state) { benchGenericMultiply<16>(state); }
+BENCHMARK(BM_Matrix16MultiplyGeneric);
+
+static void BM_Matrix24MultiplyGeneric(State &state) { benchGenericMultiply<24>(state); }
+BENCHMARK(BM_Matrix24MultiplyGeneric);
+
+// 256 x 256 products, counting each multiply and add as one item so that the
+// cycles column gives flops per cycle
+static constexpr size_t kGemmSize = 256;
+
+static void fillDynamicMatrices(DynamicMatrix<float> &a, DynamicMatrix<float> &b)
+{
+	a.resize(kGemmSize, kGemmSize);
+	b.resize(kGemmSize, kGemmSize);
+	for (size_t j = 0; j < kGemmSize; j++)
+	{
+		for (size_t i = 0; i < kGemmSize; i++)
+		{
+			a(i, j) = randomFloat(-1.0f, 1.0f);
+			b(i, j) = randomFloat(-1.0f, 1.0f);
+		}
+	}
+}
+
+static void BM_DynamicMatrixNaive(State &state)
+{
+	DynamicMatrix<float> a, b, c(kGemmSize, kGemmSize);
+	fillDynamicMatrices(a, b);
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kGemmSize; i++)
+		{
+			for (size_t j = 0; j < kGemmSize; j++)
+			{
+				float sum = 0.0f;
+				for (size_t p = 0; p < kGemmSize; p++)
+					sum += a(i, p) * b(p, j);
+				c(i, j) = sum;
+			}
+		}
+		doNotOptimize(c.data());
+	}
+
+	state.setItemsProcessed(state.iterations() * 2 * kGemmSize * kGemmSize * kGemmSize);
+}
+BENCHMARK(BM_DynamicMatrixNaive);
+
+static void BM_DynamicMatrixGemm(State &state)
+{
+	DynamicMatrix<float> a, b, c(kGemmSize, kGemmSize);
+	fillDynamicMatrices(a, b);
+	for (auto _ : state)
+	{
+		gemm(a, b, c);
+		doNotOptimize(c.data());
+	}
+
+	state.setItemsProcessed(state.iterations() * 2 * kGemmSize * kGemmSize * kGemmSize);
+}
+BENCHMARK(BM_DynamicMatrixGemm);
+
+static void BM_DynamicMatrixGemmParallel(State &state)
+{
+	DynamicMatrix<float> a, b, c(kGemmSize, kGemmSize);
+	fillDynamicMatrices(a, b);
+	for (auto _ : state)
+	{
+		gemmParallel(a, b, c);
+		doNotOptimize(c.data());
+	}
+
+	state.setItemsProcessed(state.iterations() * 2 * kGemmSize * kGemmSize * kGemmSize);
+}
+BENCHMARK(BM_DynamicMatrixGemmParallel);
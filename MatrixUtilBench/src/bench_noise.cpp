@@ -0,0 +1,281 @@
+#include "bench.h"
+
+#include <mutil/math/noise_parallel.h>
+#include <vector>
+
+template <typename F>
+static void benchNoise(State &state, F f)
+{
+	Vector2 in[kBatch];
+	float out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = Vector2(randomFloat(-256.0f, 256.0f), randomFloat(-256.0f, 256.0f));
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = f(in[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+
+static void BM_NoisePerlin(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return pnoise(p); });
+}
+BENCHMARK(BM_NoisePerlin);
+
+static void BM_NoisePerlinOctaves(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return pnoise(p, 0.5f, 4); });
+}
+BENCHMARK(BM_NoisePerlinOctaves);
+
+// The same, with the gradients looked up in a table instead of computed
+static const GradientTable kGradients;
+
+static void BM_NoisePerlinTable(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return pnoise(p, kGradients); });
+}
+BENCHMARK(BM_NoisePerlinTable);
+
+static void BM_NoisePerlinTableOctaves(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return pnoise(p, 0.5f, 4, kGradients); });
+}
+BENCHMARK(BM_NoisePerlinTableOctaves);
+
+static void BM_NoiseSimplex(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return snoise(p); });
+}
+BENCHMARK(BM_NoiseSimplex);
+
+static void BM_NoiseSimplexOctaves(State &state)
+{
+	benchNoise(state, [](const Vector2 &p) { return snoise(p, 0.5f, 4); });
+}
+BENCHMARK(BM_NoiseSimplexOctaves);
+
+template <NoiseType Type>
+static void benchNoiseGrid(State &state, int octaves)
+{
+	// one 32 x 32 tile, the same number of samples as the per-call benchmarks
+	static float out[kBatch];
+
+	for (auto _ : state)
+	{
+		fillNoise2D(out, 32, kBatch / 32, Vector2(-13.5f, 7.25f), Vector2(0.0625f, 0.0625f), octaves, 0.5f, Type);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+
+static void BM_NoisePerlinGrid(State &state)
+{
+	benchNoiseGrid<NoiseType_Perlin>(state, 1);
+}
+BENCHMARK(BM_NoisePerlinGrid);
+
+static void BM_NoisePerlinGridOctaves(State &state)
+{
+	benchNoiseGrid<NoiseType_Perlin>(state, 4);
+}
+BENCHMARK(BM_NoisePerlinGridOctaves);
+
+static void BM_NoiseSimplexGrid(State &state)
+{
+	benchNoiseGrid<NoiseType_Simplex>(state, 1);
+}
+BENCHMARK(BM_NoiseSimplexGrid);
+
+static void BM_NoiseSimplexGridOctaves(State &state)
+{
+	benchNoiseGrid<NoiseType_Simplex>(state, 4);
+}
+BENCHMARK(BM_NoiseSimplexGridOctaves);
+
+// a 1024 x 1024 heightmap, filled on one thread and on the global pool
+static void benchNoiseHeightmap(State &state, bool parallel)
+{
+	const size_t size = 1024;
+	static std::vector<float> out(size * size);
+
+	for (auto _ : state)
+	{
+		if (parallel)
+			fillNoise2DParallel(out.data(), size, size, Vector2(-13.5f, 7.25f), Vector2(0.01f, 0.01f), 6, 0.5f);
+		else
+			fillNoise2D(out.data(), size, size, Vector2(-13.5f, 7.25f), Vector2(0.01f, 0.01f), 6, 0.5f);
+		doNotOptimize(out.data());
+	}
+
+	state.setItemsProcessed(state.iterations() * size * size);
+}
+
+static void BM_NoiseHeightmap(State &state)
+{
+	benchNoiseHeightmap(state, false);
+}
+BENCHMARK(BM_NoiseHeightmap);
+
+static void BM_NoiseHeightmapParallel(State &state)
+{
+	benchNoiseHeightmap(state, true);
+}
+BENCHMARK(BM_NoiseHeightmapParallel);
+
+// 3D and 4D noise, one call per position against the batch versions
+template <typename T, typename F>
+static void benchNoisePoints(State &state, T (*random)(float, float), F f)
+{
+	static T in[kBatch];
+	static float out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = random(-64.0f, 64.0f);
+
+	for (auto _ : state)
+	{
+		f(in, out);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+
+static void BM_NoisePerlin3D(State &state)
+{
+	benchNoisePoints(state, &randomVector3, [](const Vector3 *in, float *out) {
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = pnoise(in[i]);
+	});
+}
+BENCHMARK(BM_NoisePerlin3D);
+
+static void BM_NoisePerlin3DBatch(State &state)
+{
+	benchNoisePoints(state, &randomVector3, [](const Vector3 *in, float *out) { pnoise(in, out, kBatch); });
+}
+BENCHMARK(BM_NoisePerlin3DBatch);
+
+static void BM_NoiseSimplex3D(State &state)
+{
+	benchNoisePoints(state, &randomVector3, [](const Vector3 *in, float *out) {
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = snoise(in[i]);
+	});
+}
+BENCHMARK(BM_NoiseSimplex3D);
+
+static void BM_NoiseSimplex3DBatch(State &state)
+{
+	benchNoisePoints(state, &randomVector3, [](const Vector3 *in, float *out) { snoise(in, out, kBatch); });
+}
+BENCHMARK(BM_NoiseSimplex3DBatch);
+
+static void BM_NoiseSimplex4D(State &state)
+{
+	benchNoisePoints(state, &randomVector4, [](const Vector4 *in, float *out) {
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = snoise(in[i]);
+	});
+}
+BENCHMARK(BM_NoiseSimplex4D);
+
+static void BM_NoiseSimplex4DBatch(State &state)
+{
+	benchNoisePoints(state, &randomVector4, [](const Vector4 *in, float *out) { snoise(in, out, kBatch); });
+}
+BENCHMARK(BM_NoiseSimplex4DBatch);
+
+// Cellular noise over a 32 x 32 grid and a 16 x 8 x 8 volume, one call per
+// sample against the grid versions
+static void BM_NoiseWorley2D(State &state)
+{
+	static float out[kBatch];
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = wnoise(Vector2(-13.5f + (float)(i % 32) * 0.0625f, 7.25f + (float)(i / 32) * 0.0625f));
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_NoiseWorley2D);
+
+static void BM_NoiseWorley2DGrid(State &state)
+{
+	static float out[kBatch];
+
+	for (auto _ : state)
+	{
+		fillWorley2D(out, 32, kBatch / 32, Vector2(-13.5f, 7.25f), Vector2(0.0625f, 0.0625f));
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_NoiseWorley2DGrid);
+
+static void BM_NoiseWorley3D(State &state)
+{
+	static float out[kBatch];
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = wnoise(Vector3(-13.5f + (float)(i % 16) * 0.0625f, 7.25f + (float)(i / 16 % 8) * 0.0625f, 2.0f + (float)(i / 128) * 0.0625f));
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_NoiseWorley3D);
+
+static void BM_NoiseWorley3DGrid(State &state)
+{
+	static float out[kBatch];
+
+	for (auto _ : state)
+	{
+		fillWorley3D(out, 16, 8, kBatch / 128, Vector3(-13.5f, 7.25f, 2.0f), Vector3(0.0625f, 0.0625f, 0.0625f));
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_NoiseWorley3DGrid);
+
+// Four octaves of ridged simplex noise on a warped domain
+static FractalNoise ridgedNoise()
+{
+	FractalNoise f;
+	f.fractal = FractalType_Ridged;
+	f.warpAmplitude = 0.5f;
+	return f;
+}
+
+static void BM_NoiseFractal(State &state)
+{
+	const FractalNoise f = ridgedNoise();
+	benchNoisePoints(state, &randomVector3, [&f](const Vector3 *in, float *out) {
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = f.sample(in[i]);
+	});
+}
+BENCHMARK(BM_NoiseFractal);
+
+static void BM_NoiseFractalBatch(State &state)
+{
+	const FractalNoise f = ridgedNoise();
+	benchNoisePoints(state, &randomVector3, [&f](const Vector3 *in, float *out) {
+		f.sample(in, out, kBatch);
+	});
+}
+BENCHMARK(BM_NoiseFractalBatch);
@@ -0,0 +1,286 @@
+#include "bench.h"
+
+static Quaternion gA[kBatch], gB[kBatch], gOut[kBatch];
+
+static void fillQuaternions()
+{
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		gA[i] = randomQuaternion();
+		gB[i] = randomQuaternion();
+	}
+}
+
+static void BM_QuaternionMultiply(State &state)
+{
+	fillQuaternions();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = gA[i] * gB[i];
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionMultiply);
+
+static void BM_QuaternionNormalize(State &state)
+{
+	fillQuaternions();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = normalize(gA[i] * 2.0f);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionNormalize);
+
+static void BM_QuaternionSlerp(State &state)
+{
+	fillQuaternions();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = slerp(gA[i], gB[i], 0.3f);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionSlerp);
+
+static void BM_QuaternionNlerp(State &state)
+{
+	fillQuaternions();
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			gOut[i] = nlerp(gA[i], gB[i], 0.3f);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionNlerp);
+
+static float gT[kBatch];
+
+static void fillFactors()
+{
+	for (size_t i = 0; i < kBatch; i++)
+		gT[i] = (float)i / (float)kBatch;
+}
+
+static void BM_QuaternionSlerpMany(State &state)
+{
+	fillQuaternions();
+	fillFactors();
+	for (auto _ : state)
+	{
+		slerpMany(gA, gB, gT, gOut, kBatch);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionSlerpMany);
+
+static void BM_QuaternionNlerpMany(State &state)
+{
+	fillQuaternions();
+	fillFactors();
+	for (auto _ : state)
+	{
+		nlerpMany(gA, gB, gT, gOut, kBatch);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionNlerpMany);
+
+static void BM_QuaternionSlerpFastMany(State &state)
+{
+	fillQuaternions();
+	fillFactors();
+	for (auto _ : state)
+	{
+		slerpFastMany(gA, gB, gT, gOut, kBatch);
+		doNotOptimize(gOut);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionSlerpFastMany);
+
+static void BM_QuaternionStreamSlerp(State &state)
+{
+	fillQuaternions();
+	fillFactors();
+	QuaternionStream a, b, out;
+	gather(gA, kBatch, a);
+	gather(gB, kBatch, b);
+
+	for (auto _ : state)
+	{
+		slerp(a, b, gT, out);
+		doNotOptimize(out.w);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionStreamSlerp);
+
+static void BM_QuaternionStreamSlerpFast(State &state)
+{
+	fillQuaternions();
+	fillFactors();
+	QuaternionStream a, b, out;
+	gather(gA, kBatch, a);
+	gather(gB, kBatch, b);
+
+	for (auto _ : state)
+	{
+		slerpFast(a, b, gT, out);
+		doNotOptimize(out.w);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionStreamSlerpFast);
+
+static void BM_QuaternionRotateVector(State &state)
+{
+	fillQuaternions();
+	static Vector3 v[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		v[i] = randomVector3(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = rotatevector(gA[i], v[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionRotateVector);
+
+static void BM_QuaternionRotateVectors(State &state)
+{
+	fillQuaternions();
+	static Vector3 v[kBatch], out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		v[i] = randomVector3(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		rotateVectors(gA[0], v, out, kBatch);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionRotateVectors);
+
+static void BM_QuaternionToRotation(State &state)
+{
+	fillQuaternions();
+	static Matrix4 out[kBatch];
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = torotation(gA[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_QuaternionToRotation);
+
+static constexpr size_t kJoints = 32;
+
+struct SkinScene
+{
+	Quaternion rotations[kJoints];
+	Vector3 translations[kJoints];
+	DualQuaternion joints[kJoints];
+	SkinInfluence influences[kBatch];
+	Vector3 positions[kBatch];
+	Vector3 out[kBatch];
+
+	SkinScene()
+	{
+		for (size_t j = 0; j < kJoints; j++)
+		{
+			rotations[j] = randomQuaternion();
+			translations[j] = randomVector3(-1.0f, 1.0f);
+			joints[j] = DualQuaternion(rotations[j], translations[j]);
+		}
+
+		for (size_t i = 0; i < kBatch; i++)
+		{
+			positions[i] = randomVector3(-10.0f, 10.0f);
+
+			float total = 0.0f;
+			for (size_t k = 0; k < 4; k++)
+			{
+				influences[i].joints[k] = (uint32_t)((i / 8 + k * 3) % kJoints);
+				influences[i].weights[k] = randomFloat(0.1f, 1.0f);
+				total += influences[i].weights[k];
+			}
+			for (size_t k = 0; k < 4; k++)
+				influences[i].weights[k] /= total;
+		}
+	}
+};
+
+// Linear blend skinning with matrices, converting each joint with torotation
+// for every blend
+static void BM_SkinMatrix(State &state)
+{
+	static SkinScene scene;
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+		{
+			const SkinInfluence &v = scene.influences[i];
+
+			Matrix4 m(0.0f);
+			for (size_t k = 0; k < 4; k++)
+			{
+				Matrix4 joint = torotation(scene.rotations[v.joints[k]]);
+				const Vector3 &t = scene.translations[v.joints[k]];
+				joint._14 = t.x;
+				joint._24 = t.y;
+				joint._34 = t.z;
+				m = m + joint * v.weights[k];
+			}
+
+			const Vector4 p = m * Vector4(scene.positions[i], 1.0f);
+			scene.out[i] = Vector3(p.x, p.y, p.z);
+		}
+		doNotOptimize(scene.out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_SkinMatrix);
+
+static void BM_SkinDualQuaternion(State &state)
+{
+	static SkinScene scene;
+	for (auto _ : state)
+	{
+		skinDualQuaternion(scene.joints, scene.influences, scene.positions, scene.out, kBatch);
+		doNotOptimize(scene.out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_SkinDualQuaternion);
@@ -0,0 +1,47 @@
+#include "bench.h"
+
+// Measures the array overloads from simd/simd_math.h. BENCH_ARRAY2 also
+// fills a second input b.
+#define BENCH_ARRAY(name, call, lo, hi) \
+	static void BM_SimdMath##name(State &state) \
+	{ \
+		static float a[kBatch], out[kBatch]; \
+		for (size_t i = 0; i < kBatch; i++) \
+			a[i] = randomFloat(lo, hi); \
+		for (auto _ : state) \
+		{ \
+			call; \
+			doNotOptimize(out); \
+		} \
+		state.setItemsProcessed(state.iterations() * kBatch); \
+	} \
+	BENCHMARK(BM_SimdMath##name)
+
+#define BENCH_ARRAY2(name, call, lo, hi) \
+	static void BM_SimdMath##name(State &state) \
+	{ \
+		static float a[kBatch], b[kBatch], out[kBatch]; \
+		for (size_t i = 0; i < kBatch; i++) \
+		{ \
+			a[i] = randomFloat(lo, hi); \
+			b[i] = randomFloat(lo, hi); \
+		} \
+		for (auto _ : state) \
+		{ \
+			call; \
+			doNotOptimize(out); \
+		} \
+		state.setItemsProcessed(state.iterations() * kBatch); \
+	} \
+	BENCHMARK(BM_SimdMath##name)
+
+BENCH_ARRAY(Sin, sin(a, out, kBatch), -100.0f, 100.0f);
+BENCH_ARRAY(Cos, cos(a, out, kBatch), -100.0f, 100.0f);
+BENCH_ARRAY(Tan, tan(a, out, kBatch), -1.5f, 1.5f);
+BENCH_ARRAY(Exp, exp(a, out, kBatch), -80.0f, 80.0f);
+BENCH_ARRAY(Exp2, exp2(a, out, kBatch), -120.0f, 120.0f);
+BENCH_ARRAY(Log, log(a, out, kBatch), 0.001f, 1000.0f);
+BENCH_ARRAY(Log2, log2(a, out, kBatch), 0.001f, 1000.0f);
+BENCH_ARRAY(Atan, atan(a, out, kBatch), -100.0f, 100.0f);
+BENCH_ARRAY2(Atan2, atan2(a, b, out, kBatch), -100.0f, 100.0f);
+BENCH_ARRAY2(Pow, pow(a, b, out, kBatch), 0.01f, 4.0f);
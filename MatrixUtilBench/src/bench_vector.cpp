@@ -0,0 +1,262 @@
+#include "bench.h"
+
+template <typename V, typename R, typename F>
+static void benchBinary(State &state, V (*sample)(float, float), F f)
+{
+	static V a[kBatch], b[kBatch];
+	static R out[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+	{
+		a[i] = sample(-10.0f, 10.0f);
+		b[i] = sample(-10.0f, 10.0f);
+	}
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < kBatch; i++)
+			out[i] = f(a[i], b[i]);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+
+static void BM_Vector3Add(State &state)
+{
+	benchBinary<Vector3, Vector3>(state, &randomVector3, [](const Vector3 &a, const Vector3 &b) { return a + b; });
+}
+BENCHMARK(BM_Vector3Add);
+
+static void BM_Vector3Dot(State &state)
+{
+	benchBinary<Vector3, float>(state, &randomVector3, [](const Vector3 &a, const Vector3 &b) { return dot(a, b); });
+}
+BENCHMARK(BM_Vector3Dot);
+
+static void BM_Vector3Cross(State &state)
+{
+	benchBinary<Vector3, Vector3>(state, &randomVector3, [](const Vector3 &a, const Vector3 &b) { return cross(a, b); });
+}
+BENCHMARK(BM_Vector3Cross);
+
+static void BM_Vector3Length(State &state)
+{
+	benchBinary<Vector3, float>(state, &randomVector3, [](const Vector3 &a, const Vector3 &) { return length(a); });
+}
+BENCHMARK(BM_Vector3Length);
+
+static void BM_Vector3Normalize(State &state)
+{
+	benchBinary<Vector3, Vector3>(state, &randomVector3, [](const Vector3 &a, const Vector3 &) { return normalize(a); });
+}
+BENCHMARK(BM_Vector3Normalize);
+
+static void BM_Vector3Reflect(State &state)
+{
+	benchBinary<Vector3, Vector3>(state, &randomVector3, [](const Vector3 &a, const Vector3 &b) { return reflect(a, b); });
+}
+BENCHMARK(BM_Vector3Reflect);
+
+static void BM_Vector4Add(State &state)
+{
+	benchBinary<Vector4, Vector4>(state, &randomVector4, [](const Vector4 &a, const Vector4 &b) { return a + b; });
+}
+BENCHMARK(BM_Vector4Add);
+
+static void BM_Vector4Dot(State &state)
+{
+	benchBinary<Vector4, float>(state, &randomVector4, [](const Vector4 &a, const Vector4 &b) { return dot(a, b); });
+}
+BENCHMARK(BM_Vector4Dot);
+
+static void BM_Vector4Length(State &state)
+{
+	benchBinary<Vector4, float>(state, &randomVector4, [](const Vector4 &a, const Vector4 &) { return length(a); });
+}
+BENCHMARK(BM_Vector4Length);
+
+static void BM_Vector4Normalize(State &state)
+{
+	benchBinary<Vector4, Vector4>(state, &randomVector4, [](const Vector4 &a, const Vector4 &) { return normalize(a); });
+}
+BENCHMARK(BM_Vector4Normalize);
+
+static void BM_Vector4Lerp(State &state)
+{
+	benchBinary<Vector4, Vector4>(state, &randomVector4, [](const Vector4 &a, const Vector4 &b) { return lerp(a, b, 0.25f); });
+}
+BENCHMARK(BM_Vector4Lerp);
+
+static Vector3A randomVector3A(float lo, float hi)
+{
+	return Vector3A(randomVector3(lo, hi));
+}
+
+static void BM_Vector3ADot(State &state)
+{
+	benchBinary<Vector3A, float>(state, &randomVector3A, [](const Vector3A &a, const Vector3A &b) { return dot(a, b); });
+}
+BENCHMARK(BM_Vector3ADot);
+
+static void BM_Vector3ACross(State &state)
+{
+	benchBinary<Vector3A, Vector3A>(state, &randomVector3A, [](const Vector3A &a, const Vector3A &b) { return cross(a, b); });
+}
+BENCHMARK(BM_Vector3ACross);
+
+static void BM_Vector3ANormalize(State &state)
+{
+	benchBinary<Vector3A, Vector3A>(state, &randomVector3A, [](const Vector3A &a, const Vector3A &) { return normalize(a); });
+}
+BENCHMARK(BM_Vector3ANormalize);
+
+static void BM_Vector3AlignPack(State &state)
+{
+	static Vector3 packed[kBatch];
+	static Vector3A aligned[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		packed[i] = randomVector3(-10.0f, 10.0f);
+
+	for (auto _ : state)
+	{
+		alignVectors(packed, aligned, kBatch);
+		packVectors(aligned, packed, kBatch);
+		doNotOptimize(packed);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Vector3AlignPack);
+
+// normalize(a * b + a), with every intermediate stored as a Vector4 and then
+// kept in a register
+static void BM_Vector4Chain(State &state)
+{
+	benchBinary<Vector4, Vector4>(state, &randomVector4, [](const Vector4 &a, const Vector4 &b) { return normalize(a * b + a); });
+}
+BENCHMARK(BM_Vector4Chain);
+
+static void BM_SIMDVector4Chain(State &state)
+{
+	benchBinary<Vector4, Vector4>(state, &randomVector4, [](const Vector4 &a, const Vector4 &b)
+	{
+		const SIMDVector4 va(a);
+		return normalize(va * SIMDVector4(b) + va).tovector4();
+	});
+}
+BENCHMARK(BM_SIMDVector4Chain);
+
+static void fillStream(Vector3Stream &s)
+{
+	s.resize(kBatch);
+	for (size_t i = 0; i < kBatch; i++)
+		s.set(i, randomVector3(-10.0f, 10.0f));
+}
+
+static void BM_Vector3StreamDot(State &state)
+{
+	Vector3Stream a, b;
+	fillStream(a);
+	fillStream(b);
+
+	static float out[kBatch];
+	for (auto _ : state)
+	{
+		dot(a, b, out);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Vector3StreamDot);
+
+static void BM_Vector3StreamCross(State &state)
+{
+	Vector3Stream a, b, out;
+	fillStream(a);
+	fillStream(b);
+
+	for (auto _ : state)
+	{
+		cross(a, b, out);
+		clobberMemory();
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Vector3StreamCross);
+
+static void BM_Vector3StreamNormalize(State &state)
+{
+	Vector3Stream a, out;
+	fillStream(a);
+
+	for (auto _ : state)
+	{
+		normalize(a, out);
+		clobberMemory();
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Vector3StreamNormalize);
+
+static void BM_Vector3StreamGatherScatter(State &state)
+{
+	static Vector3 in[kBatch];
+	for (size_t i = 0; i < kBatch; i++)
+		in[i] = randomVector3(-10.0f, 10.0f);
+
+	Vector3Stream s;
+	for (auto _ : state)
+	{
+		gather(in, kBatch, s);
+		scatter(s, in);
+		clobberMemory();
+	}
+
+	state.setItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Vector3StreamGatherScatter);
+
+// a * s + b * t - c on a long generic vector, which evaluates eagerly into a
+// temporary at each step unless it is made lazy
+using LongVector = BasicVector<float, 256>;
+
+static void fillLongVectors(LongVector &a, LongVector &b, LongVector &c)
+{
+	for (size_t i = 0; i < 256; i++)
+	{
+		a[i] = randomFloat(-10.0f, 10.0f);
+		b[i] = randomFloat(-10.0f, 10.0f);
+		c[i] = randomFloat(-10.0f, 10.0f);
+	}
+}
+
+static void BM_LongVectorEager(State &state)
+{
+	static LongVector a, b, c, out;
+	fillLongVectors(a, b, c);
+	for (auto _ : state)
+	{
+		out = a * 2.0f + b * 0.5f - c;
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_LongVectorEager);
+
+static void BM_LongVectorLazy(State &state)
+{
+	static LongVector a, b, c, out;
+	fillLongVectors(a, b, c);
+	for (auto _ : state)
+	{
+		assign(out, lazy(a) * 2.0f + lazy(b) * 0.5f - c);
+		doNotOptimize(out);
+	}
+
+	state.setItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_LongVectorLazy);
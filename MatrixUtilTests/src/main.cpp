@@ -7,9 +7,25 @@ extern Test getVector2Test(const std::string &test);
 extern Test getVector3Test(const std::string &test);
 extern Test getVector4Test(const std::string &test);
 extern Test getQuaternionTest(const std::string &test);
+extern Test getDualQuaternionTest(const std::string &test);
+extern Test getTransformTest(const std::string &test);
 extern Test getFMathTest(const std::string &test);
 extern Test getIMathTest(const std::string &test);
 extern Test getMatrix2Test(const std::string &test);
+extern Test getBasicMatrixTest(const std::string &test);
+extern Test getMatrix4Test(const std::string &test);
+extern Test getAffineMatrixTest(const std::string &test);
+extern Test getDynamicMatrixTest(const std::string &test);
+extern Test getAlignedTest(const std::string &test);
+extern Test getVectorStreamTest(const std::string &test);
+extern Test getExprTest(const std::string &test);
+extern Test getSimdMathTest(const std::string &test);
+extern Test getSIMDVectorTest(const std::string &test);
+extern Test getNoiseTest(const std::string &test);
+extern Test getThreadPoolTest(const std::string &test);
+#if MUTIL_HAS_DISPATCH
+extern Test getDispatchTest(const std::string &test);
+#endif
 
 static Test findTest(const std::string &test)
 {
@@ -27,6 +43,12 @@ static Test findTest(const std::string &test)
 	r = getQuaternionTest(test);
 	if (r) return r;
 
+	r = getDualQuaternionTest(test);
+	if (r) return r;
+
+	r = getTransformTest(test);
+	if (r) return r;
+
 	r = getFMathTest(test);
 	if (r) return r;
 
@@ -36,6 +58,44 @@ static Test findTest(const std::string &test)
 	r = getMatrix2Test(test);
 	if (r) return r;
 
+	r = getMatrix4Test(test);
+	if (r) return r;
+
+	r = getBasicMatrixTest(test);
+	if (r) return r;
+
+	r = getAffineMatrixTest(test);
+	if (r) return r;
+
+	r = getDynamicMatrixTest(test);
+	if (r) return r;
+
+	r = getAlignedTest(test);
+	if (r) return r;
+
+	r = getVectorStreamTest(test);
+	if (r) return r;
+
+	r = getExprTest(test);
+	if (r) return r;
+
+	r = getNoiseTest(test);
+	if (r) return r;
+
+	r = getThreadPoolTest(test);
+	if (r) return r;
+
+	r = getSimdMathTest(test);
+	if (r) return r;
+
+	r = getSIMDVectorTest(test);
+	if (r) return r;
+
+#if MUTIL_HAS_DISPATCH
+	r = getDispatchTest(test);
+	if (r) return r;
+#endif
+
 	return nullptr;
 }
 
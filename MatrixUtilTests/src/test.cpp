@@ -1,5 +1,7 @@
 #include "test.h"
 
+#include <cmath>
+
 static float _epsilon = 0.001f;
 
 void setEpsilon(float epsilon) { _epsilon = epsilon; }
@@ -72,6 +74,14 @@ bool equals(const Matrix4 &a, const Matrix4 &b)
 		equals(a.columns[3], b.columns[3]);
 }
 
+bool equals(const AffineMatrix &a, const AffineMatrix &b)
+{
+	return equals(a.columns[0], b.columns[0]) &&
+		equals(a.columns[1], b.columns[1]) &&
+		equals(a.columns[2], b.columns[2]) &&
+		equals(a.columns[3], b.columns[3]);
+}
+
 bool equals(const IntMatrix2 &a, const IntMatrix2 &b)
 {
 	return equals(a.columns[0], b.columns[0]) &&
@@ -101,6 +111,30 @@ bool equals(const Quaternion &a, const Quaternion &b)
 		equals(a.k, b.k);
 }
 
+double ulps(float actual, double expected)
+{
+	int e;
+	frexp(expected, &e);
+	const double ulp = ldexp(1.0, e - 24 < -149 ? -149 : e - 24);
+	return fabs((double)actual - expected) / ulp;
+}
+
+Vector3 samplePoint(size_t i)
+{
+	return Vector3((float)i * 0.5f - 3.0f, 1.0f - (float)(i % 7), (float)(i % 3) + 0.25f);
+}
+
+Vector4 sampleVector4(size_t i)
+{
+	return Vector4(samplePoint(i), (float)(i % 5) - 2.5f);
+}
+
+float sampleElement(size_t i, int seed)
+{
+	return (float)((int)((i * 7 + (size_t)seed) % 17) - 8) / 8.0f;
+}
+
+std::string tostring(bool x) { return x ? "true" : "false"; }
 std::string tostring(int x) { return std::to_string(x); }
 std::string tostring(unsigned int x) { return std::to_string(x); }
 std::string tostring(float x) { return std::to_string(x); }
@@ -151,6 +185,11 @@ std::string tostring(const Matrix4 &m)
 	return "[" + tostring(m.columns[0]) + ", " + tostring(m.columns[1]) + ", " + tostring(m.columns[2]) + ", " + tostring(m.columns[3]) + "]";
 }
 
+std::string tostring(const AffineMatrix &m)
+{
+	return "[" + tostring(m.columns[0]) + ", " + tostring(m.columns[1]) + ", " + tostring(m.columns[2]) + ", " + tostring(m.columns[3]) + "]";
+}
+
 std::string tostring(const IntMatrix2 &m)
 {
 	return "[" + tostring(m.columns[0]) + ", " + tostring(m.columns[1]) + "]";
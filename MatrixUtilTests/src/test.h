@@ -22,11 +22,42 @@ bool equals(const IntVector4 &a, const IntVector4 &b);
 bool equals(const Matrix2 &a, const Matrix2 &b);
 bool equals(const Matrix3 &a, const Matrix3 &b);
 bool equals(const Matrix4 &a, const Matrix4 &b);
+bool equals(const AffineMatrix &a, const AffineMatrix &b);
 bool equals(const IntMatrix2 &a, const IntMatrix2 &b);
 bool equals(const IntMatrix3 &a, const IntMatrix3 &b);
 bool equals(const IntMatrix4 &a, const IntMatrix4 &b);
 bool equals(const Quaternion &a, const Quaternion &b);
 
+// distance from the double precision reference, in units of the last place of a float
+double ulps(float actual, double expected);
+
+// deterministic inputs for the tests which run a function on many values
+Vector3 samplePoint(size_t i);
+Vector4 sampleVector4(size_t i);
+
+// element i of a deterministic test matrix, a multiple of 1/8 in [-1, 1] so
+// that the products and sums of a few hundred of them are exact
+float sampleElement(size_t i, int seed);
+
+template <size_t N, size_t M>
+Matrix<N, M> sampleMatrix(int seed)
+{
+	Matrix<N, M> m;
+	for (size_t i = 0; i < N * M; i++)
+		m[i] = sampleElement(i, seed);
+	return m;
+}
+
+template <typename T>
+DynamicMatrix<T> sampleMatrix(size_t rows, size_t cols, int seed)
+{
+	DynamicMatrix<T> m(rows, cols);
+	for (size_t j = 0; j < cols; j++)
+		for (size_t i = 0; i < rows; i++)
+			m(i, j) = (T)sampleElement(j * rows + i, seed);
+	return m;
+}
+
 std::string tostring(bool x);
 std::string tostring(int x);
 std::string tostring(unsigned int x);
@@ -40,6 +71,7 @@ std::string tostring(const IntVector4 &v);
 std::string tostring(const Matrix2 &m);
 std::string tostring(const Matrix3 &m);
 std::string tostring(const Matrix4 &m);
+std::string tostring(const AffineMatrix &m);
 std::string tostring(const IntMatrix2 &m);
 std::string tostring(const IntMatrix3 &m);
 std::string tostring(const IntMatrix4 &m);
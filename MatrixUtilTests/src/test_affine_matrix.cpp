@@ -0,0 +1,116 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+// not a multiple of any register width, so every kernel also runs its tail
+static constexpr size_t kCount = 37;
+
+static const AffineMatrix kTransform(
+    1.0f, 0.5f, -2.0f, 3.0f,
+    0.0f, 2.0f, 1.0f, -1.0f,
+    -1.5f, 0.0f, 1.0f, 4.0f);
+
+static void testAffineMatrixBasic()
+{
+    const AffineMatrix identity;
+    assertEquals(Matrix4(), Matrix4(identity));
+    assertEquals(AffineMatrix(1.0f), identity);
+
+    const Matrix4 m(kTransform);
+    assertEquals(Vector4(3.0f, -1.0f, 4.0f, 1.0f), m.columns[3]);
+    assertEquals(0.0f, m._41);
+    assertEquals(kTransform, AffineMatrix(m));
+
+    const Matrix3 upper(kTransform);
+    assertEquals(Matrix3(m), upper);
+    assertEquals(kTransform, AffineMatrix(upper, Vector3(3.0f, -1.0f, 4.0f)));
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector3 p = samplePoint(i);
+        assertEquals(Vector3(m * Vector4(p, 1.0f)), transformpoint(kTransform, p));
+        assertEquals(Vector3(m * Vector4(p, 0.0f)), transformvector(kTransform, p));
+        assertEquals(m * Vector4(p, 0.5f), kTransform * Vector4(p, 0.5f));
+    }
+}
+
+static void testAffineMatrixMulMatrix()
+{
+    const AffineMatrix b(
+        -1.0f, 0.5f, 2.0f, 0.0f,
+        3.0f, 1.0f, -2.0f, 1.0f,
+        0.0f, 4.0f, 1.0f, -3.0f);
+
+    assertEquals(AffineMatrix(Matrix4(kTransform) * Matrix4(b)), kTransform * b);
+    assertEquals(AffineMatrix(Matrix4(b) * Matrix4(kTransform)), b * kTransform);
+    assertEquals(kTransform, kTransform * AffineMatrix());
+    assertEquals(kTransform, AffineMatrix() * kTransform);
+
+    AffineMatrix c = kTransform;
+    c *= b;
+    assertEquals(kTransform * b, c);
+}
+
+static void testAffineMatrixInverse()
+{
+    assertEquals(determinant(Matrix3(kTransform)), determinant(kTransform));
+    assertEquals(determinant(kTransform), kTransform.determinant());
+
+    const AffineMatrix inv = inverse(kTransform);
+    assertEquals(AffineMatrix(inverseAffine(Matrix4(kTransform))), inv);
+    assertEquals(AffineMatrix(), kTransform * inv);
+    assertEquals(AffineMatrix(), inv * kTransform);
+    assertEquals(inv, kTransform.inverse());
+}
+
+static void testAffineMatrixTransformPoints()
+{
+    Vector3 in[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+        in[i] = samplePoint(i);
+
+    transformPoints(kTransform, in, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(transformpoint(kTransform, in[i]), out[i]);
+
+    transformVectors(kTransform, in, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(transformvector(kTransform, in[i]), out[i]);
+
+    // in place
+    transformPoints(kTransform, in, in, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(transformpoint(kTransform, samplePoint(i)), in[i]);
+}
+
+static void testAffineMatrixMultiplyMany()
+{
+    AffineMatrix a[kCount], b[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a[i] = kTransform * (float)(i + 1);
+        b[i] = inverse(kTransform) + AffineMatrix((float)i);
+    }
+
+    multiplyMany(a, b, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(AffineMatrix(Matrix4(a[i]) * Matrix4(b[i])), out[i]);
+
+    // in place
+    multiplyMany(a, b, a, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(out[i], a[i]);
+}
+
+Test getAffineMatrixTest(const std::string &test)
+{
+    if (test == "AffineMatrixBasic") return &testAffineMatrixBasic;
+    if (test == "AffineMatrixMulMatrix") return &testAffineMatrixMulMatrix;
+    if (test == "AffineMatrixInverse") return &testAffineMatrixInverse;
+    if (test == "AffineMatrixTransformPoints") return &testAffineMatrixTransformPoints;
+    if (test == "AffineMatrixMultiplyMany") return &testAffineMatrixMultiplyMany;
+
+    return nullptr;
+}
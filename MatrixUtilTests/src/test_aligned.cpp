@@ -0,0 +1,171 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+#if __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace mutil;
+
+// not a multiple of four, so the conversions also run their tail
+static constexpr size_t kCount = 37;
+
+static void testAlignedVector3Basic()
+{
+    static_assert(sizeof(Vector3A) == 16 && alignof(Vector3A) == 16, "Vector3A must fill one register");
+
+    const Vector3A v(1.0f, 2.0f, 3.0f);
+    assertEquals(0.0f, v.padding);
+    assertEquals(Vector3(1.0f, 2.0f, 3.0f), Vector3(v));
+    assertEquals(Vector3(4.0f), Vector3(Vector3A(4.0f)));
+    assertEquals(Vector3(), Vector3(Vector3A()));
+    assertTrue(Vector3A(Vector3(1.0f, 2.0f, 3.0f)) == v);
+    assertFalse(v != v);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector3 a = samplePoint(i);
+        const Vector3 b = samplePoint(i * 3 + 1);
+        const Vector3A aa(a), ab(b);
+
+        assertEquals(a + b, Vector3(aa + ab));
+        assertEquals(a - b, Vector3(aa - ab));
+        assertEquals(a * b, Vector3(aa * ab));
+        assertEquals(a * 2.5f, Vector3(aa * 2.5f));
+        assertEquals(a * 2.5f, Vector3(2.5f * aa));
+        assertEquals(a / 2.0f, Vector3(aa / 2.0f));
+        assertEquals(a / Vector3(2.0f, -4.0f, 0.5f), Vector3(aa / Vector3A(2.0f, -4.0f, 0.5f)));
+        assertEquals(-a, Vector3(-aa));
+
+        assertEquals(dot(a, b), dot(aa, ab));
+        assertEquals(cross(a, b), Vector3(cross(aa, ab)));
+        assertEquals(length(a), length(aa));
+        assertEquals(lengthSq(a), aa.lengthSq());
+        assertEquals(distance(a, b), distance(aa, ab));
+        assertEquals(normalize(a), Vector3(normalize(aa)));
+
+        Vector3A c = aa;
+        c += ab;
+        c *= 2.0f;
+        c -= ab;
+        assertEquals((a + b) * 2.0f - b, Vector3(c));
+    }
+}
+
+static void testAlignedVector3Convert()
+{
+    Vector3 in[kCount], out[kCount];
+    Vector3A aligned[kCount];
+    for (size_t i = 0; i < kCount; i++)
+        in[i] = samplePoint(i);
+
+    for (size_t count = 0; count <= kCount; count += 9)
+    {
+        alignVectors(in, aligned, count);
+        for (size_t i = 0; i < count; i++)
+            assertEquals(in[i], Vector3(aligned[i]));
+
+        packVectors(aligned, out, count);
+        for (size_t i = 0; i < count; i++)
+            assertEquals(in[i], out[i]);
+    }
+}
+
+static void testAlignedMatrix3()
+{
+    const Matrix3 m(
+        1.0f, 0.5f, -2.0f,
+        0.0f, 2.0f, 1.0f,
+        -1.5f, 0.0f, 1.0f);
+    const Matrix3 n(
+        -1.0f, 0.5f, 2.0f,
+        3.0f, 1.0f, -2.0f,
+        0.0f, 4.0f, 1.0f);
+    const Matrix3A am(m), an(n);
+
+    assertEquals(Matrix3(), Matrix3(Matrix3A()));
+    assertEquals(m, Matrix3(am));
+    assertEquals(m * n, Matrix3(am * an));
+
+    Matrix3A c = am;
+    c *= an;
+    assertTrue(am * an == c);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector3 v = samplePoint(i);
+        assertEquals(m * v, Vector3(am * Vector3A(v)));
+    }
+}
+
+static void testAlignedMatrix4()
+{
+    static_assert(sizeof(Matrix4A) == 64 && alignof(Matrix4A) == 64, "Matrix4A must fill one cache line");
+
+    const Matrix4 m(
+        1.0f, 0.5f, -2.0f, 3.0f,
+        0.0f, 2.0f, 1.0f, -1.0f,
+        -1.5f, 0.0f, 1.0f, 4.0f,
+        0.5f, 0.0f, -1.0f, 1.0f);
+    const Matrix4 n = inverse(m) + Matrix4(2.0f);
+    const Matrix4A am(m), an(n);
+
+    assertEquals(Matrix4(), Matrix4(Matrix4A()));
+    assertEquals(m, Matrix4(am));
+    assertEquals(m * n, Matrix4(am * an));
+    assertEquals(n * m, Matrix4(an * am));
+
+    Matrix4A c = am;
+    c *= an;
+    assertTrue(am * an == c);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector4 v(samplePoint(i), 1.0f);
+        assertEquals(m * v, am * v);
+    }
+}
+
+// The packed types must not be read past their end, which would fault when
+// they end a page.
+static void testAlignedPackedPageEnd()
+{
+#if __unix__
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *p = (char *)mmap(nullptr, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        die();
+    mprotect(p + page, page, PROT_NONE);
+    char *end = p + page;
+#else
+    alignas(16) static char buffer[64];
+    char *end = buffer + sizeof(buffer);
+#endif
+
+    Vector3 *v3 = (Vector3 *)(end - sizeof(Vector3));
+    *v3 = Vector3(1.0f, 2.0f, 2.0f);
+    assertEquals(9.0f, dot(*v3, *v3));
+    assertEquals(3.0f, length(*v3));
+
+    Vector2 *v2 = (Vector2 *)(end - sizeof(Vector2));
+    *v2 = Vector2(3.0f, 4.0f);
+    assertEquals(25.0f, dot(*v2, *v2));
+    assertEquals(5.0f, length(*v2));
+
+#if __unix__
+    munmap(p, page * 2);
+#endif
+}
+
+Test getAlignedTest(const std::string &test)
+{
+    if (test == "AlignedVector3Basic") return &testAlignedVector3Basic;
+    if (test == "AlignedVector3Convert") return &testAlignedVector3Convert;
+    if (test == "AlignedMatrix3") return &testAlignedMatrix3;
+    if (test == "AlignedMatrix4") return &testAlignedMatrix4;
+    if (test == "AlignedPackedPageEnd") return &testAlignedPackedPageEnd;
+
+    return nullptr;
+}
@@ -0,0 +1,89 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+// a * b one element at a time, with element (r, c) at mat[c * rows + r]
+template <size_t N, size_t M, size_t P>
+static void checkProduct(int seed)
+{
+    const Matrix<N, M> a = sampleMatrix<N, M>(seed);
+    const Matrix<P, N> b = sampleMatrix<P, N>(seed + 3);
+    const Matrix<P, M> c = a * b;
+
+    for (size_t r = 0; r < M; r++)
+    {
+        for (size_t col = 0; col < P; col++)
+        {
+            float sum = 0.0f;
+            for (size_t k = 0; k < N; k++)
+                sum += a.mat[k * M + r] * b.mat[col * N + k];
+            assertEquals(sum, c.mat[col * M + r]);
+        }
+    }
+}
+
+static void testBasicMatrixMultiply()
+{
+    // a 2x3 and a 3x2 matrix, whose product is a Matrix2
+    Matrix<3, 2> a;
+    const float av[] = { 1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f };
+    for (size_t i = 0; i < 6; i++)
+        a[i] = av[i];
+
+    Matrix<2, 3> b;
+    const float bv[] = { 7.0f, 9.0f, 11.0f, 8.0f, 10.0f, 12.0f };
+    for (size_t i = 0; i < 6; i++)
+        b[i] = bv[i];
+
+    assertEquals(Matrix2(58.0f, 64.0f, 139.0f, 154.0f), a * b);
+
+    const BasicVector<float, 2> v = a * BasicVector<float, 3>(1.0f);
+    assertEquals(6.0f, v[0]);
+    assertEquals(15.0f, v[1]);
+
+    // unrolled, and the loop above 8
+    checkProduct<5, 7, 3>(1);
+    checkProduct<8, 8, 8>(2);
+    checkProduct<1, 6, 1>(3);
+    checkProduct<9, 12, 10>(4);
+}
+
+// The generic product agrees with the hand-written ones.
+static void testBasicMatrixSpecialized()
+{
+    const Matrix4 m(
+        1.0f, 0.5f, -2.0f, 3.0f,
+        0.0f, 2.0f, 1.0f, -1.0f,
+        -1.5f, 0.0f, 1.0f, 4.0f,
+        0.5f, 0.0f, -1.0f, 1.0f);
+    const Matrix4 n = inverse(m) + Matrix4(2.0f);
+
+    assertEquals(m * n, (operator*<float, 4, 4, 4>(m, n)));
+    assertEquals(Matrix3(m) * Matrix3(n), (operator*<float, 3, 3, 3>(Matrix3(m), Matrix3(n))));
+    assertEquals(Matrix2(m) * Matrix2(n), (operator*<float, 2, 2, 2>(Matrix2(m), Matrix2(n))));
+
+    const Vector4 v(1.0f, -2.0f, 0.5f, 3.0f);
+    assertEquals(m * v, (operator*<float, 4, 4>(m, v)));
+}
+
+// More columns than rows
+static void testBasicMatrixWide()
+{
+    const Matrix<5, 3> m(2.0f);
+    for (size_t c = 0; c < 5; c++)
+        for (size_t r = 0; r < 3; r++)
+            assertEquals(r == c ? 2.0f : 0.0f, m.mat[c * 3 + r]);
+
+    checkProduct<5, 3, 6>(5);
+}
+
+Test getBasicMatrixTest(const std::string &test)
+{
+    if (test == "BasicMatrixMultiply") return &testBasicMatrixMultiply;
+    if (test == "BasicMatrixSpecialized") return &testBasicMatrixSpecialized;
+    if (test == "BasicMatrixWide") return &testBasicMatrixWide;
+
+    return nullptr;
+}
@@ -0,0 +1,244 @@
+#include <mutil/dispatch/dispatch.h>
+#include <string>
+#include <vector>
+#include "test.h"
+
+using namespace mutil;
+
+// not a multiple of any register width, so every kernel also runs its tail
+static constexpr size_t kCount = 37;
+
+static const DispatchLevel kLevels[] = {
+    DispatchLevel_Baseline,
+    DispatchLevel_SSE41,
+    DispatchLevel_AVX2,
+    DispatchLevel_AVX512,
+};
+
+// runs f once for every level supported on this machine
+template <typename F>
+static void forEachLevel(F f)
+{
+    const DispatchLevel old = dispatchLevel();
+    for (DispatchLevel level : kLevels)
+    {
+        if (!setDispatchLevel(level))
+            continue;
+
+        assertTrue(dispatchLevel() == level);
+        f();
+    }
+
+    assertTrue(setDispatchLevel(old));
+}
+
+static void testDispatchLevels()
+{
+    const uint32_t features = cpuFeatures();
+
+    // the widest supported level is picked by default
+    DispatchLevel best = DispatchLevel_Baseline;
+    for (DispatchLevel level : kLevels)
+    {
+        if (isDispatchLevelSupported(level))
+            best = level;
+    }
+    assertTrue(dispatchLevel() == best);
+
+    assertTrue(isDispatchLevelSupported(DispatchLevel_Baseline));
+    if (isDispatchLevelSupported(DispatchLevel_SSE41))
+        assertTrue((features & CPUFeature_SSE41) != 0);
+    if (isDispatchLevelSupported(DispatchLevel_AVX2))
+        assertTrue((features & CPUFeature_AVX2) && (features & CPUFeature_FMA));
+    if (isDispatchLevelSupported(DispatchLevel_AVX512))
+        assertTrue((features & CPUFeature_AVX512F) != 0);
+
+    // unsupported levels leave the current one in place
+    for (DispatchLevel level : kLevels)
+    {
+        if (!isDispatchLevelSupported(level))
+        {
+            assertFalse(setDispatchLevel(level));
+            assertTrue(dispatchLevel() == best);
+        }
+    }
+}
+
+static void testDispatchTransform()
+{
+    const Matrix4 m = translate(Matrix4(1.0f), Vector3(1.0f, -2.0f, 3.0f)) * scale(Matrix4(1.0f), Vector3(2.0f, 0.5f, 1.5f));
+
+    Vector3 in3[kCount], out3[kCount], expected3[kCount];
+    Vector4 in4[kCount], out4[kCount], expected4[kCount];
+    Matrix4 a[kCount], b[kCount], out[kCount], expected[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        in3[i] = samplePoint(i);
+        in4[i] = sampleVector4(i);
+        a[i] = translate(Matrix4(1.0f), samplePoint(i));
+        b[i] = scale(Matrix4(1.0f), samplePoint(kCount - i));
+    }
+
+    forEachLevel([&]() {
+        transformPoints(m, in3, expected3, kCount);
+        dispatch::transformPoints(m, in3, out3, kCount);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected3[i], out3[i]);
+
+        transformVectors(m, in3, expected3, kCount);
+        dispatch::transformVectors(m, in3, out3, kCount);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected3[i], out3[i]);
+
+        transformPoints4(m, in4, expected4, kCount, true);
+        dispatch::transformPoints4(m, in4, out4, kCount, true);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected4[i], out4[i]);
+
+        multiplyMany(a, b, expected, kCount);
+        dispatch::multiplyMany(a, b, out, kCount);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected[i], out[i]);
+    });
+}
+
+static void testDispatchMath()
+{
+    std::vector<float> x(kCount), y(kCount), r(kCount), expected(kCount), c(kCount), expectedC(kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        x[i] = 0.1f + (float)i * 0.125f;
+        y[i] = 1.5f - (float)i * 0.0625f;
+    }
+
+    forEachLevel([&]() {
+#define CHECK_UNARY(name) \
+        name(x.data(), expected.data(), kCount); \
+        dispatch::name(x.data(), r.data(), kCount); \
+        for (size_t i = 0; i < kCount; i++) \
+            assertEquals(expected[i], r[i]);
+
+        CHECK_UNARY(sin);
+        CHECK_UNARY(cos);
+        CHECK_UNARY(tan);
+        CHECK_UNARY(exp);
+        CHECK_UNARY(exp2);
+        CHECK_UNARY(log);
+        CHECK_UNARY(log2);
+        CHECK_UNARY(atan);
+#undef CHECK_UNARY
+
+        atan2(y.data(), x.data(), expected.data(), kCount);
+        dispatch::atan2(y.data(), x.data(), r.data(), kCount);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected[i], r[i]);
+
+        pow(x.data(), y.data(), expected.data(), kCount);
+        dispatch::pow(x.data(), y.data(), r.data(), kCount);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(expected[i], r[i]);
+
+        sincos(x.data(), expected.data(), expectedC.data(), kCount);
+        dispatch::sincos(x.data(), r.data(), c.data(), kCount);
+        for (size_t i = 0; i < kCount; i++)
+        {
+            assertEquals(expected[i], r[i]);
+            assertEquals(expectedC[i], c[i]);
+        }
+    });
+}
+
+static void testDispatchStream()
+{
+    Vector3 in3[kCount], out3[kCount];
+    Vector4 in4[kCount], out4[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        in3[i] = samplePoint(i);
+        in4[i] = sampleVector4(i);
+    }
+
+    forEachLevel([&]() {
+        Vector3Stream a, b(kCount), r;
+        Vector4Stream c, d(kCount), s;
+        dispatch::gather(in3, kCount, a);
+        dispatch::gather(in4, kCount, c);
+        for (size_t i = 0; i < kCount; i++)
+        {
+            b.set(i, samplePoint(kCount - i));
+            d.set(i, sampleVector4(kCount - i));
+        }
+
+        dispatch::scatter(a, out3);
+        dispatch::scatter(c, out4);
+        for (size_t i = 0; i < kCount; i++)
+        {
+            assertEquals(in3[i], out3[i]);
+            assertEquals(in4[i], out4[i]);
+        }
+
+        float f[kCount];
+        dispatch::dot(a, b, f);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(dot(a.get(i), b.get(i)), f[i]);
+
+        dispatch::dot(c, d, f);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(dot(c.get(i), d.get(i)), f[i]);
+
+        dispatch::cross(a, b, r);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(cross(a.get(i), b.get(i)), r.get(i));
+
+        dispatch::length(c, f);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(length(c.get(i)), f[i]);
+
+        dispatch::normalize(a, r);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(a.get(i) / sqrtf(dot(a.get(i), a.get(i))), r.get(i));
+
+        dispatch::lerp(c, d, 0.75f, s);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(lerp(c.get(i), d.get(i), 0.75f), s.get(i));
+
+        dispatch::clamp(c, -1.0f, 2.0f, s);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(clamp(c.get(i), -1.0f, 2.0f), s.get(i));
+
+        Vector3Stream n;
+        normalize(b, n);
+        dispatch::reflect(a, n, r);
+        for (size_t i = 0; i < kCount; i++)
+            assertEquals(reflect(a.get(i), n.get(i)), r.get(i));
+    });
+}
+
+static void testDispatchNoise()
+{
+    const size_t width = 37, height = 5;
+    std::vector<float> expected(width * height), r(width * height);
+
+    forEachLevel([&]() {
+        fillNoise2D(expected.data(), width, height, Vector2(-2.5f, 7.25f), Vector2(0.15f, 0.4f), 3, 0.5f, NoiseType_Perlin);
+        dispatch::fillNoise2D(r.data(), width, height, Vector2(-2.5f, 7.25f), Vector2(0.15f, 0.4f), 3, 0.5f, NoiseType_Perlin);
+        for (size_t i = 0; i < width * height; i++)
+            assertEquals(expected[i], r[i]);
+
+        fillNoise2D(expected.data(), width, height, Vector2(-2.5f, 7.25f), Vector2(0.15f, 0.4f), 3, 0.5f, NoiseType_Simplex);
+        dispatch::fillNoise2D(r.data(), width, height, Vector2(-2.5f, 7.25f), Vector2(0.15f, 0.4f), 3, 0.5f, NoiseType_Simplex);
+        for (size_t i = 0; i < width * height; i++)
+            assertEquals(expected[i], r[i]);
+    });
+}
+
+Test getDispatchTest(const std::string &test)
+{
+    if (test == "DispatchLevels") return &testDispatchLevels;
+    if (test == "DispatchTransform") return &testDispatchTransform;
+    if (test == "DispatchMath") return &testDispatchMath;
+    if (test == "DispatchStream") return &testDispatchStream;
+    if (test == "DispatchNoise") return &testDispatchNoise;
+
+    return nullptr;
+}
@@ -0,0 +1,216 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+static DualQuaternion sampleTransform(float angle, const Vector3 &axis, const Vector3 &translation)
+{
+    return DualQuaternion(rotateaxis(axis / length(axis), radians(angle)), translation);
+}
+
+static void assertTransformEquals(const DualQuaternion &expected, const DualQuaternion &actual)
+{
+    // q and -q are the same transform
+    const float sign = dot(expected.real, actual.real) < 0.0f ? -1.0f : 1.0f;
+    for (size_t k = 0; k < 4; k++)
+    {
+        assertEquals(expected.real[k], actual.real[k] * sign);
+        assertEquals(expected.dual[k], actual.dual[k] * sign);
+    }
+}
+
+static void testDualQuaternionBasic()
+{
+    DualQuaternion a;
+    Vector3 p = transformpoint(a, Vector3(1, 2, 3));
+    assertEquals(1.0f, p.x);
+    assertEquals(2.0f, p.y);
+    assertEquals(3.0f, p.z);
+
+    a = sampleTransform(90.0f, Vector3(0, 0, 1), Vector3(5, -1, 2));
+    const Vector3 t = a.translation();
+    assertEquals(5.0f, t.x);
+    assertEquals(-1.0f, t.y);
+    assertEquals(2.0f, t.z);
+
+    // rotated to (0, 1, 0) first, then translated
+    p = transformpoint(a, Vector3(1, 0, 0));
+    assertEquals(5.0f, p.x);
+    assertEquals(0.0f, p.y);
+    assertEquals(2.0f, p.z);
+
+    p = transformvector(a, Vector3(1, 0, 0));
+    assertEquals(0.0f, p.x);
+    assertEquals(1.0f, p.y);
+    assertEquals(0.0f, p.z);
+}
+
+static void testDualQuaternionMul()
+{
+    const DualQuaternion a = sampleTransform(40.0f, Vector3(1, 2, 0), Vector3(1, 0, -3));
+    const DualQuaternion b = sampleTransform(-75.0f, Vector3(0, 1, 1), Vector3(0.5f, 2, 1));
+    const Vector3 p(0.3f, -1.2f, 2.0f);
+
+    Vector3 expected = transformpoint(a, transformpoint(b, p));
+    Vector3 actual = transformpoint(a * b, p);
+    assertEquals(expected.x, actual.x);
+    assertEquals(expected.y, actual.y);
+    assertEquals(expected.z, actual.z);
+
+    DualQuaternion c = a;
+    c *= b;
+    assertTransformEquals(a * b, c);
+
+    // the conjugate of a unit dual quaternion is its inverse
+    assertTransformEquals(DualQuaternion(), conjugate(a) * a);
+    actual = transformpoint(conjugate(a), transformpoint(a, p));
+    assertEquals(p.x, actual.x);
+    assertEquals(p.y, actual.y);
+    assertEquals(p.z, actual.z);
+}
+
+static void testDualQuaternionNormalize()
+{
+    const DualQuaternion a = sampleTransform(120.0f, Vector3(-1, 1, 3), Vector3(4, 5, 6));
+
+    assertTransformEquals(a, normalize(a * 3.5f));
+
+    // a dual part which is not orthogonal to the real part is removed
+    DualQuaternion b = a;
+    b.dual += a.real * 0.25f;
+    assertTransformEquals(a, normalize(b));
+}
+
+static void testDualQuaternionMatrix()
+{
+    const DualQuaternion a = sampleTransform(65.0f, Vector3(2, -1, 1), Vector3(-2, 3, 0.5f));
+    const Vector3 p(1.5f, 0.25f, -4.0f);
+
+    const Matrix4 m = totransform(a);
+    const Vector4 expected = m * Vector4(p, 1.0f);
+    const Vector3 actual = transformpoint(a, p);
+    assertEquals(expected.x, actual.x);
+    assertEquals(expected.y, actual.y);
+    assertEquals(expected.z, actual.z);
+    assertEquals(1.0f, expected.w);
+
+    assertTransformEquals(a, fromtransform(m));
+
+    // rotations near 180 degrees take each branch of fromrotation
+    const Vector3 axes[] = { Vector3(1, 0.1f, 0.2f), Vector3(0.1f, 1, -0.2f), Vector3(0.2f, -0.1f, 1) };
+    for (const Vector3 &axis : axes)
+    {
+        const DualQuaternion b = sampleTransform(175.0f, axis, Vector3(1, 2, 3));
+        assertTransformEquals(b, fromtransform(totransform(b)));
+    }
+}
+
+static void testDualQuaternionSclerp()
+{
+    const DualQuaternion a = sampleTransform(10.0f, Vector3(1, 0, 0), Vector3(1, 2, 3));
+    const DualQuaternion b = sampleTransform(80.0f, Vector3(0, 1, 1), Vector3(-2, 0, 5));
+
+    assertTransformEquals(a, sclerp(a, b, 0.0f));
+    assertTransformEquals(b, sclerp(a, b, 1.0f));
+    assertTransformEquals(b, sclerp(a, -b, 1.0f));
+
+    // a screw about the z axis: the angle and the distance along it are halved
+    const DualQuaternion screw = sampleTransform(90.0f, Vector3(0, 0, 1), Vector3(0, 0, 4));
+    assertTransformEquals(sampleTransform(45.0f, Vector3(0, 0, 1), Vector3(0, 0, 2)), sclerp(DualQuaternion(), screw, 0.5f));
+
+    // a rotation about an axis through (1, 0, 0) keeps points on it in place
+    const DualQuaternion pivot = DualQuaternion(Quaternion(), Vector3(1, 0, 0)) * sampleTransform(90.0f, Vector3(0, 0, 1), Vector3(0, 0, 0))
+        * DualQuaternion(Quaternion(), Vector3(-1, 0, 0));
+    const Vector3 p = transformpoint(sclerp(DualQuaternion(), pivot, 0.5f), Vector3(1, 0, 0));
+    assertEquals(1.0f, p.x);
+    assertEquals(0.0f, p.y);
+    assertEquals(0.0f, p.z);
+
+    // without rotation the translation is interpolated linearly
+    const DualQuaternion c(Quaternion(), Vector3(2, 4, -6));
+    assertTransformEquals(DualQuaternion(Quaternion(), Vector3(0.5f, 1, -1.5f)), sclerp(DualQuaternion(), c, 0.25f));
+}
+
+static void testDualQuaternionSkin()
+{
+    const size_t jointCount = 4;
+    DualQuaternion joints[jointCount];
+    joints[0] = sampleTransform(30.0f, Vector3(0, 1, 0), Vector3(0, 1, 0));
+    joints[1] = sampleTransform(-60.0f, Vector3(1, 0, 1), Vector3(2, 0, -1));
+    joints[2] = -sampleTransform(45.0f, Vector3(0, 1, 0), Vector3(0, 1.5f, 0)); // in the other hemisphere
+    joints[3] = DualQuaternion();
+
+    // not a multiple of the batch or of any register width
+    const size_t count = 131;
+    Vector3 positions[count], normals[count], outPositions[count], outNormals[count];
+    SkinInfluence influences[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        const float f = (float)i;
+        positions[i] = Vector3(sinf(f), cosf(f * 0.3f) * 2.0f, f * 0.05f - 3.0f);
+        normals[i] = Vector3(cosf(f), 1.0f, sinf(f * 0.7f));
+
+        SkinInfluence &v = influences[i];
+        for (size_t k = 0; k < 4; k++)
+            v.joints[k] = (uint32_t)((i + k) % jointCount);
+        v.weights[0] = 0.4f;
+        v.weights[1] = 0.3f;
+        v.weights[2] = i % 3 == 0 ? 0.0f : 0.2f;
+        v.weights[3] = 1.0f - v.weights[0] - v.weights[1] - v.weights[2];
+    }
+
+    skinDualQuaternion(joints, influences, positions, outPositions, count, normals, outNormals);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const SkinInfluence &v = influences[i];
+        const Quaternion &pivot = joints[v.joints[0]].real;
+
+        DualQuaternion blend(Quaternion(0, 0, 0, 0), Quaternion(0, 0, 0, 0));
+        for (size_t k = 0; k < 4; k++)
+        {
+            const DualQuaternion &joint = joints[v.joints[k]];
+            blend += joint * (dot(joint.real, pivot) < 0.0f ? -v.weights[k] : v.weights[k]);
+        }
+        blend = normalize(blend);
+
+        const Vector3 p = transformpoint(blend, positions[i]);
+        assertEquals(p.x, outPositions[i].x);
+        assertEquals(p.y, outPositions[i].y);
+        assertEquals(p.z, outPositions[i].z);
+
+        const Vector3 n = transformvector(blend, normals[i]);
+        assertEquals(n.x, outNormals[i].x);
+        assertEquals(n.y, outNormals[i].y);
+        assertEquals(n.z, outNormals[i].z);
+    }
+
+    // a vertex fully weighted to one joint moves rigidly with it, in place
+    for (size_t i = 0; i < count; i++)
+    {
+        influences[i].weights[0] = 1.0f;
+        influences[i].weights[1] = influences[i].weights[2] = influences[i].weights[3] = 0.0f;
+        outPositions[i] = positions[i];
+    }
+    skinDualQuaternion(joints, influences, outPositions, outPositions, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vector3 p = transformpoint(joints[influences[i].joints[0]], positions[i]);
+        assertEquals(p.x, outPositions[i].x);
+        assertEquals(p.y, outPositions[i].y);
+        assertEquals(p.z, outPositions[i].z);
+    }
+}
+
+Test getDualQuaternionTest(const std::string &test)
+{
+    if (test == "DualQuaternionBasic") return testDualQuaternionBasic;
+    if (test == "DualQuaternionMul") return testDualQuaternionMul;
+    if (test == "DualQuaternionNormalize") return testDualQuaternionNormalize;
+    if (test == "DualQuaternionMatrix") return testDualQuaternionMatrix;
+    if (test == "DualQuaternionSclerp") return testDualQuaternionSclerp;
+    if (test == "DualQuaternionSkin") return testDualQuaternionSkin;
+
+    return nullptr;
+}
@@ -0,0 +1,164 @@
+#include <mutil/mutil.h>
+#include <mutil/mat/dynamic_matrix_parallel.h>
+#include <string>
+#include <utility>
+#include "test.h"
+
+using namespace mutil;
+
+// c = alpha * a * b + beta * c, one element at a time
+template <typename T>
+static void referenceGemm(const MatrixView<const T> &a, const MatrixView<const T> &b, const MatrixView<T> &c, T alpha, T beta)
+{
+    for (size_t j = 0; j < c.cols(); j++)
+    {
+        for (size_t i = 0; i < c.rows(); i++)
+        {
+            T sum = T(0);
+            for (size_t p = 0; p < a.cols(); p++)
+                sum += a(i, p) * b(p, j);
+            c(i, j) = alpha * sum + beta * c(i, j);
+        }
+    }
+}
+
+template <typename T>
+static void assertMatrixEquals(const MatrixView<const T> &expected, const MatrixView<const T> &actual)
+{
+    assertEquals((unsigned int)expected.rows(), (unsigned int)actual.rows());
+    assertEquals((unsigned int)expected.cols(), (unsigned int)actual.cols());
+    for (size_t j = 0; j < expected.cols(); j++)
+        for (size_t i = 0; i < expected.rows(); i++)
+            assertEquals((float)expected(i, j), (float)actual(i, j));
+}
+
+static void testDynamicMatrixBasic()
+{
+    DynamicMatrix<float> m(5, 3);
+    assertEquals(5u, (unsigned int)m.rows());
+    assertEquals(3u, (unsigned int)m.cols());
+    assertTrue(m.stride() >= m.rows());
+    assertTrue((size_t)m.data() % MUTIL_STREAM_ALIGNMENT == 0);
+    assertTrue((size_t)&m(0, 1) % MUTIL_STREAM_ALIGNMENT == 0);
+    assertEquals(0.0f, m(4, 2));
+
+    const DynamicMatrix<float> identity(3, 3, 1.0f);
+    assertEquals(1.0f, identity(1, 1));
+    assertEquals(0.0f, identity(1, 2));
+
+    m(1, 2) = 4.0f;
+    const MatrixView<float> block = m.block(1, 1, 3, 2);
+    assertEquals(4.0f, block(0, 1));
+    block(2, 0) = -1.0f;
+    assertEquals(-1.0f, m(3, 1));
+
+    const DynamicMatrix<float> copy(block);
+    assertEquals(4.0f, copy(0, 1));
+    assertEquals(-1.0f, copy(2, 0));
+
+    const DynamicMatrix<float> empty(DynamicMatrix<float>(0, 3).view());
+    assertEquals(0u, (unsigned int)empty.rows());
+    assertEquals(3u, (unsigned int)empty.cols());
+
+    const DynamicMatrix<float> t = transpose(m);
+    assertEquals(4.0f, t(2, 1));
+    assertEquals(-1.0f, t(1, 3));
+    assertTrue(transpose(t) == m);
+
+    const DynamicMatrix<float> a = sampleMatrix<float>(4, 6, 1);
+    const DynamicMatrix<float> b = sampleMatrix<float>(4, 6, 2);
+    const DynamicMatrix<float> sum = a + b, difference = a - b, scaled = 2.0f * a;
+    for (size_t j = 0; j < 6; j++)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            assertEquals(a(i, j) + b(i, j), sum(i, j));
+            assertEquals(a(i, j) - b(i, j), difference(i, j));
+            assertEquals(a(i, j) * 2.0f, scaled(i, j));
+        }
+    }
+
+    const DynamicMatrix<float> moved = std::move(m);
+    assertEquals(4.0f, moved(1, 2));
+    assertTrue(m.data() == nullptr);
+}
+
+template <typename T>
+static void checkGemm(size_t m, size_t n, size_t k)
+{
+    const DynamicMatrix<T> a = sampleMatrix<T>(m, k, 3);
+    const DynamicMatrix<T> b = sampleMatrix<T>(k, n, 5);
+
+    DynamicMatrix<T> expected = sampleMatrix<T>(m, n, 7);
+    DynamicMatrix<T> c = expected;
+    referenceGemm<T>(a, b, expected, T(0.5), T(-2));
+    gemm(a, b, c, T(0.5), T(-2));
+    assertMatrixEquals<T>(expected, c);
+
+    referenceGemm<T>(a, b, expected, T(1), T(0));
+    assertMatrixEquals<T>(expected, a * b);
+}
+
+static void testDynamicMatrixGemm()
+{
+    // tiles smaller than one register tile, edges in every dimension and
+    // more than one block of each of m, n and k
+    checkGemm<float>(1, 1, 1);
+    checkGemm<float>(3, 5, 2);
+    checkGemm<float>(37, 53, 29);
+    checkGemm<float>(300, 270, 530);
+
+    // an empty product only scales c
+    DynamicMatrix<float> c(4, 4, 3.0f);
+    gemm(DynamicMatrix<float>(4, 0), DynamicMatrix<float>(0, 4), c, 1.0f, 2.0f);
+    assertEquals(6.0f, c(2, 2));
+}
+
+static void testDynamicMatrixGemmView()
+{
+    // blocks of larger matrices, so that the stride is not the row count
+    const DynamicMatrix<float> a = sampleMatrix<float>(70, 90, 1);
+    const DynamicMatrix<float> b = sampleMatrix<float>(90, 60, 2);
+    DynamicMatrix<float> c = sampleMatrix<float>(50, 50, 3);
+    DynamicMatrix<float> expected = c;
+
+    const MatrixView<const float> va = a.block(3, 5, 41, 77);
+    const MatrixView<const float> vb = b.block(7, 2, 77, 31);
+    referenceGemm<float>(va, vb, expected.block(4, 6, 41, 31), 1.0f, 1.0f);
+    gemm<float>(va, vb, c.block(4, 6, 41, 31), 1.0f, 1.0f);
+    assertMatrixEquals<float>(expected, c);
+}
+
+static void testDynamicMatrixGemmDouble()
+{
+    checkGemm<double>(3, 5, 2);
+    checkGemm<double>(37, 53, 29);
+    checkGemm<double>(150, 140, 300);
+}
+
+static void testDynamicMatrixGemmParallel()
+{
+    ThreadPool pool(4);
+
+    const DynamicMatrix<float> a = sampleMatrix<float>(600, 300, 1);
+    const DynamicMatrix<float> b = sampleMatrix<float>(300, 700, 2);
+    DynamicMatrix<float> expected = sampleMatrix<float>(600, 700, 3);
+    DynamicMatrix<float> c = expected;
+
+    gemm(a, b, expected, 2.0f, 0.5f);
+    gemmParallel(a, b, c, 2.0f, 0.5f, &pool);
+
+    // every tile runs the same kernels over the whole of k
+    assertTrue(expected == c);
+}
+
+Test getDynamicMatrixTest(const std::string &test)
+{
+    if (test == "DynamicMatrixBasic") return &testDynamicMatrixBasic;
+    if (test == "DynamicMatrixGemm") return &testDynamicMatrixGemm;
+    if (test == "DynamicMatrixGemmView") return &testDynamicMatrixGemmView;
+    if (test == "DynamicMatrixGemmDouble") return &testDynamicMatrixGemmDouble;
+    if (test == "DynamicMatrixGemmParallel") return &testDynamicMatrixGemmParallel;
+
+    return nullptr;
+}
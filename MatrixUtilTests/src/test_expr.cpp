@@ -0,0 +1,90 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+static constexpr size_t kSize = 37;
+
+using LongVector = BasicVector<float, kSize>;
+using WideMatrix = BasicMatrix<float, 3, 5>;
+
+static LongVector sampleVector(float offset)
+{
+    LongVector v;
+    for (size_t i = 0; i < kSize; i++)
+        v[i] = (float)i * 0.5f - offset;
+    return v;
+}
+
+static void testExprVector()
+{
+    const LongVector a = sampleVector(3.0f);
+    const LongVector b = sampleVector(-1.0f);
+    const LongVector c = sampleVector(7.5f);
+    const LongVector d(2.0f);
+
+    const LongVector eager = a * 2.0f + b * 0.5f - c;
+    const LongVector fused = lazy(a) * 2.0f + lazy(b) * 0.5f - c;
+    for (size_t i = 0; i < kSize; i++)
+        assertEquals(eager[i], fused[i]);
+
+    const LongVector eager2 = -(a * b) / d + c / 4.0f;
+    const LongVector fused2 = -(lazy(a) * b) / lazy(d) + 0.25f * lazy(c);
+    for (size_t i = 0; i < kSize; i++)
+        assertEquals(eager2[i], fused2[i]);
+
+    const LongVector fused3 = (a - lazy(b)) / d;
+    for (size_t i = 0; i < kSize; i++)
+        assertEquals((a[i] - b[i]) / 2.0f, fused3[i]);
+
+    // in place, with the destination also an operand
+    LongVector r = a;
+    assign(r, lazy(r) * 3.0f - b);
+    for (size_t i = 0; i < kSize; i++)
+        assertEquals(a[i] * 3.0f - b[i], r[i]);
+}
+
+static void testExprMatrix()
+{
+    WideMatrix a, b;
+    for (size_t i = 0; i < 15; i++)
+    {
+        a[i] = (float)i - 4.0f;
+        b[i] = 1.0f - (float)(i % 4) * 0.5f;
+    }
+
+    const WideMatrix eager = a * 2.0f - b / 4.0f + a;
+    const WideMatrix fused = lazy(a) * 2.0f - lazy(b) / 4.0f + a;
+    for (size_t i = 0; i < 15; i++)
+        assertEquals(eager[i], fused[i]);
+
+    WideMatrix r;
+    assign(r, -lazy(a) + b);
+    for (size_t i = 0; i < 15; i++)
+        assertEquals(b[i] - a[i], r[i]);
+}
+
+// The specialized types keep their eager operators.
+static void testExprSpecialized()
+{
+    const Vector4 v(1.0f, 2.0f, 3.0f, 4.0f);
+    assertTrue(&lazy(v) == &v);
+    assertEquals(v * 2.0f + v, Vector4(lazy(v) * 2.0f + v));
+
+    const Matrix4 m(2.0f);
+    assertTrue(&lazy(m) == &m);
+    assertEquals(Matrix4(4.0f), Matrix4(lazy(m) * m));
+
+    const IntVector3 iv(1, 2, 3);
+    assertTrue(&lazy(iv) == &iv);
+}
+
+Test getExprTest(const std::string &test)
+{
+    if (test == "ExprVector") return &testExprVector;
+    if (test == "ExprMatrix") return &testExprMatrix;
+    if (test == "ExprSpecialized") return &testExprSpecialized;
+
+    return nullptr;
+}
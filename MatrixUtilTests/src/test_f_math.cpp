@@ -1,5 +1,7 @@
 #include <mutil/mutil.h>
 #include <string>
+#include <cmath>
+#include <type_traits>
 #include "test.h"
 
 using namespace mutil;
@@ -461,6 +463,82 @@ static void testFMathLog10()
     assertEquals(2.0f, r);
 }
 
+// Checks f on evenly spaced points in [lo, hi]. Each result must be within
+// maxAbs or within maxUlps of the reference.
+template <typename F, typename R>
+static void checkTier(float lo, float hi, F f, R reference, double maxAbs, double maxUlps)
+{
+    constexpr int kCount = 10007;
+    for (int i = 0; i < kCount; i++)
+    {
+        const float x = lo + (hi - lo) * (float)i / (float)(kCount - 1);
+        const double expected = reference((double)x);
+        const float actual = f(x);
+        assertTrue(fabs((double)actual - expected) <= maxAbs || ulps(actual, expected) <= maxUlps);
+    }
+}
+
+#define CHECK_TIERS(name, lo, hi, fastAbs, balancedUlps) \
+    checkTier(lo, hi, [](float x) { return mutil::name<precision::Fast>(x); }, [](double x) { return std::name(x); }, fastAbs, 0.0); \
+    checkTier(lo, hi, [](float x) { return mutil::name<precision::Balanced>(x); }, [](double x) { return std::name(x); }, 1e-7, balancedUlps); \
+    checkTier(lo, hi, [](float x) { return mutil::name<precision::Precise>(x); }, [](double x) { return std::name(x); }, 0.0, 1.0); \
+    assertEquals(mutil::name<precision::Fast>(0.5f), mutil::name(0.5f, precision::Fast())); \
+    assertEquals(mutil::name<precision::Precise>(0.5f), mutil::name(0.5f, precision::Precise()));
+
+static void testFMathPrecisionTrig()
+{
+    CHECK_TIERS(sin, -100.0f, 100.0f, 1e-5, 4.0);
+    CHECK_TIERS(cos, -100.0f, 100.0f, 1e-5, 4.0);
+    CHECK_TIERS(tan, -1.2f, 1.2f, 1e-4, 4.0);
+}
+
+static void testFMathPrecisionInverseTrig()
+{
+    CHECK_TIERS(asin, -1.0f, 1.0f, 1e-4, 4.0);
+    CHECK_TIERS(acos, -1.0f, 1.0f, 1e-4, 4.0);
+    CHECK_TIERS(atan, -100.0f, 100.0f, 2e-5, 3.0);
+
+    // documented as the functions without a tier
+    assertEquals(mutil::asin(0.3f), mutil::asin<precision::Fast>(0.3f));
+    assertEquals(mutil::acos(0.3f), mutil::acos<precision::Fast>(0.3f));
+}
+
+static void testFMathPrecisionLog()
+{
+    CHECK_TIERS(log2, 0.001f, 1000.0f, 2e-5, 2.0);
+    CHECK_TIERS(log, 0.001f, 1000.0f, 2e-5, 1.0);
+    CHECK_TIERS(log10, 0.001f, 1000.0f, 2e-5, 2.0);
+}
+
+#undef CHECK_TIERS
+
+// Whether sin(x, T()) selects a precision tier. Only the tags may, so that
+// the tier overloads do not capture other two argument calls.
+template <typename T, typename = void>
+struct HasTierOverload : std::false_type {};
+
+template <typename T>
+struct HasTierOverload<T, decltype((void)mutil::sin(0.0f, T()))> : std::true_type {};
+
+static_assert(HasTierOverload<precision::Fast>::value, "the Fast tag must select a tier");
+static_assert(HasTierOverload<precision::Balanced>::value, "the Balanced tag must select a tier");
+static_assert(HasTierOverload<precision::Precise>::value, "the Precise tag must select a tier");
+static_assert(!HasTierOverload<int>::value, "only precision tags may select a tier");
+static_assert(!HasTierOverload<double>::value, "only precision tags may select a tier");
+
+static void testFMathPrecisionInverseSqrt()
+{
+    for (int i = 1; i <= 10000; i++)
+    {
+        const float x = (float)i * 0.37f;
+        const double expected = 1.0 / std::sqrt((double)x);
+
+        assertTrue(fabs(mutil::inverseSqrt<precision::Fast>(x) - expected) <= 2e-3 * expected);
+        assertTrue(ulps(mutil::inverseSqrt<precision::Balanced>(x), expected) <= 4.0);
+        assertTrue(ulps(mutil::inverseSqrt<precision::Precise>(x), expected) <= 1.0);
+    }
+}
+
 Test getFMathTest(const std::string &test)
 {
     if (test == "FMathConstants")
@@ -519,6 +597,14 @@ Test getFMathTest(const std::string &test)
         return testFMathLog;
     if (test == "FMathLog10")
         return testFMathLog10;
+    if (test == "FMathPrecisionTrig")
+        return testFMathPrecisionTrig;
+    if (test == "FMathPrecisionInverseTrig")
+        return testFMathPrecisionInverseTrig;
+    if (test == "FMathPrecisionLog")
+        return testFMathPrecisionLog;
+    if (test == "FMathPrecisionInverseSqrt")
+        return testFMathPrecisionInverseSqrt;
 
     return nullptr;
 }
\ No newline at end of file
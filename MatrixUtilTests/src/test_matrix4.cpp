@@ -0,0 +1,195 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+// not a multiple of any register width, so every kernel also runs its tail
+static constexpr size_t kCount = 37;
+
+static const Matrix4 kTransform(
+    1.0f, 0.5f, -2.0f, 3.0f,
+    0.0f, 2.0f, 1.0f, -1.0f,
+    -1.5f, 0.0f, 1.0f, 4.0f,
+    0.1f, 0.2f, 0.05f, 2.0f);
+
+static void testMatrix4TransformPoints()
+{
+    Vector3 in[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+        in[i] = samplePoint(i);
+
+    transformPoints(kTransform, in, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector4 r = kTransform * Vector4(in[i], 1.0f);
+        assertEquals(Vector3(r), out[i]);
+    }
+
+    transformPoints(kTransform, in, out, kCount, true);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector4 r = kTransform * Vector4(in[i], 1.0f);
+        assertEquals(Vector3(r) / r.w, out[i]);
+    }
+
+    // in place
+    transformPoints(kTransform, in, in, kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector4 r = kTransform * Vector4(samplePoint(i), 1.0f);
+        assertEquals(Vector3(r), in[i]);
+    }
+}
+
+static void testMatrix4TransformVectors()
+{
+    Vector3 in[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+        in[i] = samplePoint(i);
+
+    transformVectors(kTransform, in, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector4 r = kTransform * Vector4(in[i], 0.0f);
+        assertEquals(Vector3(r), out[i]);
+    }
+}
+
+static void testMatrix4TransformPoints4()
+{
+    Vector4 in[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+        in[i] = Vector4(samplePoint(i), (float)(i % 4) * 0.5f + 0.5f);
+
+    transformPoints4(kTransform, in, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(kTransform * in[i], out[i]);
+
+    transformPoints4(kTransform, in, out, kCount, true);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector4 r = kTransform * in[i];
+        assertEquals(Vector4(Vector3(r) / r.w, 1.0f), out[i]);
+    }
+}
+
+static void testMatrix4Determinant()
+{
+    assertEquals(1.0f, determinant(Matrix4()));
+    assertEquals(determinantScalar(kTransform), determinant(kTransform));
+    assertEquals(-24.0f, determinant(Matrix4(
+        2.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 3.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, -4.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f)));
+    assertEquals(determinant(kTransform), kTransform.determinant());
+
+    static_assert(determinantScalar(Matrix4(2.0f)) == 16.0f, "determinantScalar must be constexpr");
+#if !(MUTIL_USE_SSE || MUTIL_USE_NEON)
+    static_assert(determinant(Matrix4(2.0f)) == 16.0f, "the scalar determinant must be constexpr");
+    static_assert(Matrix4(2.0f).determinant() == 16.0f, "the scalar determinant must be constexpr");
+#endif
+}
+
+static void testMatrix4Inverse()
+{
+    const Matrix4 inv = inverse(kTransform);
+    assertEquals(inverseScalar(kTransform), inv);
+    assertEquals(Matrix4(), kTransform * inv);
+    assertEquals(Matrix4(), inv * kTransform);
+    assertEquals(inv, kTransform.inverse());
+}
+
+static Matrix4 rigidTransform()
+{
+    Quaternion q(0.9f, 0.2f, -0.4f, 0.1f);
+    Matrix4 m = torotation(q / sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z));
+    m.columns[3] = Vector4(1.0f, -2.0f, 3.0f, 1.0f);
+    return m;
+}
+
+static void testMatrix4InverseAffine()
+{
+    const Matrix4 m = scale(rigidTransform(), Vector3(2.0f, 0.5f, 3.0f));
+
+    assertEquals(inverseScalar(m), inverseAffine(m));
+    assertEquals(Matrix4(), m * inverseAffine(m));
+}
+
+static void testMatrix4InverseOrthonormal()
+{
+    const Matrix4 m = rigidTransform();
+
+    assertEquals(inverseScalar(m), inverseOrthonormal(m));
+    assertEquals(Matrix4(), m * inverseOrthonormal(m));
+}
+
+// reference product computed element by element
+static Matrix4 mulReference(const Matrix4 &a, const Matrix4 &b)
+{
+    Matrix4 r(0.0f);
+    for (size_t j = 0; j < 4; j++)
+        for (size_t i = 0; i < 4; i++)
+            for (size_t k = 0; k < 4; k++)
+                r.mat[j * 4 + i] += a.mat[k * 4 + i] * b.mat[j * 4 + k];
+    return r;
+}
+
+static void testMatrix4MulMatrix()
+{
+    const Matrix4 a(
+        1.0f, 2.0f, 3.0f, 4.0f,
+        5.0f, 6.0f, 7.0f, 8.0f,
+        9.0f, 10.0f, 11.0f, 12.0f,
+        13.0f, 14.0f, 15.0f, 16.0f);
+    const Matrix4 b(
+        -1.0f, 0.5f, 2.0f, 0.0f,
+        3.0f, 1.0f, -2.0f, 1.0f,
+        0.0f, 4.0f, 1.0f, -3.0f,
+        2.0f, -1.0f, 0.0f, 1.0f);
+
+    assertEquals(Matrix4(
+        13.0f, 10.5f, 1.0f, -3.0f,
+        29.0f, 28.5f, 5.0f, -7.0f,
+        45.0f, 46.5f, 9.0f, -11.0f,
+        61.0f, 64.5f, 13.0f, -15.0f), a * b);
+    assertEquals(mulReference(b, a), b * a);
+    assertEquals(mulReference(kTransform, a), kTransform * a);
+    assertEquals(a, a * Matrix4());
+    assertEquals(a, Matrix4() * a);
+}
+
+static void testMatrix4MultiplyMany()
+{
+    Matrix4 a[kCount], b[kCount], out[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a[i] = kTransform * (float)(i + 1);
+        b[i] = inverseScalar(kTransform) + Matrix4((float)i);
+    }
+
+    multiplyMany(a, b, out, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(mulReference(a[i], b[i]), out[i]);
+
+    // in place
+    multiplyMany(a, b, a, kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(out[i], a[i]);
+}
+
+Test getMatrix4Test(const std::string &test)
+{
+    if (test == "Matrix4TransformPoints") return &testMatrix4TransformPoints;
+    if (test == "Matrix4TransformVectors") return &testMatrix4TransformVectors;
+    if (test == "Matrix4TransformPoints4") return &testMatrix4TransformPoints4;
+    if (test == "Matrix4MulMatrix") return &testMatrix4MulMatrix;
+    if (test == "Matrix4MultiplyMany") return &testMatrix4MultiplyMany;
+    if (test == "Matrix4Determinant") return &testMatrix4Determinant;
+    if (test == "Matrix4Inverse") return &testMatrix4Inverse;
+    if (test == "Matrix4InverseAffine") return &testMatrix4InverseAffine;
+    if (test == "Matrix4InverseOrthonormal") return &testMatrix4InverseOrthonormal;
+
+    return nullptr;
+}
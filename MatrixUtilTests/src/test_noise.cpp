@@ -0,0 +1,423 @@
+#include <mutil/mutil.h>
+#include <mutil/math/noise_parallel.h>
+#include <string>
+#include <vector>
+#include "test.h"
+
+using namespace mutil;
+
+// wider than a tile and taller than a band, so the grid has partial tiles
+static constexpr size_t kWidth = 261;
+static constexpr size_t kHeight = 19;
+
+template <typename F>
+static void checkGrid(const Vector2 &origin, const Vector2 &step, int octaves, NoiseType type, F reference)
+{
+	std::vector<float> grid(kWidth * kHeight);
+	fillNoise2D(grid.data(), kWidth, kHeight, origin, step, octaves, 0.5f, type);
+
+	for (size_t y = 0; y < kHeight; y++)
+	{
+		for (size_t x = 0; x < kWidth; x++)
+		{
+			Vector2 pos = origin + Vector2((float)x * step.x, (float)y * step.y);
+			assertEquals(reference(pos, 0.5f, octaves), grid[y * kWidth + x]);
+		}
+	}
+}
+
+static void testNoisePerlinGrid()
+{
+	auto perlin = [](const Vector2 &pos, float persistence, int octaves) { return pnoise(pos, persistence, octaves); };
+
+	checkGrid(Vector2(-3.7f, 12.1f), Vector2(0.05f, 0.3f), 1, NoiseType_Perlin, perlin);
+	checkGrid(Vector2(100.25f, -40.5f), Vector2(0.1f, 0.1f), 4, NoiseType_Perlin, perlin);
+	checkGrid(Vector2(5.0f, 5.0f), Vector2(-0.3f, -1.7f), 2, NoiseType_Perlin, perlin);
+}
+
+static void testNoiseSimplexGrid()
+{
+	auto simplex = [](const Vector2 &pos, float persistence, int octaves) { return snoise(pos, persistence, octaves); };
+
+	checkGrid(Vector2(-3.7f, 12.1f), Vector2(0.05f, 0.3f), 1, NoiseType_Simplex, simplex);
+	checkGrid(Vector2(100.25f, -40.5f), Vector2(0.1f, 0.1f), 4, NoiseType_Simplex, simplex);
+	checkGrid(Vector2(5.0f, 5.0f), Vector2(-0.3f, -1.7f), 2, NoiseType_Simplex, simplex);
+}
+
+static void testNoiseGridNoOctaves()
+{
+	float grid[12];
+	for (size_t i = 0; i < 12; i++)
+		grid[i] = 1.0f;
+
+	fillNoise2D(grid, 4, 3, Vector2(0.5f, 0.5f), Vector2(1.0f, 1.0f), 0);
+	for (size_t i = 0; i < 12; i++)
+		assertEquals(0.0f, grid[i]);
+}
+
+// positions spread over many cells, on both sides of zero
+static Vector4 samplePosition(size_t i)
+{
+	const float f = (float)i;
+	return Vector4(f * 0.731f - 40.0f, 17.3f - f * 0.377f, f * 0.113f - 3.1f, f * 0.593f - 25.0f);
+}
+
+// Compares the batch versions of a noise function on arrays and streams against
+// the version taking a single position
+template <size_t N, typename F>
+static void checkBatch(F noise)
+{
+	// not a multiple of the batch size, nor of any register width
+	const size_t count = 203;
+
+	std::vector<Vector<N>> in(count);
+	VectorStream<N> stream(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		in[i] = Vector<N>(samplePosition(i));
+		stream.set(i, in[i]);
+	}
+
+	std::vector<float> a(count), b(count);
+	noise(in.data(), a.data(), count);
+	noise(stream, b.data());
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const float expected = noise(in[i]);
+		assertTrue(expected >= -1.0f && expected <= 1.0f);
+		assertEquals(expected, a[i]);
+		assertEquals(expected, b[i]);
+	}
+}
+
+static void testNoiseGradientTable()
+{
+	const GradientTable table, seeded(1234), seededAgain(1234);
+
+	for (size_t i = 0; i < 256; i++)
+		assertEquals(1.0f, table.x()[i] * table.x()[i] + table.y()[i] * table.y()[i]);
+
+	bool differs = false;
+	for (size_t i = 0; i < 1000; i++)
+	{
+		const Vector2 p = Vector2(samplePosition(i));
+
+		// the gradients of the unseeded table are those of pnoise, rounded
+		assertTrue(mutil::abs(pnoise(p) - pnoise(p, table)) < 0.01f);
+
+		assertTrue(pnoise(p, seeded) == pnoise(p, seededAgain));
+		differs |= mutil::abs(pnoise(p, seeded) - pnoise(p, table)) > 0.1f;
+	}
+	assertTrue(differs);
+
+	const Vector2 p(3.7f, -1.2f);
+	assertEquals(pnoise(p, seeded) + 0.5f * pnoise(p * 2.0f, seeded), pnoise(p, 0.5f, 2, seeded));
+}
+
+static void testNoise3DPerlin()
+{
+	// value of Ken Perlin's reference implementation
+	assertEquals(0.136920f, pnoise(Vector3(3.14f, 42.0f, 7.0f)));
+
+	// zero on the lattice
+	assertEquals(0.0f, pnoise(Vector3(0.0f, 0.0f, 0.0f)));
+	assertEquals(0.0f, pnoise(Vector3(-5.0f, 12.0f, 300.0f)));
+
+	assertEquals(pnoise(Vector3(1.5f, 2.5f, 3.5f)) + 0.5f * pnoise(Vector3(3.0f, 5.0f, 7.0f)),
+		pnoise(Vector3(1.5f, 2.5f, 3.5f), 0.5f, 2));
+
+	checkBatch<3>([](auto... args) { return pnoise(args...); });
+}
+
+static void testNoise3DSimplex()
+{
+	// continuous across cell boundaries
+	assertEquals(snoise(Vector3(0.999999f, 0.5f, 0.25f)), snoise(Vector3(1.000001f, 0.5f, 0.25f)));
+
+	assertEquals(snoise(Vector3(1.5f, 2.5f, 3.5f)) + 0.5f * snoise(Vector3(3.0f, 5.0f, 7.0f)),
+		snoise(Vector3(1.5f, 2.5f, 3.5f), 0.5f, 2));
+
+	checkBatch<3>([](auto... args) { return snoise(args...); });
+}
+
+static void testNoise4DSimplex()
+{
+	// continuous across cell boundaries
+	assertEquals(snoise(Vector4(0.999999f, 0.5f, 0.25f, 0.1f)), snoise(Vector4(1.000001f, 0.5f, 0.25f, 0.1f)));
+
+	assertEquals(snoise(Vector4(1.5f, 2.5f, 3.5f, 4.5f)) + 0.5f * snoise(Vector4(3.0f, 5.0f, 7.0f, 9.0f)),
+		snoise(Vector4(1.5f, 2.5f, 3.5f, 4.5f), 0.5f, 2));
+
+	checkBatch<4>([](auto... args) { return snoise(args...); });
+}
+
+static void testNoiseFractal()
+{
+	const size_t count = 203;
+
+	std::vector<Vector3> in(count);
+	Vector3Stream stream(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		in[i] = Vector3(samplePosition(i));
+		stream.set(i, in[i]);
+	}
+
+	FractalNoise f;
+	f.octaves = 5;
+	f.frequency = 0.7f;
+	f.lacunarity = 1.9f;
+	f.persistence = 0.6f;
+
+	// plain fBm is the octave version of the basis noise
+	f.type = NoiseType_Perlin;
+	f.lacunarity = 2.0f;
+	assertEquals(pnoise(in[17] * 0.7f, 0.6f, 5), f.sample(in[17]));
+	f.type = NoiseType_Simplex;
+	assertEquals(snoise(in[17] * 0.7f, 0.6f, 5), f.sample(in[17]));
+	f.lacunarity = 1.9f;
+
+	std::vector<float> a(count), b(count);
+	for (NoiseType type : { NoiseType_Perlin, NoiseType_Simplex })
+	{
+		for (FractalType fractal : { FractalType_FBm, FractalType_Billow, FractalType_Ridged, FractalType_Turbulence })
+		{
+			for (float warp : { 0.0f, 0.8f })
+			{
+				f.type = type;
+				f.fractal = fractal;
+				f.warpAmplitude = warp;
+				f.warpFrequency = 0.5f;
+
+				f.sample(in.data(), a.data(), count);
+				f.sample(stream, b.data());
+
+				for (size_t i = 0; i < count; i++)
+				{
+					const float expected = f.sample(in[i]);
+					if (fractal == FractalType_Ridged || fractal == FractalType_Turbulence)
+						assertTrue(expected >= 0.0f);
+					assertEquals(expected, a[i]);
+					assertEquals(expected, b[i]);
+				}
+			}
+		}
+	}
+}
+
+static void testNoiseWorley()
+{
+	const DistanceMetric metrics[] = { DistanceMetric_Euclidean, DistanceMetric_Manhattan, DistanceMetric_Chebyshev };
+
+	for (size_t i = 0; i < 64; i++)
+	{
+		const Vector2 p2 = Vector2(samplePosition(i));
+		const Vector3 p3 = Vector3(samplePosition(i));
+
+		for (DistanceMetric metric : metrics)
+		{
+			const float f1 = wnoise(p2, metric), f2 = wnoise(p2, metric, WorleyOutput_F2);
+			assertTrue(f1 >= 0.0f && f1 <= f2);
+			assertEquals(f2 - f1, wnoise(p2, metric, WorleyOutput_F2MinusF1));
+
+			const float g1 = wnoise(p3, metric), g2 = wnoise(p3, metric, WorleyOutput_F2);
+			assertTrue(g1 >= 0.0f && g1 <= g2);
+			assertEquals(g2 - g1, wnoise(p3, metric, WorleyOutput_F2MinusF1));
+		}
+
+		// for any offset, |d|max <= |d|2 <= |d|1
+		assertTrue(wnoise(p3, DistanceMetric_Chebyshev) <= wnoise(p3) + 1e-6f);
+		assertTrue(wnoise(p3) <= wnoise(p3, DistanceMetric_Manhattan) + 1e-6f);
+	}
+
+	// zero at the feature point of a cell
+	const IntVector2 cell2(-3, 7);
+	assertEquals(0.0f, wnoise(Vector2((float)cell2.x, (float)cell2.y) + __1::cellPoint(cell2)));
+	const IntVector3 cell3(5, -2, 11);
+	assertEquals(0.0f, wnoise(Vector3((float)cell3.x, (float)cell3.y, (float)cell3.z) + __1::cellPoint(cell3)));
+}
+
+static void testNoiseWorleyGrid()
+{
+	const size_t width = 70, height = 9, depth = 5;
+	const Vector3 origin(-2.3f, 4.1f, -0.7f), step(0.11f, 0.37f, 0.6f);
+	std::vector<float> grid(width * height * depth);
+
+	for (DistanceMetric metric : { DistanceMetric_Euclidean, DistanceMetric_Manhattan, DistanceMetric_Chebyshev })
+	{
+		for (WorleyOutput output : { WorleyOutput_F1, WorleyOutput_F2, WorleyOutput_F2MinusF1 })
+		{
+			fillWorley2D(grid.data(), width, height, Vector2(origin), Vector2(step), metric, output);
+			for (size_t y = 0; y < height; y++)
+			{
+				for (size_t x = 0; x < width; x++)
+				{
+					const Vector2 p(origin.x + (float)x * step.x, origin.y + (float)y * step.y);
+					assertEquals(wnoise(p, metric, output), grid[y * width + x]);
+				}
+			}
+
+			fillWorley3D(grid.data(), width, height, depth, origin, step, metric, output);
+			for (size_t z = 0; z < depth; z++)
+			{
+				for (size_t y = 0; y < height; y++)
+				{
+					for (size_t x = 0; x < width; x++)
+					{
+						const Vector3 p(origin.x + (float)x * step.x, origin.y + (float)y * step.y, origin.z + (float)z * step.z);
+						assertEquals(wnoise(p, metric, output), grid[(z * height + y) * width + x]);
+					}
+				}
+			}
+		}
+	}
+}
+
+// Runs tasks in reverse order on the calling thread
+class ReverseExecutor : public Executor
+{
+public:
+	void parallelFor(size_t count, const std::function<void(size_t)> &task) override
+	{
+		for (size_t i = count; i > 0; i--)
+			task(i - 1);
+	}
+};
+
+static void testNoiseGridParallel()
+{
+	const size_t width = 600, height = 150;
+	std::vector<float> expected(width * height), grid(width * height);
+
+	ThreadPool one(1), three(3);
+	ReverseExecutor reverse;
+	Executor *executors[] = { nullptr, &one, &three, &reverse };
+
+	for (NoiseType type : { NoiseType_Perlin, NoiseType_Simplex })
+	{
+		fillNoise2D(expected.data(), width, height, Vector2(-20.5f, 3.25f), Vector2(0.07f, 0.09f), 3, 0.5f, type);
+
+		for (Executor *executor : executors)
+		{
+			fillNoise2DParallel(grid.data(), width, height, Vector2(-20.5f, 3.25f), Vector2(0.07f, 0.09f), 3, 0.5f, type, executor);
+
+			// the result must not depend on the threads, so compare exactly
+			for (size_t i = 0; i < width * height; i++)
+				assertTrue(expected[i] == grid[i]);
+		}
+	}
+}
+
+static void testNoiseGenerator()
+{
+	const NoiseGenerator reference, a(42), b(42), c(43);
+
+	bool differs = false;
+	for (size_t i = 0; i < 256; i++)
+	{
+		const Vector4 p = samplePosition(i);
+
+		// the unseeded generator uses the tables of the free functions
+		assertTrue(reference.snoise(Vector2(p)) == snoise(Vector2(p)));
+		assertTrue(reference.pnoise(Vector3(p)) == pnoise(Vector3(p)));
+		assertTrue(reference.snoise(Vector3(p)) == snoise(Vector3(p)));
+		assertTrue(reference.snoise(p) == snoise(p));
+		assertTrue(mutil::abs(reference.pnoise(Vector2(p)) - pnoise(Vector2(p))) < 0.01f);
+
+		assertTrue(a.pnoise(Vector2(p)) == b.pnoise(Vector2(p)));
+		assertTrue(a.snoise(Vector3(p)) == b.snoise(Vector3(p)));
+		differs |= mutil::abs(a.snoise(Vector3(p)) - c.snoise(Vector3(p))) > 0.1f;
+		differs |= mutil::abs(a.pnoise(Vector3(p)) - pnoise(Vector3(p))) > 0.1f;
+
+		const float n = a.snoise(p, 0.5f, 3);
+		assertTrue(n >= -1.75f && n <= 1.75f);
+	}
+	assertTrue(differs);
+
+	// the batch versions use the generator's tables too
+	const size_t count = 203;
+	std::vector<Vector3> in3(count);
+	std::vector<Vector4> in4(count);
+	Vector3Stream stream3(count);
+	Vector4Stream stream4(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		in4[i] = samplePosition(i);
+		in3[i] = Vector3(in4[i]);
+		stream3.set(i, in3[i]);
+		stream4.set(i, in4[i]);
+	}
+
+	std::vector<float> out(count), outStream(count);
+	a.pnoise(in3.data(), out.data(), count);
+	a.pnoise(stream3, outStream.data());
+	for (size_t i = 0; i < count; i++)
+	{
+		assertEquals(a.pnoise(in3[i]), out[i]);
+		assertEquals(a.pnoise(in3[i]), outStream[i]);
+	}
+
+	a.snoise(in3.data(), out.data(), count);
+	a.snoise(stream3, outStream.data());
+	for (size_t i = 0; i < count; i++)
+	{
+		assertEquals(a.snoise(in3[i]), out[i]);
+		assertEquals(a.snoise(in3[i]), outStream[i]);
+	}
+
+	a.snoise(in4.data(), out.data(), count);
+	a.snoise(stream4, outStream.data());
+	for (size_t i = 0; i < count; i++)
+	{
+		assertEquals(a.snoise(in4[i]), out[i]);
+		assertEquals(a.snoise(in4[i]), outStream[i]);
+	}
+
+	const size_t width = 300, height = 70;
+	const Vector2 origin(-7.5f, 2.25f), step(0.05f, 0.08f);
+	std::vector<float> grid(width * height), parallel(width * height);
+	ThreadPool pool(3);
+
+	for (NoiseType type : { NoiseType_Perlin, NoiseType_Simplex })
+	{
+		a.fillNoise2D(grid.data(), width, height, origin, step, 2, 0.5f, type);
+		for (size_t y = 0; y < height; y++)
+		{
+			for (size_t x = 0; x < width; x++)
+			{
+				const Vector2 p = origin + Vector2((float)x * step.x, (float)y * step.y);
+				const float expected = type == NoiseType_Perlin ? a.pnoise(p, 0.5f, 2) : a.snoise(p, 0.5f, 2);
+				assertEquals(expected, grid[y * width + x]);
+			}
+		}
+
+		fillNoise2DParallel(a, parallel.data(), width, height, origin, step, 2, 0.5f, type, &pool);
+		for (size_t i = 0; i < width * height; i++)
+			assertTrue(grid[i] == parallel[i]);
+	}
+
+	// one generator shared by several threads
+	std::vector<float> shared(count);
+	pool.parallelFor(count, [&](size_t i) { shared[i] = a.snoise(in4[i], 0.5f, 4); });
+	for (size_t i = 0; i < count; i++)
+		assertTrue(shared[i] == a.snoise(in4[i], 0.5f, 4));
+}
+
+Test getNoiseTest(const std::string &test)
+{
+	if (test == "NoisePerlinGrid") return &testNoisePerlinGrid;
+	if (test == "NoiseSimplexGrid") return &testNoiseSimplexGrid;
+	if (test == "NoiseGridNoOctaves") return &testNoiseGridNoOctaves;
+	if (test == "NoiseGridParallel") return &testNoiseGridParallel;
+	if (test == "NoiseGenerator") return &testNoiseGenerator;
+	if (test == "NoiseGradientTable") return &testNoiseGradientTable;
+	if (test == "Noise3DPerlin") return &testNoise3DPerlin;
+	if (test == "Noise3DSimplex") return &testNoise3DSimplex;
+	if (test == "Noise4DSimplex") return &testNoise4DSimplex;
+	if (test == "NoiseFractal") return &testNoiseFractal;
+	if (test == "NoiseWorley") return &testNoiseWorley;
+	if (test == "NoiseWorleyGrid") return &testNoiseWorleyGrid;
+
+	return nullptr;
+}
@@ -75,6 +75,18 @@ static void testQuaternionMul()
     assertEquals(12.0f, q1.i);
     assertEquals(30.0f, q1.j);
     assertEquals(24.0f, q1.k);
+
+    q = q2 * Quaternion(1, 2, 3, 4);
+    assertEquals(-60.0f, q.a);
+    assertEquals(20.0f, q.i);
+    assertEquals(14.0f, q.j);
+    assertEquals(32.0f, q.k);
+
+#if !(MUTIL_USE_SSE || MUTIL_USE_NEON)
+    // the scalar product can be used in constant expressions
+    constexpr Quaternion c = Quaternion(1, 0, 0, 0) * Quaternion(0, 1, 0, 0);
+    static_assert(c.x == 1.0f, "the scalar quaternion product must be constexpr");
+#endif
 }
 
 static void testQuaternionMulScalar()
@@ -172,6 +184,197 @@ static void testQuaternionRotateAxis()
     assertEquals(0.70711f, q.k);
 }
 
+static void testQuaternionRotateVector()
+{
+    Vector3 v = rotatevector(rotateaxis(Vector3(0, 0, 1), radians(90.0f)), Vector3(1, 0, 0));
+    assertEquals(0.0f, v.x);
+    assertEquals(1.0f, v.y);
+    assertEquals(0.0f, v.z);
+
+    Quaternion q(0.3f, -0.5f, 0.7f, 0.2f);
+    q = q / length(q);
+    const Vector3 p(1.5f, -2.0f, 0.25f);
+    const Vector4 expected = torotation(q) * Vector4(p, 0.0f);
+    v = rotatevector(q, p);
+    assertEquals(expected.x, v.x);
+    assertEquals(expected.y, v.y);
+    assertEquals(expected.z, v.z);
+}
+
+static void testQuaternionRotateVectors()
+{
+    const size_t count = 37;
+    Vector3 in[count], out[count];
+    for (size_t i = 0; i < count; i++)
+        in[i] = Vector3(sinf((float)i), cosf((float)i * 0.7f), (float)i * 0.1f - 1.0f);
+
+    const Quaternion q = rotateaxis(normalize(Vector3(1, 2, 3)), radians(50.0f));
+    rotateVectors(q, in, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vector3 expected = rotatevector(q, in[i]);
+        assertEquals(expected.x, out[i].x);
+        assertEquals(expected.y, out[i].y);
+        assertEquals(expected.z, out[i].z);
+    }
+
+    // In place
+    rotateVectors(q, in, in, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        assertEquals(out[i].x, in[i].x);
+        assertEquals(out[i].z, in[i].z);
+    }
+}
+
+static void testQuaternionSlerp()
+{
+    Quaternion a;
+    Quaternion b = rotateaxis(Vector3(0, 0, 1), radians(90.0f));
+
+    Quaternion q = slerp(a, b, 0.5f);
+    assertEquals(0.92388f, q.a);
+    assertEquals(0.0f, q.i);
+    assertEquals(0.0f, q.j);
+    assertEquals(0.38268f, q.k);
+
+    // b and -b are the same rotation, the shorter arc is taken
+    q = slerp(a, -b, 0.5f);
+    assertEquals(0.92388f, q.a);
+    assertEquals(0.38268f, q.k);
+
+    q = slerp(a, b, 1.0f);
+    assertEquals(b.a, q.a);
+    assertEquals(b.k, q.k);
+
+    q = slerpFast(a, b, 0.25f);
+    assertEquals(cosf(radians(11.25f)), q.a);
+    assertEquals(sinf(radians(11.25f)), q.k);
+}
+
+// Deterministic unit quaternions, with nearly equal and opposite pairs mixed in
+static void makeSlerpInputs(Quaternion *a, Quaternion *b, float *t, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const float f = (float)i;
+        Quaternion p(sinf(f * 1.7f), cosf(f * 2.3f), sinf(f * 0.9f + 1.0f), cosf(f * 3.1f));
+        Quaternion q(cosf(f * 0.7f), sinf(f * 1.3f), cosf(f * 2.9f + 2.0f), sinf(f * 0.4f));
+        a[i] = p / sqrtf(dot(p, p));
+        b[i] = q / sqrtf(dot(q, q));
+
+        if (i % 5 == 1)
+            b[i] = a[i];
+        else if (i % 5 == 2)
+            b[i] = -a[i];
+
+        t[i] = (float)(i % 11) / 10.0f;
+    }
+}
+
+static void testQuaternionSlerpMany()
+{
+    const size_t count = 203;
+    Quaternion a[count], b[count], out[count];
+    float t[count];
+    makeSlerpInputs(a, b, t, count);
+
+    slerpMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Quaternion expected = slerp(a[i], b[i], t[i]);
+        assertEquals(1.0f, dot(out[i], out[i]));
+        assertEquals(1.0f, mutil::abs(dot(out[i], expected)) / length(expected));
+    }
+
+    nlerpMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Quaternion q = lerp(a[i], b[i], t[i]);
+        if (dot(q, q) < 0.01f)
+            continue; // opposite pairs meet at 0 halfway
+        const Quaternion expected = q / sqrtf(dot(q, q));
+        assertEquals(expected.a, out[i].a);
+        assertEquals(expected.i, out[i].i);
+        assertEquals(expected.j, out[i].j);
+        assertEquals(expected.k, out[i].k);
+    }
+
+    slerpFastMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Quaternion expected = slerpFast(a[i], b[i], t[i]);
+        assertEquals(expected.a, out[i].a);
+        assertEquals(expected.i, out[i].i);
+        assertEquals(expected.j, out[i].j);
+        assertEquals(expected.k, out[i].k);
+        const Quaternion exact = slerp(a[i], b[i], t[i]);
+        assertEquals(1.0f, mutil::abs(dot(out[i], exact)) / length(exact));
+    }
+
+    // In place
+    Quaternion c[count];
+    for (size_t i = 0; i < count; i++)
+        c[i] = a[i];
+    slerpMany(c, b, t, c, count);
+    slerpMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        assertEquals(out[i].a, c[i].a);
+        assertEquals(out[i].k, c[i].k);
+    }
+}
+
+static void testQuaternionStream()
+{
+    const size_t count = 77;
+    Quaternion a[count], b[count], out[count], back[count];
+    float t[count];
+    makeSlerpInputs(a, b, t, count);
+
+    QuaternionStream sa, sb, sout;
+    gather(a, count, sa);
+    gather(b, count, sb);
+    assertTrue(sa.size() == count);
+    assertEquals(a[5].a, sa.w[5]);
+    assertEquals(a[5].k, sa.z[5]);
+
+    scatter(sa, back);
+    for (size_t i = 0; i < count; i++)
+    {
+        assertEquals(a[i].a, back[i].a);
+        assertEquals(a[i].k, back[i].k);
+    }
+
+    slerp(sa, sb, t, sout);
+    slerpMany(a, b, t, out, count);
+    assertTrue(sout.size() == count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Quaternion q = sout.get(i);
+        assertEquals(out[i].a, q.a);
+        assertEquals(out[i].i, q.i);
+        assertEquals(out[i].j, q.j);
+        assertEquals(out[i].k, q.k);
+    }
+
+    nlerp(sa, sb, t, sout);
+    nlerpMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i % 5 != 2) // opposite pairs meet at 0 halfway
+            assertEquals(out[i].j, sout.get(i).j);
+    }
+
+    slerpFast(sa, sb, t, sout);
+    slerpFastMany(a, b, t, out, count);
+    for (size_t i = 0; i < count; i++)
+        assertEquals(out[i].i, sout.get(i).i);
+
+    sout.set(3, Quaternion(1, 2, 3, 4));
+    assertEquals(3.0f, sout.y[3]);
+}
+
 Test getQuaternionTest(const std::string &test)
 {
     if (test == "QuaternionBasic") return testQuaternionBasic;
@@ -185,6 +388,11 @@ Test getQuaternionTest(const std::string &test)
     if (test == "QuaternionNormalize") return testQuaternionNormalize;
     if (test == "QuaternionConjugate") return testQuaternionConjugate;
     if (test == "QuaternionRotateAxis") return testQuaternionRotateAxis;
+    if (test == "QuaternionRotateVector") return testQuaternionRotateVector;
+    if (test == "QuaternionRotateVectors") return testQuaternionRotateVectors;
+    if (test == "QuaternionSlerp") return testQuaternionSlerp;
+    if (test == "QuaternionSlerpMany") return testQuaternionSlerpMany;
+    if (test == "QuaternionStream") return testQuaternionStream;
 
 	return nullptr;
 }
@@ -0,0 +1,191 @@
+#include <mutil/mutil.h>
+#include <string>
+#include <cmath>
+#include <vector>
+#include "test.h"
+
+using namespace mutil;
+
+// not a multiple of any register width, so every kernel also runs its tail
+static constexpr size_t kCount = 10007;
+
+static std::vector<float> sampleRange(float lo, float hi)
+{
+    std::vector<float> x(kCount);
+    for (size_t i = 0; i < kCount; i++)
+        x[i] = lo + (hi - lo) * (float)i / (float)(kCount - 1);
+    return x;
+}
+
+template <typename F, typename R>
+static void checkUnary(float lo, float hi, double maxUlps, F f, R reference)
+{
+    const std::vector<float> x = sampleRange(lo, hi);
+    std::vector<float> r(kCount);
+
+    f(x.data(), r.data(), kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertTrue(ulps(r[i], reference((double)x[i])) <= maxUlps);
+}
+
+static void testSimdMathSin()
+{
+    checkUnary(-8192.0f, 8192.0f, 2.0, [](const float *x, float *r, size_t n) { sin(x, r, n); }, [](double x) { return std::sin(x); });
+
+    const Vector4 v = sin(Vector4(0.0f, MUTIL_PI2, MUTIL_PI, -MUTIL_PI2));
+    assertEquals(Vector4(0.0f, 1.0f, 0.0f, -1.0f), v);
+}
+
+static void testSimdMathCos()
+{
+    checkUnary(-8192.0f, 8192.0f, 2.0, [](const float *x, float *r, size_t n) { cos(x, r, n); }, [](double x) { return std::cos(x); });
+
+    const Vector4 v = cos(Vector4(0.0f, MUTIL_PI2, MUTIL_PI, -MUTIL_PI2));
+    assertEquals(Vector4(1.0f, 0.0f, -1.0f, 0.0f), v);
+}
+
+static void testSimdMathSinCos()
+{
+    const std::vector<float> x = sampleRange(-100.0f, 100.0f);
+    std::vector<float> s(kCount), c(kCount), rs(kCount), rc(kCount);
+
+    sincos(x.data(), s.data(), c.data(), kCount);
+    sin(x.data(), rs.data(), kCount);
+    cos(x.data(), rc.data(), kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        assertEquals(rs[i], s[i]);
+        assertEquals(rc[i], c[i]);
+    }
+
+    Vector3Stream a(kCount), sa, ca;
+    for (size_t i = 0; i < kCount; i++)
+        a.set(i, Vector3(x[i], x[i] * 0.5f, -x[i]));
+
+    sincos(a, sa, ca);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        assertEquals(Vector3(std::sin(x[i]), std::sin(x[i] * 0.5f), std::sin(-x[i])), sa.get(i));
+        assertEquals(Vector3(std::cos(x[i]), std::cos(x[i] * 0.5f), std::cos(-x[i])), ca.get(i));
+    }
+}
+
+static void testSimdMathTan()
+{
+    checkUnary(-8192.0f, 8192.0f, 3.0, [](const float *x, float *r, size_t n) { tan(x, r, n); }, [](double x) { return std::tan(x); });
+}
+
+static void testSimdMathExp()
+{
+    checkUnary(-103.0f, 88.0f, 1.5, [](const float *x, float *r, size_t n) { exp(x, r, n); }, [](double x) { return std::exp(x); });
+
+    const Vector4 v = exp(Vector4(0.0f, 1.0f, 100.0f, -200.0f));
+    assertEquals(1.0f, v.x);
+    assertEquals(MUTIL_E, v.y);
+    assertTrue(std::isinf(v.z));
+    assertEquals(0.0f, v.w);
+
+    const Vector4 n = exp(Vector4(NAN, 0.0f, NAN, 1.0f));
+    assertTrue(std::isnan(n.x) && std::isnan(n.z));
+    assertEquals(1.0f, n.y);
+}
+
+static void testSimdMathExp2()
+{
+    checkUnary(-149.0f, 127.0f, 1.5, [](const float *x, float *r, size_t n) { exp2(x, r, n); }, [](double x) { return std::exp2(x); });
+
+    assertEquals(Vector4(1.0f, 2.0f, 0.5f, 1024.0f), exp2(Vector4(0.0f, 1.0f, -1.0f, 10.0f)));
+
+    // NaN is passed through rather than taken as an overflow, also in the tail
+    float x[5] = { NAN, 128.0f, -200.0f, 3.0f, NAN }, r[5];
+    exp2(x, r, 5);
+    assertTrue(std::isnan(r[0]) && std::isnan(r[4]));
+    assertTrue(std::isinf(r[1]));
+    assertEquals(0.0f, r[2]);
+    assertEquals(8.0f, r[3]);
+}
+
+static void testSimdMathLog()
+{
+    checkUnary(1e-6f, 10.0f, 1.0, [](const float *x, float *r, size_t n) { log(x, r, n); }, [](double x) { return std::log(x); });
+    checkUnary(1e-3f, 1e30f, 1.0, [](const float *x, float *r, size_t n) { log(x, r, n); }, [](double x) { return std::log(x); });
+
+    // subnormal
+    float x = 1e-40f, r;
+    log(&x, &r, 1);
+    assertTrue(ulps(r, std::log((double)x)) <= 1.0);
+
+    const Vector4 v = log(Vector4(1.0f, 0.0f, -1.0f, MUTIL_INFINITY));
+    assertEquals(0.0f, v.x);
+    assertTrue(std::isinf(v.y) && v.y < 0.0f);
+    assertTrue(std::isnan(v.z));
+    assertTrue(std::isinf(v.w) && v.w > 0.0f);
+}
+
+static void testSimdMathLog2()
+{
+    checkUnary(1e-6f, 10.0f, 1.5, [](const float *x, float *r, size_t n) { log2(x, r, n); }, [](double x) { return std::log2(x); });
+    checkUnary(1e-3f, 1e30f, 1.5, [](const float *x, float *r, size_t n) { log2(x, r, n); }, [](double x) { return std::log2(x); });
+
+    assertEquals(Vector4(0.0f, 1.0f, -1.0f, 10.0f), log2(Vector4(1.0f, 2.0f, 0.5f, 1024.0f)));
+}
+
+static void testSimdMathAtan()
+{
+    checkUnary(-10.0f, 10.0f, 3.0, [](const float *x, float *r, size_t n) { atan(x, r, n); }, [](double x) { return std::atan(x); });
+    checkUnary(-1e6f, 1e6f, 3.0, [](const float *x, float *r, size_t n) { atan(x, r, n); }, [](double x) { return std::atan(x); });
+}
+
+static void testSimdMathAtan2()
+{
+    const std::vector<float> y = sampleRange(-10.0f, 10.0f);
+    std::vector<float> x(kCount), r(kCount);
+    for (size_t i = 0; i < kCount; i++)
+        x[i] = y[(i * 7919) % kCount];
+
+    atan2(y.data(), x.data(), r.data(), kCount);
+    for (size_t i = 0; i < kCount; i++)
+        assertTrue(ulps(r[i], std::atan2((double)y[i], (double)x[i])) <= 3.5);
+
+    assertEquals(Vector4(MUTIL_PI4, 3.0f * MUTIL_PI4, -MUTIL_PI2, 0.0f),
+        atan2(Vector4(1.0f, 1.0f, -2.0f, 0.0f), Vector4(1.0f, -1.0f, 0.0f, 0.0f)));
+}
+
+static void testSimdMathPow()
+{
+    const std::vector<float> a = sampleRange(0.01f, 20.0f);
+    std::vector<float> b(kCount), r(kCount);
+    for (size_t i = 0; i < kCount; i++)
+        b[i] = -10.0f + 20.0f * (float)((i * 7919) % kCount) / (float)kCount;
+
+    pow(a.data(), b.data(), r.data(), kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const double t = fabs(b[i] * std::log2((double)a[i]));
+        assertTrue(ulps(r[i], std::pow((double)a[i], (double)b[i])) <= 2.0 + 1.3 * t);
+    }
+
+    assertEquals(Vector4(1.0f, 8.0f, 0.0f, 0.25f), pow(Vector4(5.0f, 2.0f, 0.0f, 16.0f), Vector4(0.0f, 3.0f, 2.0f, -0.5f)));
+
+    const Vector4 n = pow(Vector4(NAN, 2.0f, NAN, 4.0f), Vector4(2.0f, NAN, 0.0f, 0.5f));
+    assertTrue(std::isnan(n.x) && std::isnan(n.y));
+    assertEquals(1.0f, n.z);
+    assertEquals(2.0f, n.w);
+}
+
+Test getSimdMathTest(const std::string &test)
+{
+    if (test == "SimdMathSin") return &testSimdMathSin;
+    if (test == "SimdMathCos") return &testSimdMathCos;
+    if (test == "SimdMathSinCos") return &testSimdMathSinCos;
+    if (test == "SimdMathTan") return &testSimdMathTan;
+    if (test == "SimdMathExp") return &testSimdMathExp;
+    if (test == "SimdMathExp2") return &testSimdMathExp2;
+    if (test == "SimdMathLog") return &testSimdMathLog;
+    if (test == "SimdMathLog2") return &testSimdMathLog2;
+    if (test == "SimdMathAtan") return &testSimdMathAtan;
+    if (test == "SimdMathAtan2") return &testSimdMathAtan2;
+    if (test == "SimdMathPow") return &testSimdMathPow;
+
+    return nullptr;
+}
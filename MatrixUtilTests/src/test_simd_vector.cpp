@@ -0,0 +1,133 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+static constexpr size_t kCount = 37;
+
+static void testSIMDVector4Basic()
+{
+    const SIMDVector4 v(1.0f, 2.0f, 3.0f, 4.0f);
+    assertEquals(1.0f, v.x());
+    assertEquals(2.0f, v.y());
+    assertEquals(3.0f, v.z());
+    assertEquals(4.0f, v.w());
+
+    assertEquals(Vector4(), SIMDVector4().tovector4());
+    assertEquals(Vector4(5.0f), SIMDVector4(5.0f).tovector4());
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 4.0f), v.tovector4());
+    assertEquals(Vector3(1.0f, 2.0f, 3.0f), v.tovector3());
+    assertEquals(Vector3(1.0f, 2.0f, 3.0f), Vector3(v.tovector3a()));
+
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 0.0f), SIMDVector4(Vector3(1.0f, 2.0f, 3.0f)).tovector4());
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 7.0f), SIMDVector4(Vector3(1.0f, 2.0f, 3.0f), 7.0f).tovector4());
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 0.0f), SIMDVector4(Vector3A(1.0f, 2.0f, 3.0f)).tovector4());
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 4.0f), SIMDVector4(Vector4(1.0f, 2.0f, 3.0f, 4.0f)).tovector4());
+
+    alignas(16) float buffer[5] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f };
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 4.0f), SIMDVector4::load(buffer + 1).tovector4());
+    assertEquals(Vector4(0.0f, 1.0f, 2.0f, 3.0f), SIMDVector4::loadAligned(buffer).tovector4());
+
+    SIMDVector4(9.0f).store(buffer + 1);
+    assertEquals(0.0f, buffer[0]);
+    assertEquals(9.0f, buffer[4]);
+    v.storeAligned(buffer);
+    assertEquals(4.0f, buffer[3]);
+    assertEquals(9.0f, buffer[4]);
+}
+
+static void testSIMDVector4Arithmetic()
+{
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector4 a = sampleVector4(i);
+        const Vector4 b = sampleVector4(i * 3 + 1);
+        const Vector4 c(2.0f, -4.0f, 0.5f, 8.0f);
+        const SIMDVector4 sa(a), sb(b), sc(c);
+
+        assertEquals(a + b, (sa + sb).tovector4());
+        assertEquals(a - b, (sa - sb).tovector4());
+        assertEquals(a * b, (sa * sb).tovector4());
+        assertEquals(a / c, (sa / sc).tovector4());
+        assertEquals(a * 2.5f, (sa * 2.5f).tovector4());
+        assertEquals(a * 2.5f, (2.5f * sa).tovector4());
+        assertEquals(a / 2.0f, (sa / 2.0f).tovector4());
+        assertEquals(-a, (-sa).tovector4());
+        assertEquals(a * b + c, fmadd(sa, sb, sc).tovector4());
+        assertEquals(lerp(a, b, 0.25f), lerp(sa, sb, 0.25f).tovector4());
+
+        SIMDVector4 d = sa;
+        d += sb;
+        d *= 2.0f;
+        d -= sb;
+        d /= sc;
+        assertEquals(((a + b) * 2.0f - b) / c, d.tovector4());
+    }
+}
+
+static void testSIMDVector4Geometry()
+{
+    for (size_t i = 0; i < kCount; i++)
+    {
+        const Vector4 a = sampleVector4(i);
+        const Vector4 b = sampleVector4(i * 3 + 1);
+        const SIMDVector4 sa(a), sb(b);
+
+        assertEquals(Vector4(dot(a, b)), dot(sa, sb).tovector4());
+        assertEquals(Vector4(dot(Vector3(a), Vector3(b))), dot3(sa, sb).tovector4());
+        assertEquals(length(a), length(sa).x());
+        assertEquals(length(Vector3(a)), length3(sa).x());
+        assertEquals(a / length(a), normalize(sa).tovector4());
+        assertEquals(Vector3(a) / length(Vector3(a)), normalize3(sa).tovector3());
+        assertEquals(Vector4(cross(Vector3(a), Vector3(b)), 0.0f), cross(sa, sb).tovector4());
+    }
+
+    // w is exactly 0 whatever the inputs, also when a * b - c is fused
+    volatile float w0 = 0.1f, w1 = 1.3f;
+    const SIMDVector4 cw = cross(SIMDVector4(1.0f, 2.0f, 3.0f, w0), SIMDVector4(4.0f, 5.0f, 6.0f, w1));
+    assertTrue(cw.w() == 0.0f);
+
+    // the chain the type is meant for
+    const Vector4 a(1.0f, 2.0f, -1.0f, 0.5f), b(0.5f, -1.0f, 2.0f, 1.0f), c(3.0f, 0.0f, 1.0f, -2.0f);
+    const Vector4 expected = (a * b + c) / length(a * b + c);
+    assertEquals(expected, normalize(SIMDVector4(a) * SIMDVector4(b) + SIMDVector4(c)).tovector4());
+}
+
+static void testSIMDVector4Select()
+{
+    const SIMDVector4 a(1.0f, -2.0f, 3.0f, -4.0f);
+    const SIMDVector4 b(2.0f, -2.0f, -3.0f, 0.0f);
+
+    assertEquals(Vector4(1.0f, -2.0f, -3.0f, -4.0f), min(a, b).tovector4());
+    assertEquals(Vector4(2.0f, -2.0f, 3.0f, 0.0f), max(a, b).tovector4());
+    assertEquals(Vector4(1.0f, 2.0f, 3.0f, 4.0f), abs(a).tovector4());
+    assertEquals(Vector4(2.0f, 3.0f, 4.0f, 5.0f), sqrt(SIMDVector4(4.0f, 9.0f, 16.0f, 25.0f)).tovector4());
+    assertEquals(Vector4(0.5f, 0.25f, 0.2f, 0.1f), rsqrt(SIMDVector4(4.0f, 16.0f, 25.0f, 100.0f)).tovector4());
+
+    assertEquals(Vector4(1.0f, -2.0f, -3.0f, -4.0f), select(lessThan(a, b), a, b).tovector4());
+    assertEquals(Vector4(1.0f, 0.0f, 0.0f, 1.0f), select(lessThan(a, b), SIMDVector4(1.0f), SIMDVector4()).tovector4());
+    assertEquals(Vector4(1.0f, 1.0f, 0.0f, 1.0f), select(lessThanEqual(a, b), SIMDVector4(1.0f), SIMDVector4()).tovector4());
+    assertEquals(Vector4(0.0f, 0.0f, 1.0f, 0.0f), select(greaterThan(a, b), SIMDVector4(1.0f), SIMDVector4()).tovector4());
+    assertEquals(Vector4(0.0f, 1.0f, 1.0f, 0.0f), select(greaterThanEqual(a, b), SIMDVector4(1.0f), SIMDVector4()).tovector4());
+    assertEquals(Vector4(0.0f, 1.0f, 0.0f, 0.0f), select(equal(a, b), SIMDVector4(1.0f), SIMDVector4()).tovector4());
+
+    assertTrue(any(equal(a, b)));
+    assertFalse(all(equal(a, b)));
+    assertTrue(all(equal(a, a)));
+    assertFalse(any(lessThan(a, a)));
+
+    assertEquals(Vector4(-4.0f, 3.0f, -2.0f, 1.0f), (swizzle<3, 2, 1, 0>(a)).tovector4());
+    assertEquals(Vector4(-2.0f, -2.0f, -2.0f, -2.0f), (swizzle<1, 1, 1, 1>(a)).tovector4());
+    assertEquals(Vector4(1.0f, 3.0f, -2.0f, 0.0f), (shuffle<0, 2, 1, 3>(a, b)).tovector4());
+}
+
+Test getSIMDVectorTest(const std::string &test)
+{
+    if (test == "SIMDVector4Basic") return &testSIMDVector4Basic;
+    if (test == "SIMDVector4Arithmetic") return &testSIMDVector4Arithmetic;
+    if (test == "SIMDVector4Geometry") return &testSIMDVector4Geometry;
+    if (test == "SIMDVector4Select") return &testSIMDVector4Select;
+
+    return nullptr;
+}
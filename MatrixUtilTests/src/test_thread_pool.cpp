@@ -0,0 +1,54 @@
+#include <mutil/parallel/thread_pool.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "test.h"
+
+using namespace mutil;
+
+static void testThreadPoolParallelFor()
+{
+	const size_t counts[] = { 0, 1, 3, 1000 };
+
+	for (size_t threads = 1; threads <= 4; threads++)
+	{
+		ThreadPool pool(threads);
+		assertEquals((unsigned int)threads, (unsigned int)pool.threadCount());
+
+		for (size_t count : counts)
+		{
+			// repeat so that a later parallelFor can overlap workers still leaving the last
+			for (int repeat = 0; repeat < 20; repeat++)
+			{
+				std::vector<std::atomic<int>> calls(count);
+				for (auto &c : calls)
+					c = 0;
+
+				pool.parallelFor(count, [&](size_t i) { calls[i]++; });
+
+				for (size_t i = 0; i < count; i++)
+					assertEquals(1, calls[i].load());
+			}
+		}
+	}
+}
+
+static void testThreadPoolNested()
+{
+	ThreadPool pool(3);
+	std::atomic<int> total(0);
+
+	pool.parallelFor(8, [&](size_t) {
+		pool.parallelFor(8, [&](size_t) { total++; });
+	});
+
+	assertEquals(64, total.load());
+}
+
+Test getThreadPoolTest(const std::string &test)
+{
+	if (test == "ThreadPoolParallelFor") return &testThreadPoolParallelFor;
+	if (test == "ThreadPoolNested") return &testThreadPoolNested;
+
+	return nullptr;
+}
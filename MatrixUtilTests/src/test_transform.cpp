@@ -0,0 +1,128 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+static Quaternion sampleRotation(float angle, const Vector3 &axis)
+{
+    return rotateaxis(axis / length(axis), radians(angle));
+}
+
+static void assertVectorEquals(const Vector3 &expected, const Vector3 &actual)
+{
+    assertEquals(expected.x, actual.x);
+    assertEquals(expected.y, actual.y);
+    assertEquals(expected.z, actual.z);
+}
+
+static void testTransformBasic()
+{
+    Transform t;
+    assertVectorEquals(Vector3(1, 2, 3), transformpoint(t, Vector3(1, 2, 3)));
+
+    // scaled, then rotated to (0, 2, 0), then translated
+    t = Transform(Vector3(5, -1, 2), sampleRotation(90.0f, Vector3(0, 0, 1)), 2.0f);
+    assertVectorEquals(Vector3(5, 1, 2), transformpoint(t, Vector3(1, 0, 0)));
+    assertVectorEquals(Vector3(0, 2, 0), transformvector(t, Vector3(1, 0, 0)));
+
+    t = Transform(Vector3(1, 0, 0), Quaternion(), Vector3(1, 2, 3));
+    assertVectorEquals(Vector3(2, 2, 3), transformpoint(t, Vector3(1, 1, 1)));
+}
+
+static void testTransformMul()
+{
+    const Transform a(Vector3(1, 0, -3), sampleRotation(40.0f, Vector3(1, 2, 0)), 1.5f);
+    const Transform b(Vector3(0.5f, 2, 1), sampleRotation(-75.0f, Vector3(0, 1, 1)), Vector3(0.5f, 2.0f, 1.25f));
+    const Vector3 p(0.3f, -1.2f, 2.0f);
+
+    assertVectorEquals(transformpoint(a, transformpoint(b, p)), transformpoint(a * b, p));
+    assertVectorEquals(transformvector(a, transformvector(b, p)), transformvector(a * b, p));
+
+    Transform c = a;
+    c *= b;
+    assertVectorEquals((a * b).translation, c.translation);
+    assertVectorEquals((a * b).scale, c.scale);
+}
+
+static void testTransformInverse()
+{
+    const Transform a(Vector3(4, 5, 6), sampleRotation(120.0f, Vector3(-1, 1, 3)), 2.5f);
+    const Vector3 p(1.5f, 0.25f, -4.0f);
+
+    assertVectorEquals(p, transformpoint(inverse(a), transformpoint(a, p)));
+    assertVectorEquals(p, transformpoint(a, transformpoint(inverse(a), p)));
+
+    const Transform identity = a * inverse(a);
+    assertVectorEquals(Vector3(0, 0, 0), identity.translation);
+    assertVectorEquals(Vector3(1, 1, 1), identity.scale);
+    assertEquals(1.0f, mutil::abs(identity.rotation.w));
+
+    // exact for any scale
+    const Transform b(Vector3(4, 5, 6), sampleRotation(120.0f, Vector3(-1, 1, 3)), Vector3(0.5f, 2.0f, 3.0f));
+    assertVectorEquals(p, inverseTransformPoint(b, transformpoint(b, p)));
+}
+
+static void testTransformMatrix()
+{
+    const Transform a(Vector3(-2, 3, 0.5f), sampleRotation(65.0f, Vector3(2, -1, 1)), Vector3(0.5f, 2.0f, 1.25f));
+    const Vector3 p(1.5f, 0.25f, -4.0f);
+
+    const Matrix4 m = a.tomatrix();
+    const Vector4 expected = m * Vector4(p, 1.0f);
+    assertVectorEquals(Vector3(expected.x, expected.y, expected.z), transformpoint(a, p));
+    assertEquals(1.0f, expected.w);
+
+    // the same as building the matrix with translate, rotate and scale
+    const Matrix4 composed = translate(Matrix4(), a.translation) * torotation(a.rotation) * scale(Matrix4(), a.scale);
+    for (size_t i = 0; i < 16; i++)
+        assertEquals(composed[i], m[i]);
+}
+
+static void testTransformHierarchy()
+{
+    // two chains and a root without children, parents before children
+    const size_t count = 7;
+    const int32_t parents[count] = { -1, 0, 1, -1, 3, 1, -1 };
+
+    Transform local[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        const float f = (float)i;
+        local[i] = Transform(Vector3(f, 1.0f - f, 0.5f * f), sampleRotation(20.0f + 15.0f * f, Vector3(1, f, 2)), 1.0f + 0.1f * f);
+    }
+
+    Transform world[count];
+    Matrix4 matrices[count];
+    updateHierarchy(local, parents, world, count, matrices);
+
+    const Vector3 p(0.5f, -1.0f, 2.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        // walk up to the root
+        Vector3 expected = p;
+        for (int32_t node = (int32_t)i; node >= 0; node = parents[node])
+            expected = transformpoint(local[node], expected);
+
+        assertVectorEquals(expected, transformpoint(world[i], p));
+
+        const Vector4 m = matrices[i] * Vector4(p, 1.0f);
+        assertVectorEquals(expected, Vector3(m.x, m.y, m.z));
+    }
+
+    // in place, without matrices
+    updateHierarchy(local, parents, local, count);
+    for (size_t i = 0; i < count; i++)
+        assertVectorEquals(world[i].translation, local[i].translation);
+}
+
+Test getTransformTest(const std::string &test)
+{
+    if (test == "TransformBasic") return testTransformBasic;
+    if (test == "TransformMul") return testTransformMul;
+    if (test == "TransformInverse") return testTransformInverse;
+    if (test == "TransformMatrix") return testTransformMatrix;
+    if (test == "TransformHierarchy") return testTransformHierarchy;
+
+    return nullptr;
+}
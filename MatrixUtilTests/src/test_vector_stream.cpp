@@ -0,0 +1,226 @@
+#include <mutil/mutil.h>
+#include <string>
+#include "test.h"
+
+using namespace mutil;
+
+// not a multiple of any register width, so every kernel also runs its tail
+static constexpr size_t kCount = 19;
+
+static Vector3 sample3(size_t i)
+{
+    return Vector3((float)i + 1.0f, 2.0f - (float)i * 0.5f, (float)(i % 5) - 2.5f);
+}
+
+static Vector4 sample4(size_t i)
+{
+    return Vector4(sample3(i), (float)i * 0.25f - 1.0f);
+}
+
+static void testVectorStreamBasic()
+{
+    Vector3Stream s;
+    assertEquals(0u, (unsigned int)s.size());
+    assertTrue(s.empty());
+
+    s.resize(kCount);
+    assertEquals((unsigned int)kCount, (unsigned int)s.size());
+    assertTrue(s.capacity() >= kCount);
+    assertEquals(0u, (unsigned int)((uintptr_t)s.x % MUTIL_STREAM_ALIGNMENT));
+    assertEquals(0u, (unsigned int)((uintptr_t)s.y % MUTIL_STREAM_ALIGNMENT));
+    assertEquals(0u, (unsigned int)((uintptr_t)s.z % MUTIL_STREAM_ALIGNMENT));
+
+    for (size_t i = 0; i < kCount; i++)
+        s.set(i, sample3(i));
+
+    s.reserve(100);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(sample3(i), s.get(i));
+
+    Vector3Stream c(s);
+    assertEquals((unsigned int)kCount, (unsigned int)c.size());
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(sample3(i), c.get(i));
+
+    Vector3Stream m(static_cast<Vector3Stream &&>(c));
+    assertEquals(0u, (unsigned int)c.size());
+    assertEquals(sample3(7), m.get(7));
+}
+
+// Growing and copying a stream that has never held any elements
+static void testVectorStreamEmpty()
+{
+    Vector4Stream s;
+    s.resize(0);
+    assertTrue(s.empty());
+
+    const Vector4Stream c(s);
+    assertTrue(c.empty());
+
+    s.resize(kCount);
+    assertEquals((unsigned int)kCount, (unsigned int)s.size());
+    for (size_t i = 0; i < kCount; i++)
+        s.set(i, sample4(i));
+    assertEquals(sample4(kCount - 1), s.get(kCount - 1));
+
+    Vector3Stream r;
+    r.reserve(kCount);
+    assertTrue(r.empty());
+    assertTrue(r.capacity() >= kCount);
+}
+
+static void testVectorStreamGatherScatter()
+{
+    Vector3 in3[kCount], out3[kCount];
+    Vector4 in4[kCount], out4[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        in3[i] = sample3(i);
+        in4[i] = sample4(i);
+    }
+
+    Vector3Stream s3;
+    gather(in3, kCount, s3);
+    assertEquals((unsigned int)kCount, (unsigned int)s3.size());
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(in3[i], s3.get(i));
+
+    scatter(s3, out3);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(in3[i], out3[i]);
+
+    Vector4Stream s4;
+    gather(in4, kCount, s4);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(in4[i], s4.get(i));
+
+    scatter(s4, out4);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(in4[i], out4[i]);
+}
+
+static void testVectorStreamDot()
+{
+    Vector3Stream a(kCount), b(kCount);
+    Vector4Stream c(kCount), d(kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a.set(i, sample3(i));
+        b.set(i, sample3(kCount - i));
+        c.set(i, sample4(i));
+        d.set(i, sample4(kCount - i));
+    }
+
+    float r[kCount];
+    dot(a, b, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(dot(sample3(i), sample3(kCount - i)), r[i]);
+
+    dot(c, d, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(dot(sample4(i), sample4(kCount - i)), r[i]);
+}
+
+static void testVectorStreamCross()
+{
+    Vector3Stream a(kCount), b(kCount), r;
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a.set(i, sample3(i));
+        b.set(i, sample3(kCount - i));
+    }
+
+    cross(a, b, r);
+    assertEquals((unsigned int)kCount, (unsigned int)r.size());
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(cross(sample3(i), sample3(kCount - i)), r.get(i));
+}
+
+static void testVectorStreamLength()
+{
+    Vector3Stream a(kCount);
+    Vector4Stream b(kCount);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a.set(i, sample3(i));
+        b.set(i, sample4(i));
+    }
+
+    float r[kCount];
+    length(a, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(length(sample3(i)), r[i]);
+
+    length(b, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(length(sample4(i)), r[i]);
+}
+
+static void testVectorStreamNormalize()
+{
+    Vector3Stream a(kCount);
+    for (size_t i = 0; i < kCount; i++)
+        a.set(i, sample3(i));
+
+    normalize(a, a);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Vector3 v = sample3(i);
+        assertEquals(v / sqrtf(dot(v, v)), a.get(i));
+    }
+}
+
+static void testVectorStreamLerp()
+{
+    Vector4Stream a(kCount), b(kCount), r;
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a.set(i, sample4(i));
+        b.set(i, sample4(kCount - i));
+    }
+
+    lerp(a, b, 0.25f, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(lerp(sample4(i), sample4(kCount - i), 0.25f), r.get(i));
+}
+
+static void testVectorStreamClamp()
+{
+    Vector3Stream a(kCount), r;
+    for (size_t i = 0; i < kCount; i++)
+        a.set(i, sample3(i));
+
+    clamp(a, -1.0f, 2.0f, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(clamp(sample3(i), -1.0f, 2.0f), r.get(i));
+}
+
+static void testVectorStreamReflect()
+{
+    Vector3Stream a(kCount), n(kCount), r;
+    for (size_t i = 0; i < kCount; i++)
+    {
+        a.set(i, sample3(i));
+        n.set(i, normalize(sample3(kCount - i)));
+    }
+
+    reflect(a, n, r);
+    for (size_t i = 0; i < kCount; i++)
+        assertEquals(reflect(a.get(i), n.get(i)), r.get(i));
+}
+
+Test getVectorStreamTest(const std::string &test)
+{
+    if (test == "VectorStreamBasic") return &testVectorStreamBasic;
+    if (test == "VectorStreamEmpty") return &testVectorStreamEmpty;
+    if (test == "VectorStreamGatherScatter") return &testVectorStreamGatherScatter;
+    if (test == "VectorStreamDot") return &testVectorStreamDot;
+    if (test == "VectorStreamCross") return &testVectorStreamCross;
+    if (test == "VectorStreamLength") return &testVectorStreamLength;
+    if (test == "VectorStreamNormalize") return &testVectorStreamNormalize;
+    if (test == "VectorStreamLerp") return &testVectorStreamLerp;
+    if (test == "VectorStreamClamp") return &testVectorStreamClamp;
+    if (test == "VectorStreamReflect") return &testVectorStreamReflect;
+
+    return nullptr;
+}